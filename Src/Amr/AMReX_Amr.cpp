@@ -325,6 +325,8 @@ Amr::InitAmr ()
     dt_level.resize(nlev);
     level_steps.resize(nlev);
     level_count.resize(nlev);
+    level_costs.resize(nlev);
+    level_cost_steps.resize(nlev, 0);
     n_cycle.resize(nlev);
     dt_min.resize(nlev);
     amr_level.resize(nlev);
@@ -490,6 +492,21 @@ Amr::InitAmr ()
 
     loadbalance_max_fac = 1.5;
     pp.query("loadbalance_max_fac", loadbalance_max_fac);
+
+    loadbalance_with_costs = 0;
+    pp.query("loadbalance_with_costs", loadbalance_with_costs);
+
+    loadbalance_int = -1;
+    pp.query("loadbalance_int", loadbalance_int);
+
+    loadbalance_strategy = "knapsack";
+    pp.query("loadbalance_strategy", loadbalance_strategy);
+    if (loadbalance_strategy != "knapsack" && loadbalance_strategy != "sfc") {
+        amrex::Error("Amr: amr.loadbalance_strategy must be knapsack or sfc");
+    }
+
+    loadbalance_efficiency_threshold = 1.1;
+    pp.query("loadbalance_efficiency_threshold", loadbalance_efficiency_threshold);
 }
 
 int
@@ -1876,23 +1893,8 @@ Amr::RegridOnly (Real time, bool do_io)
 }
 
 void
-Amr::timeStep (int  level,
-               Real time,
-               int  iteration,
-               int  niter,
-               Real stop_time)
+Amr::regridBeforeAdvance (int level, Real time, Real stop_time)
 {
-    BL_PROFILE("Amr::timeStep()");
-    BL_COMM_PROFILE_NAMETAG("Amr::timeStep TOP");
-
-    // This is used so that the AmrLevel functions can know which level is being advanced 
-    //      when regridding is called with possible lbase > level.
-    which_level_being_advanced = level;
-
-
-    // Update so that by default, we don't force a post-step regrid.
-    amr_level[level]->setPostStepRegrid(0);
-
     //
     // Allow regridding of level 0 calculation on restart.
     //
@@ -1956,6 +1958,77 @@ Amr::timeStep (int  level,
             }
         }
     }
+
+    if (level == 0 && loadbalance_with_costs && loadbalance_int > 0
+        && level_steps[0] > 0 && level_steps[0] % loadbalance_int == 0)
+    {
+        LoadBalanceWithCosts();
+    }
+}
+
+Real
+Amr::advanceLevel (int level, Real time, int iteration, int niter)
+{
+    if (!loadbalance_with_costs) {
+        return amr_level[level]->advance(time,dt_level[level],iteration,niter);
+    }
+
+    //
+    // The costs are measured again whenever the grids or their
+    // distribution change.
+    //
+    const BoxArray& ba = amr_level[level]->boxArray();
+    const DistributionMapping& dm = amr_level[level]->DistributionMap();
+    std::unique_ptr<LayoutData<Real> >& costs = level_costs[level];
+    if (costs == nullptr || !(costs->boxArray() == ba) || costs->DistributionMap() != dm)
+    {
+        costs.reset(new LayoutData<Real>(ba, dm));
+        for (MFIter mfi(*costs); mfi.isValid(); ++mfi) {
+            (*costs)[mfi] = 0.0;
+        }
+        level_cost_steps[level] = 0;
+    }
+    else if (costs->DistributionMap().getRefID() != dm.getRefID())
+    {
+        //
+        // The MFIters are matched to the costs by the DistributionMapping
+        // object, so the costs move to the level's new copy of the same one.
+        //
+        std::unique_ptr<LayoutData<Real> > moved(new LayoutData<Real>(ba, dm));
+        for (MFIter mfi(*moved); mfi.isValid(); ++mfi) {
+            (*moved)[mfi] = (*costs)[mfi.index()];
+        }
+        costs = std::move(moved);
+    }
+
+    MFIter::startCostTimer(*costs);
+    Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
+    MFIter::stopCostTimer();
+    ++level_cost_steps[level];
+
+    return dt_new;
+}
+
+void
+Amr::timeStep (int  level,
+               Real time,
+               int  iteration,
+               int  niter,
+               Real stop_time)
+{
+    BL_PROFILE("Amr::timeStep()");
+    BL_COMM_PROFILE_NAMETAG("Amr::timeStep TOP");
+
+    // This is used so that the AmrLevel functions can know which level is being advanced 
+    //      when regridding is called with possible lbase > level.
+    which_level_being_advanced = level;
+
+
+    // Update so that by default, we don't force a post-step regrid.
+    amr_level[level]->setPostStepRegrid(0);
+
+    regridBeforeAdvance(level, time, stop_time);
+
     //
     // Check to see if should write plotfile.
     // This routine is here so it is done after the restart regrid.
@@ -1974,7 +2047,7 @@ Amr::timeStep (int  level,
 		       << "ADVANCE with dt = " << dt_level[level] << "\n";
     }
 
-    Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
+    Real dt_new = advanceLevel(level,time,iteration,niter);
     BL_PROFILE_REGION_STOP("amr_level.advance");
 
     dt_min[level] = iteration == 1 ? dt_new : std::min(dt_min[level],dt_new);
@@ -2008,6 +2081,16 @@ Amr::timeStep (int  level,
 	}
     }
 
+    //
+    // The fluxes of this level are final after its last subcycle.  Let
+    // the coarser level start its reflux so that the communication
+    // overlaps with the advance of the finer levels.
+    //
+    if (level > 0 && iteration == niter)
+    {
+        amr_level[level-1]->reflux_nowait();
+    }
+
     //
     // Advance grids at higher level.
     //
@@ -2036,6 +2119,90 @@ Amr::timeStep (int  level,
     which_level_being_advanced = -1;
 }
 
+void
+Amr::timeStepFused (Real time,
+                    Real stop_time)
+{
+    BL_PROFILE("Amr::timeStepFused()");
+
+    which_level_being_advanced = 0;
+
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        amr_level[lev]->setPostStepRegrid(0);
+    }
+
+    // Without subcycling, the regrid checks of level 0 cover all the levels.
+    regridBeforeAdvance(0, time, stop_time);
+
+    if (plotfile_on_restart && ! (restart_chkfile.empty()) )
+    {
+	plotfile_on_restart = 0;
+	writePlotFile();
+    }
+
+    //
+    // All the levels are at the same time.  Let them fill their ghost
+    // cells before any of them is advanced.
+    //
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        amr_level[lev]->pre_advance_fused(time, dt_level[lev]);
+    }
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        which_level_being_advanced = lev;
+
+        if (verbose > 0)
+        {
+            amrex::Print() << "[Level " << lev << " step " << level_steps[lev]+1 << "] "
+                           << "ADVANCE with dt = " << dt_level[lev] << "\n";
+        }
+
+        dt_min[lev] = advanceLevel(lev,time,1,1);
+
+        level_steps[lev]++;
+        level_count[lev]++;
+
+        if (verbose > 0)
+        {
+            amrex::Print() << "[Level " << lev << " step " << level_steps[lev] << "] "
+                           << "Advanced " << amr_level[lev]->countCells() << " cells\n";
+        }
+
+        //
+        // The fluxes of this level are final.  Start the reflux of the
+        // coarser level so that it overlaps with the finer levels.
+        //
+        if (lev > 0) {
+            amr_level[lev-1]->reflux_nowait();
+        }
+
+        if (amr_level[lev]->postStepRegrid())
+        {
+            int old_finest = finest_level;
+
+            regrid(lev, time);
+
+            for (int k = old_finest + 1; k <= finest_level; ++k) {
+                dt_level[k] = dt_level[k-1] / n_cycle[k];
+            }
+
+            // The finer levels have been rebuilt.
+            for (int k = lev+1; k <= finest_level; ++k) {
+                amr_level[k]->pre_advance_fused(time, dt_level[k]);
+            }
+        }
+    }
+
+    for (int lev = finest_level; lev >= 0; --lev)
+    {
+        which_level_being_advanced = lev;
+        amr_level[lev]->post_timestep(1);
+    }
+
+    which_level_being_advanced = -1;
+}
+
 Real
 Amr::coarseTimeStepDt (Real stop_time)
 {
@@ -2081,7 +2248,11 @@ Amr::coarseTimeStep (Real stop_time)
     }
 
     BL_PROFILE_REGION_START(stepName.str());
-    timeStep(0,cumtime,1,1,stop_time);
+    if (subcycling_mode == "Fused") {
+        timeStepFused(cumtime,stop_time);
+    } else {
+        timeStep(0,cumtime,1,1,stop_time);
+    }
     BL_PROFILE_REGION_STOP(stepName.str());
 
     cumtime += dt_level[0];
@@ -2480,6 +2651,9 @@ Amr::defBaseLevel (Real              strt_time,
 	if (refine_grid_layout) {
 	    ChopGrids(0,lev0,ParallelDescriptor::NProcs());
 	}
+	if (sfc_order_grids) {
+	    lev0.orderSFC();
+	}
     }
     else
     {
@@ -2487,7 +2661,7 @@ Amr::defBaseLevel (Real              strt_time,
     }
 
     this->SetBoxArray(0, lev0);
-    this->SetDistributionMap(0, DistributionMapping(lev0));
+    this->SetDistributionMap(0, MakeDistributionMap(0, lev0));
 
     //
     // Now build level 0 grids.
@@ -2525,6 +2699,17 @@ Amr::regrid (int  lbase,
 
     const int start = regrid_level_zero ? 0 : lbase+1;
 
+    //
+    // Keep the old grids lying in the new region, with their owners and data.
+    //
+    const bool incremental = incremental_regrid && !initial && !loadbalance_with_workestimates
+        && !loadbalance_with_costs;
+    if (incremental) {
+        for (int lev = std::max(start,1), End = std::min(finest_level,new_finest); lev <= End; lev++) {
+            new_grid_places[lev] = ReuseGrids(lev, new_grid_places[lev]);
+        }
+    }
+
     bool grids_unchanged = finest_level == new_finest;
     for (int lev = start, End = std::min(finest_level,new_finest); lev <= End; lev++) {
 	if (new_grid_places[lev] == amr_level[lev]->boxArray()) {
@@ -2561,6 +2746,7 @@ Amr::regrid (int  lbase,
     //
     for(int lev = new_finest + 1; lev <= finest_level; ++lev) {
 	amr_level[lev].reset();
+	level_costs[lev].reset();
 	this->ClearBoxArray(lev);
 	this->ClearDistributionMap(lev);
     }
@@ -2578,8 +2764,15 @@ Amr::regrid (int  lbase,
         if (loadbalance_with_workestimates && !initial) {
             new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
         }
+        else if (loadbalance_with_costs && !initial && new_dmap[lev].empty()) {
+            new_dmap[lev] = makeCostDistributionMap(lev, new_grid_places[lev]);
+        }
         else if (new_dmap[lev].empty()) {
-	    new_dmap[lev].define(new_grid_places[lev]);
+            if (incremental && amr_level[lev]) {
+                new_dmap[lev] = ReuseDistributionMap(lev, new_grid_places[lev]);
+            } else {
+                new_dmap[lev] = MakeDistributionMap(lev, new_grid_places[lev]);
+            }
 	}
 
         AmrLevel* a = (*levelbld)(*this,lev,Geom(lev),new_grid_places[lev],
@@ -2604,6 +2797,9 @@ Amr::regrid (int  lbase,
             // NOTE: The init function may use a filPatch from the old level,
             //       which therefore needs remain in the hierarchy during the call.
             //
+            if (incremental) {
+                amr_level[lev]->setReplacement(*a);
+            }
             a->init(*amr_level[lev]);
             amr_level[lev].reset(a);
 	    this->SetBoxArray(lev, amr_level[lev]->boxArray());
@@ -2676,7 +2872,7 @@ Amr::regrid (int  lbase,
 }
 
 DistributionMapping
-Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) const
+Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba)
 {
     BL_PROFILE("makeLoadBalanceDistributionMap()");
 
@@ -2692,7 +2888,7 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
         if (verbose) {
             amrex::Print() << "\nAMREX WARNING: work estimates type does not exist!\n\n";
         }
-        newdm.define(ba);
+        newdm = MakeDistributionMap(lev, ba);
     }
     else if (amr_level[lev])
     {
@@ -2713,7 +2909,7 @@ Amr::makeLoadBalanceDistributionMap (int lev, Real time, const BoxArray& ba) con
     }
     else
     {
-        newdm.define(ba);
+        newdm = MakeDistributionMap(lev, ba);
     }
 
     return newdm;
@@ -2728,6 +2924,187 @@ Amr::LoadBalanceLevel0 (Real time)
     amr_level[0]->post_regrid(0,0);
 }
 
+Vector<Real>
+Amr::measuredCosts (int lev) const
+{
+    Vector<Real> cost;
+    if (lev > finest_level || level_costs[lev] == nullptr || level_cost_steps[lev] == 0) {
+        return cost;
+    }
+
+    const LayoutData<Real>& costs = *level_costs[lev];
+    cost.resize(costs.size(), 0.0);
+    for (MFIter mfi(costs); mfi.isValid(); ++mfi) {
+        cost[mfi.index()] = costs[mfi] / level_cost_steps[lev];
+    }
+    ParallelDescriptor::ReduceRealSum(cost.dataPtr(), cost.size());
+
+    return cost;
+}
+
+Vector<Real>
+Amr::estimateCosts (int lev, const BoxArray& ba) const
+{
+    BL_PROFILE("Amr::estimateCosts()");
+
+    //
+    // The cost per cell per step of each box where it was measured, on this
+    // level and on the next coarser one.  A cell of a fine level is taken
+    // to cost as much per step of its level as a cell of a coarse level per
+    // step of that level, so the costs of the two levels, which take
+    // different numbers of steps, can be used together.
+    //
+    Vector<Real> density[2];
+    Real mean[2] = {0.0, 0.0};
+    const BoxArray* measured_ba[2] = {nullptr, nullptr};
+    for (int i = 0; i < 2; ++i)
+    {
+        const int l = lev - i;
+        if (l < 0) break;
+        density[i] = measuredCosts(l);
+        if (density[i].empty()) continue;
+
+        measured_ba[i] = &level_costs[l]->boxArray();
+        Real total_cost = 0.0;
+        Real total_pts = 0.0;
+        for (int n = 0, N = density[i].size(); n < N; ++n) {
+            const Real npts = static_cast<Real>((*measured_ba[i])[n].numPts());
+            total_cost += density[i][n];
+            total_pts += npts;
+            density[i][n] /= npts;
+        }
+        mean[i] = total_cost / total_pts;
+        if (total_cost <= 0.0) measured_ba[i] = nullptr;
+    }
+
+    const int N = ba.size();
+    Vector<Real> cost(N, 0.0);
+    std::vector<std::pair<int,Box> > isects;
+    for (int n = 0; n < N; ++n)
+    {
+        const Box& bx = ba[n];
+        Long covered = 0;
+        if (measured_ba[0])
+        {
+            measured_ba[0]->intersections(bx, isects);
+            for (const auto& is : isects) {
+                cost[n] += density[0][is.first] * is.second.numPts();
+                covered += is.second.numPts();
+            }
+        }
+
+        const Long uncovered = bx.numPts() - covered;
+        if (uncovered > 0)
+        {
+            Real d = measured_ba[0] ? mean[0] : 1.0;
+            if (measured_ba[1])
+            {
+                // The mean density of the coarse cells under the box
+                measured_ba[1]->intersections(amrex::coarsen(bx, ref_ratio[lev-1]), isects);
+                Real c = 0.0;
+                Long npts = 0;
+                for (const auto& is : isects) {
+                    c += density[1][is.first] * is.second.numPts();
+                    npts += is.second.numPts();
+                }
+                d = (npts > 0) ? c / npts : mean[1];
+            }
+            cost[n] += d * uncovered;
+        }
+    }
+
+    return cost;
+}
+
+DistributionMapping
+Amr::balanceCosts (const Vector<Real>& cost, const BoxArray& ba, Real& eff) const
+{
+    if (loadbalance_strategy == "sfc") {
+        return DistributionMapping::makeSFC(cost, ba, eff);
+    } else {
+        Real navg = static_cast<Real>(ba.size()) / static_cast<Real>(ParallelDescriptor::NProcs());
+        int nmax = static_cast<int>(std::max(std::round(loadbalance_max_fac*navg), std::ceil(navg)));
+        return DistributionMapping::makeKnapSack(cost, eff, nmax);
+    }
+}
+
+DistributionMapping
+Amr::makeCostDistributionMap (int lev, const BoxArray& ba) const
+{
+    BL_PROFILE("Amr::makeCostDistributionMap()");
+
+    const Vector<Real> cost = estimateCosts(lev, ba);
+
+    Real eff;
+    DistributionMapping newdm = balanceCosts(cost, ba, eff);
+
+    if (verbose) {
+        amrex::Print() << "Load balance on level " << lev << " by estimated costs: efficiency "
+                       << eff << "\n";
+    }
+
+    return newdm;
+}
+
+void
+Amr::LoadBalanceWithCosts ()
+{
+    BL_PROFILE("Amr::LoadBalanceWithCosts()");
+
+    int lbase = finest_level+1;
+    Vector<DistributionMapping> new_dmap(finest_level+1);
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        const Vector<Real> cost = measuredCosts(lev);
+        if (cost.empty() || !(level_costs[lev]->boxArray() == boxArray(lev))
+            || level_costs[lev]->DistributionMap() != DistributionMap(lev))
+        {
+            continue;
+        }
+
+        const BoxArray& ba = boxArray(lev);
+        Real current_eff, proposed_eff;
+        DistributionMapping::ComputeDistributionMappingEfficiency(DistributionMap(lev), cost,
+                                                                  &current_eff);
+        DistributionMapping newdm = balanceCosts(cost, ba, proposed_eff);
+
+        //
+        // Only redistribute if it is worth the cost of moving the data.
+        //
+        const bool redistribute = proposed_eff > loadbalance_efficiency_threshold * current_eff;
+
+        if (verbose) {
+            amrex::Print() << "Load balance on level " << lev << " by measured costs: efficiency "
+                           << current_eff << " -> " << proposed_eff
+                           << (redistribute ? "" : ", not redistributed") << "\n";
+        }
+
+        if (redistribute) {
+            new_dmap[lev] = newdm;
+            lbase = std::min(lbase, lev);
+        }
+
+        // Measure again from now on.
+        level_costs[lev].reset();
+    }
+
+    if (lbase > finest_level) return;
+
+    //
+    // Build the finer levels again too, like regrid does, since their data
+    // such as flux registers may depend on the distribution of the coarser
+    // level.
+    //
+    for (int lev = lbase; lev <= finest_level; ++lev) {
+        InstallNewDistributionMap(lev, new_dmap[lev].empty() ? DistributionMap(lev)
+                                                             : new_dmap[lev]);
+    }
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        amr_level[lev]->post_regrid(lbase, finest_level);
+    }
+}
+
 void
 Amr::InstallNewDistributionMap (int lev, const DistributionMapping& newdm)
 {
@@ -2768,7 +3145,7 @@ Amr::regrid_level_0_on_restart()
 	//
 	// Construct skeleton of new level.
 	//
-	DistributionMapping dm(lev0);
+	DistributionMapping dm = MakeDistributionMap(0, lev0);
 	AmrLevel* a = (*levelbld)(*this,0,Geom(0),lev0,dm,cumtime);
 	
 	a->init(*amr_level[0]);
@@ -2980,7 +3357,7 @@ Amr::bldFineLevels (Real strt_time)
         //
         finest_level = new_finest;
 
-	DistributionMapping new_dm {new_grids[new_finest]};
+	DistributionMapping new_dm = MakeDistributionMap(new_finest, new_grids[new_finest]);
 
         AmrLevel* level = (*levelbld)(*this,
                                       new_finest,
@@ -3056,7 +3433,7 @@ Amr::initSubcycle ()
         pp.query("subcycling_mode",subcycling_mode);
     }
     
-    if (subcycling_mode == "None")
+    if (subcycling_mode == "None" || subcycling_mode == "Fused")
     {
         sub_cycle = false;
         for (int i = 0; i <= max_level; i++)
@@ -3201,6 +3578,8 @@ Amr::initPltAndChk ()
     write_plotfile_with_checkpoint = 1;
     pp.query("write_plotfile_with_checkpoint",write_plotfile_with_checkpoint);
 
+    pp.query("batched_derive",batched_derive);
+
     stream_max_tries = 4;
     pp.query("stream_max_tries",stream_max_tries);
     stream_max_tries = std::max(stream_max_tries, 1);
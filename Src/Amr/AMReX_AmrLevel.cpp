@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <sstream>
 
 #include <memory>
@@ -164,7 +165,7 @@ AmrLevel::writePlotFile (const std::string& dir,
 	}
     }
 
-    std::vector<std::string> derive_names;
+    Vector<std::string> derive_names;
     const std::list<DeriveRec>& dlist = derive_lst.dlist();
     for (std::list<DeriveRec>::const_iterator it = dlist.begin();
 	 it != dlist.end();
@@ -335,11 +336,19 @@ AmrLevel::writePlotFile (const std::string& dir,
     // derived
     if (derive_names.size() > 0)
     {
-	for (auto const& dname : derive_names)
-	{
-            derive(dname, cur_time, plotMF, cnt);
-	    cnt++;
-	}
+        if (parent->batchedDerive())
+        {
+            derive(derive_names, cur_time, plotMF, cnt);
+            cnt += derive_names.size();
+        }
+        else
+        {
+	    for (auto const& dname : derive_names)
+	    {
+                derive(dname, cur_time, plotMF, cnt);
+	        cnt++;
+	    }
+        }
     }
 
 #ifdef AMREX_USE_EB
@@ -422,7 +431,7 @@ AmrLevel::restart (Amr&          papa,
 	BL_ASSERT(nstate == ndesc);
     }
 
-    dmap.define(grids);
+    dmap = parent->MakeDistributionMap(level, grids);
 
     parent->SetBoxArray(level, grids);
     parent->SetDistributionMap(level, dmap);
@@ -985,6 +994,9 @@ FillPatchIterator::Initialize (int  boxGrow,
     BL_ASSERT(ncomp >= 1);
     BL_ASSERT(0 <= idx && idx < AmrLevel::desc_lst.size());
 
+    // The data may have been moved into the level replacing this one.
+    m_amrlevel.restoreMovedData(idx);
+
     const StateDescriptor& desc = AmrLevel::desc_lst[idx];
 
     m_ncomp = ncomp;
@@ -1133,7 +1145,9 @@ FillPatchIterator::FillFromTwoLevels (Real time, int idx, int scomp, int dcomp,
 
     const StateDescriptor& desc = AmrLevel::desc_lst[idx];
 
-    amrex::FillPatchTwoLevels(m_fabs, time, 
+    FillPatchPlan<MultiFab>& plan = fine_level.m_fillpatch_plans[{{idx,scomp,m_fabs.nGrow()}}];
+
+    amrex::FillPatchTwoLevels(m_fabs, time, plan,
                               smf_crse, stime_crse, 
                               smf_fine, stime_fine,
                               scomp, dcomp, ncomp, 
@@ -1663,7 +1677,7 @@ AmrLevel::derive (const std::string& name, Real time, int ngrow)
         const int dncomp = rec->numDerive();
         mf.reset(new MultiFab(dstBA, dmap, dncomp, ngrow, MFInfo(), *m_factory));
 
-        if (rec->derFuncFab() != nullptr)
+        if (rec->derFuncFabLambda())
         {
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -1673,7 +1687,7 @@ AmrLevel::derive (const std::string& name, Real time, int ngrow)
                 const Box& bx = mfi.growntilebox(ngrow);
                 FArrayBox& derfab = (*mf)[mfi];
                 FArrayBox const& datafab = srcMF[mfi];
-                rec->derFuncFab()(bx, derfab, 0, dncomp, datafab, geom, time, rec->getBC(), level);
+                rec->derFuncFabLambda()(bx, derfab, 0, dncomp, datafab, geom, time, rec->getBC(), level);
             }
         }
         else
@@ -1814,7 +1828,7 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
             FillPatch(*this,srcMF,ngrow_src,time,index,scomp,ncomp,dc);
         }
 
-        if (rec->derFuncFab() != nullptr)
+        if (rec->derFuncFabLambda())
         {
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
@@ -1825,7 +1839,7 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
                 FArrayBox& derfab = mf[mfi];
                 FArrayBox const& datafab = srcMF[mfi];
                 const int dncomp = rec->numDerive();
-                rec->derFuncFab()(bx, derfab, dcomp, dncomp, datafab, geom, time, rec->getBC(), level);
+                rec->derFuncFabLambda()(bx, derfab, dcomp, dncomp, datafab, geom, time, rec->getBC(), level);
             }
         }
         else
@@ -1928,6 +1942,157 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
     }
 }
 
+void
+AmrLevel::derive (const Vector<std::string>& names, Real time, MultiFab& mf, int dcomp)
+{
+    BL_PROFILE("AmrLevel::derive(batch)");
+
+    const int ngrow = mf.nGrow();
+
+    //
+    // The derived quantities that share the grids and the ghost cells of
+    // their state data.  The distinct state ranges of all of them are
+    // filled into one MultiFab.
+    //
+    struct DeriveGroup
+    {
+        const BoxArray* srcBA;
+        int ngrow_src;
+        Vector<Array<int,3> > ranges;   // state index, scomp, ncomp
+        Vector<int> range_comp;         // where each range is in the MultiFab
+        int nsrc = 0;
+        Vector<const DeriveRec*> recs;
+        Vector<int> rec_dcomp;
+    };
+    Vector<DeriveGroup> groups;
+
+    int dc = dcomp;
+    for (const auto& name : names)
+    {
+        int index, scomp, ncomp;
+        const DeriveRec* rec = isStateVariable(name,index,scomp) ? nullptr : derive_lst.get(name);
+        if (rec == nullptr || !rec->derFuncFabLambda())
+        {
+            derive(name, time, mf, dc);
+            dc += (rec == nullptr) ? 1 : rec->numDerive();
+            continue;
+        }
+
+        rec->getRange(0,index,scomp,ncomp);
+        const BoxArray& srcBA = state[index].boxArray();
+
+        int ngrow_src = ngrow;
+        {
+            Box bx0 = srcBA[0];
+            Box bx1 = rec->boxMap()(bx0);
+            int g = bx0.smallEnd(0) - bx1.smallEnd(0);
+            ngrow_src += g;
+        }
+
+        DeriveGroup* grp = nullptr;
+        for (auto& g : groups) {
+            if (g.ngrow_src == ngrow_src && *g.srcBA == srcBA) {
+                grp = &g;
+                break;
+            }
+        }
+        if (grp == nullptr) {
+            groups.emplace_back();
+            grp = &groups.back();
+            grp->srcBA = &srcBA;
+            grp->ngrow_src = ngrow_src;
+        }
+
+        for (int k = 0; k < rec->numRange(); k++)
+        {
+            rec->getRange(k,index,scomp,ncomp);
+            const Array<int,3> r{index,scomp,ncomp};
+            if (std::find(grp->ranges.begin(), grp->ranges.end(), r) == grp->ranges.end()) {
+                grp->ranges.push_back(r);
+                grp->range_comp.push_back(grp->nsrc);
+                grp->nsrc += ncomp;
+            }
+        }
+        grp->recs.push_back(rec);
+        grp->rec_dcomp.push_back(dc);
+        dc += rec->numDerive();
+    }
+
+    BL_ASSERT(dc <= mf.nComp());
+
+    for (const auto& grp : groups)
+    {
+        const int nranges = grp.ranges.size();
+        MultiFab srcMF(*grp.srcBA, dmap, grp.nsrc, grp.ngrow_src, MFInfo(), *m_factory);
+        {
+            Vector<MultiFab*> leveldata(nranges, &srcMF);
+            Vector<int> index(nranges), scomp(nranges), ncomp(nranges);
+            for (int i = 0; i < nranges; ++i) {
+                index[i] = grp.ranges[i][0];
+                scomp[i] = grp.ranges[i][1];
+                ncomp[i] = grp.ranges[i][2];
+            }
+            FillPatch(*this, leveldata, grp.ngrow_src, time, index, scomp, ncomp, grp.range_comp);
+        }
+
+        //
+        // The state data of each derived quantity, with its ranges one
+        // after another.  That is an alias of srcMF if they already are,
+        // and a copy otherwise.
+        //
+        const int nrecs = grp.recs.size();
+        Vector<std::unique_ptr<MultiFab> > datamf(nrecs);
+        for (int n = 0; n < nrecs; ++n)
+        {
+            const DeriveRec* rec = grp.recs[n];
+            Vector<int> src_comp;
+            bool contiguous = true;
+            for (int k = 0, c = 0; k < rec->numRange(); k++)
+            {
+                int index, scomp, ncomp;
+                rec->getRange(k,index,scomp,ncomp);
+                const Array<int,3> r{index,scomp,ncomp};
+                const int i = std::find(grp.ranges.begin(), grp.ranges.end(), r) - grp.ranges.begin();
+                src_comp.push_back(grp.range_comp[i]);
+                contiguous = contiguous && (src_comp[k] == src_comp[0] + c);
+                c += ncomp;
+            }
+            if (contiguous)
+            {
+                datamf[n].reset(new MultiFab(srcMF, amrex::make_alias, src_comp[0], rec->numState()));
+            }
+            else
+            {
+                datamf[n].reset(new MultiFab(*grp.srcBA, dmap, rec->numState(), grp.ngrow_src,
+                                             MFInfo(), *m_factory));
+                for (int k = 0, c = 0; k < rec->numRange(); k++)
+                {
+                    int index, scomp, ncomp;
+                    rec->getRange(k,index,scomp,ncomp);
+                    MultiFab::Copy(*datamf[n], srcMF, src_comp[k], c, ncomp, grp.ngrow_src);
+                    c += ncomp;
+                }
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.growntilebox();
+            FArrayBox& derfab = mf[mfi];
+            for (int n = 0; n < nrecs; ++n)
+            {
+                const DeriveRec* rec = grp.recs[n];
+                FArrayBox const& datafab = (*datamf[n])[mfi];
+                rec->derFuncFabLambda()(bx, derfab, grp.rec_dcomp[n], rec->numDerive(), datafab,
+                                  geom, time, rec->getBC(), level);
+            }
+        }
+    }
+}
+
 //! Update the distribution maps in StateData based on the size of the map
 void
 AmrLevel::UpdateDistributionMaps ( DistributionMapping& update_dmap )
@@ -2206,11 +2371,276 @@ AmrLevel::FillPatch (AmrLevel& amrlevel,
 {
     BL_ASSERT(dcomp+ncomp-1 <= leveldata.nComp());
     BL_ASSERT(boxGrow <= leveldata.nGrow());
+    if (amrlevel.m_replacement != nullptr && boxGrow == 0 &&
+        amrlevel.FillPatchReused(leveldata, time, index, scomp, ncomp, dcomp))
+    {
+        return;
+    }
     FillPatchIterator fpi(amrlevel, leveldata, boxGrow, time, index, scomp, ncomp);
     const MultiFab& mf_fillpatched = fpi.get_mf();
     MultiFab::Copy(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+void
+AmrLevel::FillPatch (AmrLevel&                amrlevel,
+                     const Vector<MultiFab*>& leveldata,
+                     int                      boxGrow,
+                     Real                     time,
+                     const Vector<int>&       index,
+                     const Vector<int>&       scomp,
+                     const Vector<int>&       ncomp,
+                     const Vector<int>&       dcomp)
+{
+    BL_PROFILE("AmrLevel::FillPatch(batch)");
+
+    const int nstates = index.size();
+    BL_ASSERT(leveldata.size() == nstates && scomp.size() == nstates &&
+              ncomp.size() == nstates && dcomp.size() == nstates);
+
+    const int level = amrlevel.level;
+    const BoxArray& ba = leveldata[0]->boxArray();
+    const DistributionMapping& dm = leveldata[0]->DistributionMap();
+    const IndexType& boxType = ba.ixType();
+
+    bool batch = amrlevel.m_replacement == nullptr;
+    for (int i = 0; i < nstates && batch; ++i)
+    {
+        BL_ASSERT(dcomp[i]+ncomp[i]-1 <= leveldata[i]->nComp());
+        BL_ASSERT(boxGrow <= leveldata[i]->nGrow());
+
+        const StateDescriptor& desc = desc_lst[index[i]];
+        batch = leveldata[i]->boxArray() == ba && leveldata[i]->DistributionMap() == dm
+            && desc.getType() == boxType;
+        if (batch && level > 1)
+        {
+            for (const auto& r : desc.sameInterps(scomp[i],ncomp[i])) {
+                batch = batch && amrex::ProperlyNested(amrlevel.crse_ratio,
+                                                       amrlevel.parent->blockingFactor(level),
+                                                       boxGrow, boxType, desc.interp(r.first));
+            }
+        }
+    }
+
+    if (!batch)
+    {
+        for (int i = 0; i < nstates; ++i) {
+            FillPatch(amrlevel, *leveldata[i], boxGrow, time, index[i], scomp[i], ncomp[i], dcomp[i]);
+        }
+        return;
+    }
+
+    //
+    // One item for each range of components of the same interpolater.
+    //
+    Vector<MultiFab*> mf;
+    Vector<int> item_scomp, item_dcomp, item_ncomp;
+    Vector<Vector<MultiFab*> > smf_crse, smf_fine;
+    Vector<Vector<Real> > stime_crse, stime_fine;
+    Vector<std::unique_ptr<StateDataPhysBCFunct> > physbcf_crse, physbcf_fine;
+    Vector<Interpolater*> mapper;
+    Vector<Vector<BCRec> const*> bcs;
+
+    AmrLevel* crse_level = (level > 0) ? &amrlevel.parent->getLevel(level-1) : nullptr;
+
+    for (int i = 0; i < nstates; ++i)
+    {
+        const StateDescriptor& desc = desc_lst[index[i]];
+        for (const auto& r : desc.sameInterps(scomp[i],ncomp[i]))
+        {
+            const int SComp = r.first;
+            const int NComp = r.second;
+
+            mf.push_back(leveldata[i]);
+            item_scomp.push_back(SComp);
+            item_dcomp.push_back(dcomp[i]+SComp-scomp[i]);
+            item_ncomp.push_back(NComp);
+
+            StateData& statedata_fine = amrlevel.state[index[i]];
+            smf_fine.emplace_back();
+            stime_fine.emplace_back();
+            statedata_fine.getData(smf_fine.back(),stime_fine.back(),time);
+            physbcf_fine.emplace_back(new StateDataPhysBCFunct(statedata_fine,SComp,amrlevel.geom));
+
+            if (crse_level)
+            {
+                StateData& statedata_crse = crse_level->state[index[i]];
+                smf_crse.emplace_back();
+                stime_crse.emplace_back();
+                statedata_crse.getData(smf_crse.back(),stime_crse.back(),time);
+                physbcf_crse.emplace_back(new StateDataPhysBCFunct(statedata_crse,SComp,
+                                                                   crse_level->geom));
+            }
+
+            mapper.push_back(desc.interp(SComp));
+            bcs.push_back(&desc.getBCs());
+        }
+    }
+
+    Vector<StateDataPhysBCFunct*> cbc, fbc;
+    for (auto& f : physbcf_crse) cbc.push_back(f.get());
+    for (auto& f : physbcf_fine) fbc.push_back(f.get());
+
+    if (level == 0)
+    {
+        amrex::FillPatchSingleLevel(mf, IntVect(boxGrow), time, smf_fine, stime_fine,
+                                    item_scomp, item_dcomp, item_ncomp,
+                                    amrlevel.geom, fbc, item_scomp);
+    }
+    else
+    {
+        amrex::FillPatchTwoLevels(mf, IntVect(boxGrow), time,
+                                  smf_crse, stime_crse,
+                                  smf_fine, stime_fine,
+                                  item_scomp, item_dcomp, item_ncomp,
+                                  crse_level->geom, amrlevel.geom,
+                                  cbc, item_scomp,
+                                  fbc, item_scomp,
+                                  crse_level->fineRatio(),
+                                  mapper, bcs, item_scomp);
+    }
+
+    for (int i = 0; i < nstates; ++i) {
+        amrlevel.set_preferred_boundary_values(*leveldata[i], index[i], scomp[i], dcomp[i],
+                                               ncomp[i], time);
+    }
+}
+
+void
+AmrLevel::setReplacement (AmrLevel& new_level)
+{
+    m_replacement = &new_level;
+
+    const BoxArray& ba = new_level.boxArray();
+    const DistributionMapping& dm = new_level.DistributionMap();
+    m_reused_index.assign(ba.size(), -1);
+    std::vector< std::pair<int,Box> > isects;
+    for (int k = 0, N = ba.size(); k < N; ++k) {
+        grids.intersections(ba[k], isects, true, 0);
+        if (!isects.empty()) {
+            const int j = isects[0].first;
+            if (grids[j] == ba[k] && dmap[j] == dm[k]) {
+                m_reused_index[k] = j;
+            }
+        }
+    }
+
+    m_moved.assign(desc_lst.size(), 0);
+}
+
+bool
+AmrLevel::FillPatchReused (MultiFab& leveldata, Real time, int index,
+                           int scomp, int ncomp, int dcomp)
+{
+    AmrLevel& new_level = *m_replacement;
+
+    if (leveldata.boxArray() != new_level.boxArray() ||
+        leveldata.DistributionMap() != new_level.DistributionMap() ||
+        leveldata.hasEBFabFactory() ||
+        !state[index].isNewTime(time))
+    {
+        return false;
+    }
+
+    BL_PROFILE("AmrLevel::FillPatchReused()");
+
+    //
+    // The new grids are filled as usual.
+    //
+    Vector<int> new_index;
+    for (int k = 0, N = m_reused_index.size(); k < N; ++k) {
+        if (m_reused_index[k] < 0) new_index.push_back(k);
+    }
+    if (!new_index.empty())
+    {
+        BoxList bl(leveldata.boxArray().ixType());
+        Vector<int> pmap;
+        bl.reserve(new_index.size());
+        pmap.reserve(new_index.size());
+        for (int k : new_index) {
+            bl.push_back(leveldata.boxArray()[k]);
+            pmap.push_back(leveldata.DistributionMap()[k]);
+        }
+        MultiFab mf(BoxArray(std::move(bl)), DistributionMapping(std::move(pmap)), ncomp, 0);
+
+        FillPatchIterator fpi(*this, mf, 0, time, index, scomp, ncomp);
+        const MultiFab& mf_fillpatched = fpi.get_mf();
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf_fillpatched,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            auto const& src = mf_fillpatched.const_array(mfi);
+            auto const& dst = leveldata.array(new_index[mfi.index()]);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, j, k, n,
+            {
+                dst(i,j,k,dcomp+n) = src(i,j,k,n);
+            });
+        }
+    }
+
+    //
+    // The unchanged grids already have the data.  When all of them are
+    // wanted, the FABs are moved.
+    //
+    MultiFab& old_data = state[index].newData();
+    MultiFab& new_data = new_level.state[index].newData();
+    const bool move = !m_moved[index] && &leveldata == &new_data
+        && scomp == 0 && dcomp == 0 && ncomp == old_data.nComp()
+        && leveldata.nComp() == old_data.nComp()
+        && leveldata.nGrowVect() == old_data.nGrowVect();
+    const MultiFab& src_data = (m_moved[index]) ? new_data : old_data;
+
+    for (MFIter mfi(leveldata); mfi.isValid(); ++mfi)
+    {
+        const int k = mfi.index();
+        const int j = m_reused_index[k];
+        if (j < 0) {
+            continue;
+        } else if (move) {
+            leveldata.swapFab(k, old_data, j);
+        } else if (!(&src_data == &leveldata && scomp == dcomp)) {
+            const Box& bx = mfi.validbox();
+            auto const& src = src_data.const_array((m_moved[index]) ? k : j);
+            auto const& dst = leveldata.array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, ncomp, i, jj, kk, n,
+            {
+                dst(i,jj,kk,dcomp+n) = src(i,jj,kk,scomp+n);
+            });
+        }
+    }
+
+    if (move) {
+        m_moved[index] = 1;
+    }
+
+    return true;
+}
+
+void
+AmrLevel::restoreMovedData (int index)
+{
+    if (m_moved.empty() || !m_moved[index]) return;
+
+    MultiFab& old_data = state[index].newData();
+    const MultiFab& new_data = m_replacement->state[index].newData();
+    for (MFIter mfi(new_data); mfi.isValid(); ++mfi)
+    {
+        const int j = m_reused_index[mfi.index()];
+        if (j >= 0) {
+            const Box& bx = mfi.fabbox();
+            auto const& src = new_data.const_array(mfi);
+            auto const& dst = old_data.array(j);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D(bx, old_data.nComp(), i, jj, k, n,
+            {
+                dst(i,jj,k,n) = src(i,jj,k,n);
+            });
+        }
+    }
+
+    m_moved[index] = 0;
+}
+
 void
 AmrLevel::FillPatchAdd (AmrLevel& amrlevel,
                         MultiFab& leveldata,
@@ -65,6 +65,24 @@ DeriveRec::DeriveRec (const std::string& a_name,
     func_fab(der_func_fab),
     mapper(a_interp),
     bx_map(box_map)
+{
+    if (func_fab != nullptr) func_fab_lambda = func_fab;
+}
+
+DeriveRec::DeriveRec (const std::string&  a_name,
+                      IndexType           result_type,
+                      int                 nvar_derive,
+                      DeriveFuncFabLambda der_func_fab,
+                      DeriveBoxMap        box_map,
+                      Interpolater*       a_interp)
+    :
+    derive_name(a_name),
+    variable_names(),
+    der_type(result_type),
+    n_derive(nvar_derive),
+    func_fab_lambda(std::move(der_func_fab)),
+    mapper(a_interp),
+    bx_map(box_map)
 {}
 
 // This version doesn't take a Fortran function name, it is entirely defined by the C++
@@ -129,6 +147,25 @@ DeriveRec::DeriveRec (const std::string& a_name,
     func_fab(der_func_fab),
     mapper(a_interp),
     bx_map(box_map)
+{
+    if (func_fab != nullptr) func_fab_lambda = func_fab;
+}
+
+DeriveRec::DeriveRec (const std::string&  a_name,
+                      IndexType           result_type,
+                      int                 nvar_derive,
+		      Vector<std::string>& var_names,
+                      DeriveFuncFabLambda der_func_fab,
+                      DeriveBoxMap        box_map,
+                      Interpolater*       a_interp)
+    :
+    derive_name(a_name),
+    variable_names(var_names),
+    der_type(result_type),
+    n_derive(nvar_derive),
+    func_fab_lambda(std::move(der_func_fab)),
+    mapper(a_interp),
+    bx_map(box_map)
 {}
 
 DeriveRec::~DeriveRec () 
@@ -178,6 +215,12 @@ DeriveRec::derFuncFab () const noexcept
     return func_fab;
 }
 
+const DeriveFuncFabLambda&
+DeriveRec::derFuncFabLambda () const noexcept
+{
+    return func_fab_lambda;
+}
+
 DeriveRec::DeriveBoxMap
 DeriveRec::boxMap () const noexcept
 {
@@ -369,6 +412,17 @@ DeriveList::add (const std::string&      name,
     lst.push_back(DeriveRec(name,result_type,nvar_der,der_func_fab,bx_map,interp));
 }
 
+void
+DeriveList::add (const std::string&      name,
+                 IndexType               result_type,
+                 int                     nvar_der,
+                 DeriveFuncFabLambda     der_func_fab,
+                 DeriveRec::DeriveBoxMap bx_map,
+                 Interpolater*           interp)
+{
+    lst.push_back(DeriveRec(name,result_type,nvar_der,std::move(der_func_fab),bx_map,interp));
+}
+
 // This version doesn't take a Fortran function name, it is entirely defined by the C++
 void
 DeriveList::add (const std::string&      name,
@@ -415,6 +469,18 @@ DeriveList::add (const std::string&      name,
     lst.push_back(DeriveRec(name,res_typ,nvar_der,vars,der_func_fab,bx_map,interp));
 }
 
+void
+DeriveList::add (const std::string&      name,
+                 IndexType               res_typ,
+                 int                     nvar_der,
+                 Vector<std::string>&    vars,
+                 DeriveFuncFabLambda     der_func_fab,
+                 DeriveRec::DeriveBoxMap bx_map,
+                 Interpolater*           interp)
+{
+    lst.push_back(DeriveRec(name,res_typ,nvar_der,vars,std::move(der_func_fab),bx_map,interp));
+}
+
 std::list<DeriveRec>&
 DeriveList::dlist ()
 {
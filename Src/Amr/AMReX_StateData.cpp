@@ -572,6 +572,25 @@ StateData::FillBoundary (Box const&      bx,
     }
 }
 
+bool
+StateData::isNewTime (Real time) const noexcept
+{
+    const Real teps = (new_time.start - old_time.start)*1.e-3;
+    if (desc->timeType() == StateDescriptor::Point)
+    {
+        if (old_data == nullptr) {
+            return true;
+        } else {
+            return !(time >= old_time.start-teps && time <= old_time.start+teps)
+                && time > new_time.start-teps && time < new_time.start+teps;
+        }
+    }
+    else
+    {
+        return time > new_time.start-teps && time < new_time.stop+teps;
+    }
+}
+
 void
 StateData::RegisterData (MultiFabCopyDescriptor& multiFabCopyDesc,
                          Vector<MultiFabId>&      mfid)
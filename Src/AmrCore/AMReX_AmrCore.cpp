@@ -79,13 +79,17 @@ AmrCore::regrid (int lbase, Real time, bool)
     {
         if (lev <= finest_level) // an old level
         {
+            if (incremental_regrid) {
+                new_grids[lev] = ReuseGrids(lev, new_grids[lev]);
+            }
             bool ba_changed = (new_grids[lev] != grids[lev]);
 	    if (ba_changed or coarse_ba_changed) {
                 BoxArray level_grids = grids[lev];
                 DistributionMapping level_dmap = dmap[lev];
                 if (ba_changed) {
                     level_grids = new_grids[lev];
-                    level_dmap = DistributionMapping(level_grids);
+                    level_dmap = (incremental_regrid) ? ReuseDistributionMap(lev, level_grids)
+                                                      : MakeDistributionMap(lev, level_grids);
                 }
                 const auto old_num_setdm = num_setdm;
                 RemakeLevel(lev, time, level_grids, level_dmap);
@@ -98,7 +102,7 @@ AmrCore::regrid (int lbase, Real time, bool)
 	}
 	else  // a new level
 	{
-            DistributionMapping new_dmap(new_grids[lev]);
+            DistributionMapping new_dmap = MakeDistributionMap(lev, new_grids[lev]);
             const auto old_num_setdm = num_setdm;
             MakeNewLevelFromCoarse(lev, time, new_grids[lev], new_dmap);
             SetBoxArray(lev, new_grids[lev]);
@@ -117,6 +121,21 @@ AmrCore::regrid (int lbase, Real time, bool)
     finest_level = new_finest;
 }
 
+void
+AmrCore::LoadBalance (int lbase, Real time)
+{
+    for (int lev = lbase; lev <= finest_level; ++lev)
+    {
+        const DistributionMapping new_dmap = MakeDistributionMap(lev, grids[lev]);
+        if (new_dmap == dmap[lev]) continue;
+
+        const auto old_num_setdm = num_setdm;
+        RemakeLevel(lev, time, grids[lev], new_dmap);
+        if (old_num_setdm == num_setdm) {
+            SetDistributionMap(lev, new_dmap);
+        }
+    }
+}
 
 void
 AmrCore::printGridSummary (std::ostream& os, int min_lev, int max_lev) const noexcept
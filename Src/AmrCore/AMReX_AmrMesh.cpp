@@ -6,6 +6,9 @@
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Print.H>
 
+#include <queue>
+#include <functional>
+
 namespace amrex {
 
 AmrMesh::AmrMesh ()
@@ -354,6 +357,10 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 	pp.query("refine_grid_layout", refine_grid_layout);
     }
 
+    pp.query("distributed_clustering", use_distributed_clustering);
+    pp.query("incremental_regrid", incremental_regrid);
+    pp.query("sfc_order_grids", sfc_order_grids);
+
     pp.query("check_input", check_input);
 
     finest_level = -1;
@@ -456,6 +463,9 @@ AmrMesh::MakeBaseGrids () const
     if (refine_grid_layout) {
         ChopGrids(0, ba, ParallelDescriptor::NProcs());
     }
+    if (sfc_order_grids) {
+        ba.orderSFC();
+    }
     if (ba == grids[0]) {
         ba = grids[0];  // to avoid duplicates
     }
@@ -692,10 +702,19 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // Create initial cluster containing all tagged points.
         //
 	Vector<IntVect> tagvec;
-	tags.collate(tagvec);
+        bool has_tags;
+        if (use_distributed_clustering) {
+            tags.local_collate(tagvec);
+            Long numtags = tagvec.size();
+            ParallelDescriptor::ReduceLongSum(numtags);
+            has_tags = numtags > 0;
+        } else {
+            tags.collate(tagvec);
+            has_tags = tagvec.size() > 0;
+        }
         tags.clear();
 
-        if (tagvec.size() > 0)
+        if (has_tags)
         {
             //
             // Created new level, now generate efficient grids.
@@ -706,7 +725,14 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
             if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
-                if (ParallelDescriptor::IOProcessor()) {
+                if (use_distributed_clustering) {
+                    BL_PROFILE("AmrMesh-cluster");
+                    //
+                    // Cluster the local tags and merge the clusters of
+                    // all processes on the I/O process.
+                    //
+                    new_bx = distributedCluster(tagvec, grid_eff, p_n[levc], use_new_chop);
+                } else if (ParallelDescriptor::IOProcessor()) {
                     BL_PROFILE("AmrMesh-cluster");
                     //
                     // Construct initial cluster.
@@ -726,6 +752,8 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                     // now generate list of grids at level levf.
                     //
                     clist.boxList(new_bx);
+                }
+                if (ParallelDescriptor::IOProcessor()) {
                     new_bx.refine(bf_lev[levc]);
                     new_bx.simplify();
 
@@ -772,9 +800,14 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                 amrex::Abort("AmrMesh::MakeNewGrids: how did this happen?");
             }
         }
-        else if (refine_grid_layout)
+        else if (refine_grid_layout || sfc_order_grids)
         {
-            ChopGrids(lev,new_grids[lev],ParallelDescriptor::NProcs());
+            if (refine_grid_layout) {
+                ChopGrids(lev,new_grids[lev],ParallelDescriptor::NProcs());
+            }
+            if (sfc_order_grids) {
+                new_grids[lev].orderSFC();
+            }
             if (new_grids[lev] == grids[lev]) {
                 new_grids[lev] = grids[lev]; // to avoid dupliates
             }
@@ -790,7 +823,7 @@ AmrMesh::MakeNewGrids (Real time)
 	finest_level = 0;
 
 	const BoxArray& ba = MakeBaseGrids();
-	DistributionMapping dm(ba);
+	DistributionMapping dm = MakeDistributionMap(0, ba);
         const auto old_num_setdm = num_setdm;
         const auto old_num_setba = num_setba;
 
@@ -818,7 +851,7 @@ AmrMesh::MakeNewGrids (Real time)
 	    if (new_finest <= finest_level) break;
 	    finest_level = new_finest;
 
-	    DistributionMapping dm(new_grids[new_finest]);
+	    DistributionMapping dm = MakeDistributionMap(new_finest, new_grids[new_finest]);
             const auto old_num_setdm = num_setdm;
 
             MakeNewLevelFromScratch(new_finest, time, new_grids[finest_level], dm);
@@ -849,7 +882,7 @@ AmrMesh::MakeNewGrids (Real time)
 	        for (int lev = 1; lev <= new_finest; ++lev) {
 		    if (new_grids[lev] != grids[lev]) {
 		        grids_the_same = false;
-		        DistributionMapping dm(new_grids[lev]);
+		        DistributionMapping dm = MakeDistributionMap(lev, new_grids[lev]);
                         const auto old_num_setdm = num_setdm;
 
                         MakeNewLevelFromScratch(lev, time, new_grids[lev], dm);
@@ -866,6 +899,108 @@ AmrMesh::MakeNewGrids (Real time)
     }
 }
 
+DistributionMapping
+AmrMesh::MakeDistributionMap (int /*lev*/, BoxArray const& ba)
+{
+    return DistributionMapping(ba);
+}
+
+BoxArray
+AmrMesh::ReuseGrids (int lev, const BoxArray& new_grids) const
+{
+    BL_PROFILE("AmrMesh::ReuseGrids()");
+
+    const BoxArray& old_grids = grids[lev];
+    if (old_grids.empty() || new_grids.empty() || old_grids == new_grids) {
+        return new_grids;
+    }
+
+    BoxList kept(new_grids.ixType());
+    for (int i = 0, N = old_grids.size(); i < N; ++i) {
+        if (new_grids.contains(old_grids[i],true)) {
+            kept.push_back(old_grids[i]);
+        }
+    }
+    if (kept.isEmpty()) {
+        return new_grids;
+    }
+
+    //
+    // The rest of the new region.  The grids are aligned with the blocking
+    // factor, and so are the differences.
+    //
+    const BoxArray kept_ba(kept);
+    BoxList rest(new_grids.ixType());
+    BoxList pieces(new_grids.ixType());
+    for (int i = 0, N = new_grids.size(); i < N; ++i) {
+        pieces.complementIn(new_grids[i], kept_ba);
+        rest.join(pieces);
+    }
+    rest.simplify();
+
+    BoxList bl(std::move(kept));
+    bl.join(BoxList(BoxArray(std::move(rest), max_grid_size[lev])));
+    if (sfc_order_grids) {
+        bl.orderSFC();
+    }
+
+    BoxArray ba(std::move(bl));
+    if (ba == old_grids) {
+        ba = old_grids;  // to avoid duplicates
+    }
+    return ba;
+}
+
+DistributionMapping
+AmrMesh::ReuseDistributionMap (int lev, const BoxArray& ba)
+{
+    BL_PROFILE("AmrMesh::ReuseDistributionMap()");
+
+    const BoxArray& old_grids = grids[lev];
+    if (old_grids.empty()) {
+        return MakeDistributionMap(lev, ba);
+    } else if (ba == old_grids) {
+        return dmap[lev];
+    }
+
+    const DistributionMapping& old_dmap = dmap[lev];
+    const int N = ba.size();
+    Vector<int> pmap(N, -1);
+    Vector<Long> ncells(ParallelDescriptor::NProcs(), 0);
+    Vector<int> new_boxes;
+    std::vector< std::pair<int,Box> > isects;
+    for (int i = 0; i < N; ++i) {
+        old_grids.intersections(ba[i], isects, true, 0);
+        if (!isects.empty() && old_grids[isects[0].first] == ba[i]) {
+            pmap[i] = old_dmap[isects[0].first];
+            ncells[pmap[i]] += ba[i].numPts();
+        } else {
+            new_boxes.push_back(i);
+        }
+    }
+
+    //
+    // Largest first, to the process with the fewest cells.  The order is
+    // deterministic, so all the processes make the same map.
+    //
+    std::stable_sort(new_boxes.begin(), new_boxes.end(),
+                     [&ba] (int i, int j) { return ba[i].numPts() > ba[j].numPts(); });
+    using LoadPair = std::pair<Long,int>;
+    std::priority_queue<LoadPair, std::vector<LoadPair>, std::greater<LoadPair> > loads;
+    for (int p = 0, NP = ncells.size(); p < NP; ++p) {
+        loads.push(LoadPair(ncells[p], p));
+    }
+    for (int i : new_boxes) {
+        LoadPair lp = loads.top();
+        loads.pop();
+        pmap[i] = lp.second;
+        lp.first += ba[i].numPts();
+        loads.push(lp);
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
 void
 AmrMesh::ProjPeriodic (BoxList& blout, const Box& domain,
                        Array<int,AMREX_SPACEDIM> const& is_per)
@@ -1042,6 +1177,9 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
+    os << "  use_distributed_clustering = " << amr_mesh.use_distributed_clustering << "\n";
+    os << "  incremental_regrid = " << amr_mesh.incremental_regrid << "\n";
+    os << "  sfc_order_grids = " << amr_mesh.sfc_order_grids << "\n";
     return os;
 }
 
@@ -6,6 +6,7 @@
 #include <AMReX_Vector.H>
 #include <AMReX_Array.H>
 #include <AMReX_BLProfiler.H>
+#include <AMReX_ParallelDescriptor.H>
 
 namespace amrex {
 
@@ -524,6 +525,20 @@ ClusterList::boxList (BoxList& blst) const
     }
 }
 
+Vector<Long>
+ClusterList::numTags () const
+{
+    Vector<Long> r;
+    r.reserve(lst.size());
+    for (std::list<Cluster*>::const_iterator cli = lst.begin(), End = lst.end();
+         cli != End;
+         ++cli)
+    {
+        r.push_back((*cli)->numTag());
+    }
+    return r;
+}
+
 void
 ClusterList::chop (Real eff)
 {
@@ -602,4 +617,212 @@ ClusterList::intersect (const BoxDomain& dom)
     }
 }
 
+namespace {
+
+//
+// Merge the boxes of two processes.  ntags[i] is a lower bound of the
+// number of tagged points in boxes[i].  Touching boxes are joined into
+// their bounding box if the lower bound of its efficiency is no less than
+// eff, then the overlaps are removed from the later boxes.
+//
+void
+mergeClusterBoxes (Vector<Box>& boxes, Vector<Long>& ntags, Real eff, const BoxArray& domba)
+{
+    BL_PROFILE("mergeClusterBoxes()");
+
+    std::vector< std::pair<int,Box> > isects;
+
+    bool joined = true;
+    while (joined && boxes.size() > 1)
+    {
+        joined = false;
+
+        const int N = boxes.size();
+        BoxArray ba(boxes.data(), boxes.size());
+        Vector<int> done(N, 0);
+
+        for (int i = 0; i < N; ++i)
+        {
+            if (done[i]) continue;
+
+            int jbest = -1;
+            Box hullbest;
+            Real effbest = eff;
+            ba.intersections(amrex::grow(boxes[i],1), isects);
+            for (const auto& is : isects)
+            {
+                const int j = is.first;
+                if (j == i || done[j]) continue;
+                const Box hull = amrex::minBox(boxes[i], boxes[j]);
+                const Real hull_eff = static_cast<Real>(ntags[i]+ntags[j]) / hull.d_numPts();
+                if (hull_eff >= effbest && domba.contains(hull,true))
+                {
+                    bool cuts_others = false;
+                    std::vector< std::pair<int,Box> > hull_isects;
+                    ba.intersections(hull, hull_isects);
+                    for (const auto& his : hull_isects) {
+                        if (his.first != i && his.first != j) {
+                            cuts_others = true;
+                            break;
+                        }
+                    }
+                    if (!cuts_others) {
+                        jbest = j;
+                        hullbest = hull;
+                        effbest = hull_eff;
+                    }
+                }
+            }
+
+            if (jbest >= 0)
+            {
+                boxes[i] = hullbest;
+                ntags[i] += ntags[jbest];
+                ntags[jbest] = -1;
+                done[i] = done[jbest] = 1;
+                joined = true;
+            }
+        }
+
+        if (joined)
+        {
+            int n = 0;
+            for (int i = 0; i < N; ++i) {
+                if (ntags[i] >= 0) {
+                    boxes[n] = boxes[i];
+                    ntags[n] = ntags[i];
+                    ++n;
+                }
+            }
+            boxes.resize(n);
+            ntags.resize(n);
+        }
+    }
+
+    //
+    // Remove the overlaps.  The pieces of a box keep the tagged points
+    // that cannot be outside them.
+    //
+    const int N = boxes.size();
+    BoxArray ba(boxes.data(), boxes.size());
+    Vector<Box> new_boxes;
+    Vector<Long> new_ntags;
+    new_boxes.reserve(N);
+    new_ntags.reserve(N);
+    for (int i = 0; i < N; ++i)
+    {
+        BoxList bl_earlier;
+        ba.intersections(boxes[i], isects);
+        for (const auto& is : isects) {
+            if (is.first < i) bl_earlier.push_back(boxes[is.first]);
+        }
+        if (bl_earlier.isEmpty())
+        {
+            new_boxes.push_back(boxes[i]);
+            new_ntags.push_back(ntags[i]);
+        }
+        else
+        {
+            BoxList pieces;
+            pieces.complementIn(boxes[i], bl_earlier);
+            pieces.simplify();
+            const Long npts = boxes[i].numPts();
+            for (const Box& b : pieces) {
+                new_boxes.push_back(b);
+                new_ntags.push_back(std::max(Long(0), ntags[i] - (npts - b.numPts())));
+            }
+        }
+    }
+    std::swap(boxes, new_boxes);
+    std::swap(ntags, new_ntags);
+}
+
+}
+
+BoxList
+distributedCluster (Vector<IntVect>& pts, Real eff, const BoxList& dom, bool use_new_chop)
+{
+    BL_PROFILE("distributedCluster()");
+
+    Vector<Box> boxes;
+    Vector<Long> ntags;
+    if (!pts.empty())
+    {
+        ClusterList clist(pts.data(), pts.size());
+        if (use_new_chop) {
+            clist.new_chop(eff);
+        } else {
+            clist.chop(eff);
+        }
+        BoxDomain bd;
+        bd.add(dom);
+        clist.intersect(bd);
+        BoxList bl;
+        clist.boxList(bl);
+        boxes = std::move(bl.data());
+        ntags = clist.numTags();
+    }
+
+#ifdef BL_USE_MPI
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const int rank = (ParallelDescriptor::MyProc() - ioproc + nprocs) % nprocs;
+    const int seqno = ParallelDescriptor::SeqNum();
+    const BoxArray domba(dom);
+    constexpr int nvals = 2*AMREX_SPACEDIM+1;
+
+    for (int stride = 1; stride < nprocs; stride *= 2)
+    {
+        if (rank % (2*stride) == stride)
+        {
+            const int dst = (rank - stride + ioproc) % nprocs;
+            Vector<Long> buf;
+            buf.reserve(boxes.size()*nvals);
+            for (int i = 0, N = boxes.size(); i < N; ++i) {
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    buf.push_back(boxes[i].smallEnd(idim));
+                    buf.push_back(boxes[i].bigEnd(idim));
+                }
+                buf.push_back(ntags[i]);
+            }
+            Long n = buf.size();
+            ParallelDescriptor::Send(&n, 1, dst, seqno);
+            if (n > 0) {
+                ParallelDescriptor::Send(buf.data(), n, dst, seqno);
+            }
+            boxes.clear();
+            ntags.clear();
+            break;
+        }
+        else if (rank + stride < nprocs)
+        {
+            const int src = (rank + stride + ioproc) % nprocs;
+            Long n = 0;
+            ParallelDescriptor::Recv(&n, 1, src, seqno);
+            if (n > 0)
+            {
+                Vector<Long> buf(n);
+                ParallelDescriptor::Recv(buf.data(), n, src, seqno);
+                for (Long m = 0; m < n; m += nvals) {
+                    IntVect lo, hi;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        lo[idim] = static_cast<int>(buf[m+2*idim]);
+                        hi[idim] = static_cast<int>(buf[m+2*idim+1]);
+                    }
+                    boxes.push_back(Box(lo,hi));
+                    ntags.push_back(buf[m+nvals-1]);
+                }
+                mergeClusterBoxes(boxes, ntags, eff, domba);
+            }
+        }
+    }
+#endif
+
+    if (ParallelDescriptor::IOProcessor()) {
+        return BoxList(std::move(boxes));
+    } else {
+        return BoxList();
+    }
+}
+
 }
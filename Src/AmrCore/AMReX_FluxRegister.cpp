@@ -573,6 +573,100 @@ FluxRegister::Reflux (MultiFab& mf, const MultiFab& volume, Orientation face,
     }
 }
 
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             const MultiFab& volume,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    BL_PROFILE("FluxRegister::Reflux_nowait()");
+
+    AMREX_ASSERT_WITH_MESSAGE(rf_mf == nullptr,
+                              "FluxRegister::Reflux_nowait: previous Reflux_nowait not finished");
+
+    rf_mf     = &mf;
+    rf_volume = &volume;
+    rf_scale  = scale;
+    rf_dcomp  = dcomp;
+    rf_ncomp  = nc;
+
+    for (OrientationIter fi; fi; ++fi)
+    {
+        const Orientation& face = fi();
+        const int idir = face.coordDir();
+
+        rf_flux[face].reset(new MultiFab(amrex::convert(mf.boxArray(),
+                                                        IntVect::TheDimensionVector(idir)),
+                                         mf.DistributionMap(), nc, 0, MFInfo(), mf.Factory()));
+        rf_flux[face]->setVal(0.0);
+        rf_flux[face]->ParallelCopy_nowait(bndry[face].m_mf, scomp, 0, nc, IntVect(0), IntVect(0),
+                                           geom.periodicity());
+    }
+}
+
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    const Real* dx = geom.CellSize();
+
+    rf_cvolume.define(mf.boxArray(), mf.DistributionMap(), 1, 0, MFInfo(), mf.Factory());
+
+    rf_cvolume.setVal(AMREX_D_TERM(dx[0],*dx[1],*dx[2]), 0, 1, 0);
+
+    Reflux_nowait(mf,rf_cvolume,scale,scomp,dcomp,nc,geom);
+}
+
+void
+FluxRegister::Reflux_finish ()
+{
+    BL_PROFILE("FluxRegister::Reflux_finish()");
+
+    if (rf_mf == nullptr) return;
+
+    MultiFab& mf = *rf_mf;
+    const Real scale = rf_scale;
+    const int dcomp = rf_dcomp;
+    const int nc = rf_ncomp;
+
+    // The faces are done in the same order as Reflux so that the results
+    // are identical.
+    for (OrientationIter fi; fi; ++fi)
+    {
+        const Orientation face = fi();
+        MultiFab& flux = *rf_flux[face];
+        flux.ParallelCopy_finish();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const& sfab = mf.array(mfi);
+            Array4<Real const> const& ffab = flux.const_array(mfi);
+            Array4<Real const> const& vfab = rf_volume->const_array(mfi);
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA (bx, tbx,
+            {
+                fluxreg_reflux(tbx, sfab, dcomp, ffab, vfab, nc, scale, face);
+            });
+        }
+
+        rf_flux[face].reset();
+    }
+
+    rf_cvolume.clear();
+    rf_mf = nullptr;
+    rf_volume = nullptr;
+}
+
 void
 FluxRegister::ClearInternalBorders (const Geometry& geom)
 {
@@ -6,23 +6,20 @@
 #include <AMReX_Interpolater.H>
 #include <AMReX_Interp_C.H>
 
-#ifndef BL_NO_FORT
-#include <AMReX_INTERP_F.H>
-#endif
-
 namespace amrex {
 
 //
-// PCInterp, NodeBilinear, FaceLinear, and CellConservativeLinear are supported for all dimensions
-// on cpu and gpu.
+// PCInterp, NodeBilinear, FaceLinear, CellConservativeLinear, CellBilinear and
+// CellConservativeQuartic are supported for all dimensions on cpu and gpu.
 //
-// CellConsertiveProtected only works in 2D and 3D on cpu.
+// CellConservativeLinear and CellConservativeProtected use fused kernels
+// specialized for a ref ratio of 2 or 4 in all directions.
 //
-// CellBilinear works in 1D, 2D and 3D on cpu.
+// CellConservativeProtected only works in 2D and 3D on cpu and gpu.
 //
-// CellQuadratic only works in 2D on cpu.
+// CellQuadratic only works in 2D on cpu and gpu.
 //
-// CellConservativeQuartic only works with ref ratio of 2 on cpu
+// CellConservativeQuartic only works with ref ratio of 2.
 //
 
 //
@@ -33,13 +30,39 @@ NodeBilinear              node_bilinear_interp;
 FaceLinear                face_linear_interp;
 CellConservativeLinear    lincc_interp;
 CellConservativeLinear    cell_cons_interp(0);
-
-#ifndef BL_NO_FORT
 CellBilinear              cell_bilinear_interp;
 CellQuadratic             quadratic_interp;
 CellConservativeProtected protected_interp;
 CellConservativeQuartic   quartic_interp;
-#endif
+
+namespace {
+
+//
+// Linear conservative interpolation with the fused kernels for a ref ratio
+// of R in all directions.  There is one thread per coarse cell of cslope_bx.
+//
+template <int R>
+void
+cellconslin_fused (Box const& fine_region, Array4<Real> const& finearr, int fine_comp, int ncomp,
+                   Array4<Real const> const& crsearr, int crse_comp, Box const& cslope_bx,
+                   BCRec const* bcrp, Real const* voff, bool lin_lim, RunOn runon)
+{
+    if (lin_lim) {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(runon, cslope_bx, i, j, k,
+        {
+            amrex::cellconslin_fused_linlim<R>(i, j, k, fine_region, finearr, fine_comp, ncomp,
+                                               crsearr, crse_comp, cslope_bx, bcrp, voff);
+        });
+    } else {
+        AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, cslope_bx, ncomp, i, j, k, n,
+        {
+            amrex::cellconslin_fused_mclim<R>(i, j, k, n, fine_region, finearr, fine_comp,
+                                              crsearr, crse_comp, cslope_bx, bcrp, voff);
+        });
+    }
+}
+
+}
 
 Interpolater::~Interpolater () {}
 
@@ -213,7 +236,6 @@ FaceLinear::interp (const FArrayBox&  crse,
 
 FaceLinear::~FaceLinear () {}
 
-#ifndef BL_NO_FORT
 CellBilinear::~CellBilinear () {}
 
 Box
@@ -257,44 +279,20 @@ CellBilinear::interp (const FArrayBox&  crse,
                       const Geometry& /*crse_geom*/,
                       const Geometry& /*fine_geom*/,
                       Vector<BCRec> const& /*bcr*/,
-                      int               actual_comp,
-                      int               actual_state,
-                      RunOn             /*runon*/)
+                      int               /*actual_comp*/,
+                      int               /*actual_state*/,
+                      RunOn             runon)
 {
     BL_PROFILE("CellBilinear::interp()");
-    //
-    // Set up to call FORTRAN.
-    //
-    const int* clo = crse.box().loVect();
-    const int* chi = crse.box().hiVect();
-    const int* flo = fine.loVect();
-    const int* fhi = fine.hiVect();
-    const int* lo  = fine_region.loVect();
-    const int* hi  = fine_region.hiVect();
-    int num_slope  = AMREX_D_TERM(2,*2,*2)-1;
-    int len0       = crse.box().length(0);
-    int slp_len    = num_slope*len0;
-
-    Vector<Real> slope(slp_len);
-
-    int strp_len = len0*ratio[0];
 
-    Vector<Real> strip(strp_len);
-
-    int strip_lo = ratio[0] * clo[0];
-    int strip_hi = ratio[0] * chi[0];
-
-    const Real* cdat  = crse.dataPtr(crse_comp);
-    Real*       fdat  = fine.dataPtr(fine_comp);
-    const int* ratioV = ratio.getVect();
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    amrex_cbinterp (cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-                   fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),AMREX_ARLIM(lo),AMREX_ARLIM(hi),
-                   AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),&ncomp,
-                   slope.dataPtr(),&num_slope,strip.dataPtr(),&strip_lo,&strip_hi,
-                   &actual_comp,&actual_state);
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon,fine_region,ncomp,i,j,k,n,
+    {
+        amrex::cellbilin_interp(i,j,k,n,finearr,fine_comp,crsearr,crse_comp,ratio);
+    });
 }
-#endif
 
 Vector<int>
 Interpolater::GetBCArray (const Vector<BCRec>& bcr)
@@ -371,6 +369,21 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
     BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
 
+    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, crse_geom, fine_geom);
+
+    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
+    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
+
+    if (ratio == IntVect(2)) {
+        cellconslin_fused<2>(fine_region, finearr, fine_comp, ncomp, crsearr, crse_comp,
+                             cslope_bx, bcrp, voff, do_linear_limiting, runon);
+        return;
+    } else if (ratio == IntVect(4)) {
+        cellconslin_fused<4>(fine_region, finearr, fine_comp, ncomp, crsearr, crse_comp,
+                             cslope_bx, bcrp, voff, do_linear_limiting, runon);
+        return;
+    }
+
     // component of ccfab : slopes for first compoent for x-direction
     //                      slopes for second component for x-direction
     //                      ...
@@ -386,11 +399,6 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     if (run_on_gpu) cceli = ccfab.elixir();
     Array4<Real> const& ccarr = ccfab.array();
 
-    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, crse_geom, fine_geom);
-
-    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
-    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
-
     if (do_linear_limiting) {
         AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( runon, cslope_bx, tbx,
         {
@@ -432,7 +440,6 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     }
 }
 
-#ifndef BL_NO_FORT
 CellQuadratic::CellQuadratic (bool limit)
 {
     do_limited_slope = limit;
@@ -469,100 +476,45 @@ CellQuadratic::interp (const FArrayBox& crse,
                        const Geometry&  crse_geom,
                        const Geometry&  fine_geom,
                        Vector<BCRec> const&  bcr,
-                       int              actual_comp,
-                       int              actual_state,
-                       RunOn            /*runon*/)
+                       int              /*actual_comp*/,
+                       int              /*actual_state*/,
+                       RunOn            runon)
 {
-#if (AMREX_SPACEDIM == 1)
+#if (AMREX_SPACEDIM != 2)
     amrex::ignore_unused(crse,crse_comp,fine,fine_comp,ncomp,fine_region,
-                         ratio,crse_geom,fine_geom,bcr,actual_comp,actual_state);
-    amrex::Abort("1D CellQuadratic::interp not supported");
+                         ratio,crse_geom,fine_geom,bcr,runon);
+    amrex::Abort("CellQuadratic::interp only works in 2D");
 #else
     BL_PROFILE("CellQuadratic::interp()");
     BL_ASSERT(bcr.size() >= ncomp);
+
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
     Box target_fine_region = fine_region & fine.box();
 
     Box crse_bx(amrex::coarsen(target_fine_region,ratio));
-    Box fslope_bx(amrex::refine(crse_bx,ratio));
-    Box cslope_bx(crse_bx);
-    cslope_bx.grow(1);
-    BL_ASSERT(crse.box().contains(cslope_bx));
-    //
-    // Alloc temp space for coarse grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms
-    //
-    long t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int c_len = int(t_long);
+    BL_ASSERT(crse.box().contains(amrex::grow(crse_bx,1)));
 
-    Vector<Real> cslope(5*c_len);
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    int loslp = cslope_bx.index(crse_bx.smallEnd());
-    int hislp = cslope_bx.index(crse_bx.bigEnd());
+    AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
+    BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
 
-    t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int cslope_vol = int(t_long);
-    int clo        = 1 - loslp;
-    int chi        = clo + cslope_vol - 1;
-    c_len          = hislp - loslp + 1;
-    //
-    // Alloc temp space for one strip of fine grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms.
-    //
-    int dir;
-    int f_len = fslope_bx.longside(dir);
+    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(crse_bx, ratio, crse_geom, fine_geom);
 
-    Vector<Real> strip((5+2)*f_len);
+    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
+    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
 
-    Real* fstrip = strip.dataPtr();
-    Real* foff   = fstrip + f_len;
-    Real* fslope = foff + f_len;
-    //
-    // Get coarse and fine edge-centered volume coordinates.
-    //
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon,target_fine_region,ncomp,i,j,k,n,
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
-    }
-    //
-    // Alloc tmp space for slope calc and to allow for vectorization.
-    //
-    Real* fdat        = fine.dataPtr(fine_comp);
-    const Real* cdat  = crse.dataPtr(crse_comp);
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* cblo   = crse_bx.loVect();
-    const int* cbhi   = crse_bx.hiVect();
-    const int* fslo   = fslope_bx.loVect();
-    const int* fshi   = fslope_bx.hiVect();
-    int slope_flag    = (do_limited_slope ? 1 : 0);
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-
-    amrex_cqinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                   AMREX_ARLIM(fblo), AMREX_ARLIM(fbhi),
-                   &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                   cdat,&clo,&chi,
-                   AMREX_ARLIM(cblo), AMREX_ARLIM(cbhi),
-                   fslo,fshi,
-                   cslope.dataPtr(),&c_len,fslope,fstrip,&f_len,foff,
-                   bc.dataPtr(), &slope_flag,
-                   AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
-                   AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
-                   &actual_comp,&actual_state);
-
-#endif /*(AMREX_SPACEDIM > 1)*/
-}
+        amrex::cellquad_interp(i,j,k,n,finearr,fine_comp,crsearr,crse_comp,crse_bx,bcrp,voff,ratio);
+    });
 #endif
+}
 
 
 PCInterp::~PCInterp () {}
@@ -607,7 +559,6 @@ PCInterp::interp (const FArrayBox& crse,
     });
 }
 
-#ifndef BL_NO_FORT
 CellConservativeProtected::CellConservativeProtected () {}
 
 CellConservativeProtected::~CellConservativeProtected () {}
@@ -661,6 +612,21 @@ CellConservativeProtected::interp (const FArrayBox& crse,
     AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
     BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
 
+    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, crse_geom, fine_geom);
+
+    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
+    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
+
+    if (ratio == IntVect(2)) {
+        cellconslin_fused<2>(fine_region, finearr, fine_comp, ncomp, crsearr, crse_comp,
+                             cslope_bx, bcrp, voff, true, runon);
+        return;
+    } else if (ratio == IntVect(4)) {
+        cellconslin_fused<4>(fine_region, finearr, fine_comp, ncomp, crsearr, crse_comp,
+                             cslope_bx, bcrp, voff, true, runon);
+        return;
+    }
+
     // component of ccfab : slopes for first compoent for x-direction
     //                      slopes for second component for x-direction
     //                      ...
@@ -675,11 +641,6 @@ CellConservativeProtected::interp (const FArrayBox& crse,
     if (run_on_gpu) cceli = ccfab.elixir();
     Array4<Real> const& ccarr = ccfab.array();
 
-    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, crse_geom, fine_geom);
-
-    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
-    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
-
     AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon, cslope_bx, tbx,
     {
         amrex::cellconslin_slopes_linlim(tbx, ccarr, crsearr, crse_comp, ncomp, bcrp);
@@ -693,8 +654,8 @@ CellConservativeProtected::interp (const FArrayBox& crse,
 }
 
 void
-CellConservativeProtected::protect (const FArrayBox& crse,
-                                    int              crse_comp,
+CellConservativeProtected::protect (const FArrayBox& /*crse*/,
+                                    int              /*crse_comp*/,
                                     FArrayBox&       fine,
                                     int              fine_comp,
                                     FArrayBox&       fine_state,
@@ -705,12 +666,12 @@ CellConservativeProtected::protect (const FArrayBox& crse,
                                     const Geometry&  crse_geom,
                                     const Geometry&  fine_geom,
                                     Vector<BCRec>&   bcr,
-                                    RunOn            /*runon*/)
+                                    RunOn            runon)
 {
 #if (AMREX_SPACEDIM == 1)
-    amrex::ignore_unused(crse,crse_comp,fine,fine_comp,fine_state,
+    amrex::ignore_unused(fine,fine_comp,fine_state,
                          state_comp,ncomp,fine_region,ratio,
-                         crse_geom,fine_geom,bcr);
+                         crse_geom,fine_geom,bcr,runon);
     amrex::Abort("1D CellConservativeProtected::protect not supported");
 #else
     BL_PROFILE("CellConservativeProtected::protect()");
@@ -721,81 +682,52 @@ CellConservativeProtected::protect (const FArrayBox& crse,
     //
     Box target_fine_region = fine_region & fine.box();
 
-    //
-    // crse_bx is coarsening of target_fine_region, grown by 1.
-    //
-    Box crse_bx = CoarseBox(target_fine_region,ratio);
-
     //
     // cs_bx is coarsening of target_fine_region.
     //
-    Box cs_bx(crse_bx);
-    cs_bx.grow(-1);
+    Box cs_bx = amrex::coarsen(target_fine_region,ratio);
+
+    Array4<Real> const& finearr = fine.array();
+    Array4<Real const> const& statearr = fine_state.const_array();
+
+#if (AMREX_SPACEDIM == 2)
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
 
     //
-    // Get coarse and fine edge-centered volume coordinates.
+    // Get fine edge-centered volume coordinates.  They are on the box of
+    // fine, because the fine cells of the coarse cells on the edges of
+    // cs_bx can be outside target_fine_region.
     //
-    int dir;
+    amrex::ignore_unused(crse_geom);
+    const Box& fvc_bx = fine.box();
     Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++)
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        fine_geom.GetEdgeVolCoord(fvc[dir],fvc_bx,dir);
     }
 
-#if (AMREX_SPACEDIM == 2)
-    const int* cvcblo = crse_bx.loVect();
-    const int* fvcblo = target_fine_region.loVect();
-
-    int cvcbhi[AMREX_SPACEDIM];
-    int fvcbhi[AMREX_SPACEDIM];
+    AsyncArray<Real> async_fvcx(fvc[0].data(), (run_on_gpu) ? fvc[0].size() : 0);
+    AsyncArray<Real> async_fvcy(fvc[1].data(), (run_on_gpu) ? fvc[1].size() : 0);
+    Real const* fvcx = (run_on_gpu) ? async_fvcx.data() : fvc[0].data();
+    Real const* fvcy = (run_on_gpu) ? async_fvcy.data() : fvc[1].data();
 
-    for (dir=0; dir<AMREX_SPACEDIM; dir++)
+    AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(runon, cs_bx, i, j, k,
     {
-        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
-        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
-    }
-#endif
+        amrex::ccprotect_interp(i, j, k, finearr, fine_comp, statearr, state_comp, ncomp, ratio,
+                                fvc_bx, fvcx, fvcy);
+    });
+#else
+    amrex::ignore_unused(crse_geom,fine_geom);
 
-    Real* fdat       = fine.dataPtr(fine_comp);
-    Real* state_dat  = fine_state.dataPtr(state_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* slo    = fine_state.loVect();
-    const int* shi    = fine_state.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* csbhi  = cs_bx.hiVect();
-    const int* csblo  = cs_bx.loVect();
-
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-
-    amrex_protect_interp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                         fblo, fbhi,
-                         cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-                         csblo, csbhi,
-#if (AMREX_SPACEDIM == 2)
-                         fvc[0].dataPtr(),fvc[1].dataPtr(),
-                         AMREX_ARLIM(fvcblo), AMREX_ARLIM(fvcbhi),
-                         cvc[0].dataPtr(),cvc[1].dataPtr(),
-                         AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
+    AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(runon, cs_bx, i, j, k,
+    {
+        amrex::ccprotect_interp(i, j, k, finearr, fine_comp, statearr, state_comp, ncomp, ratio);
+    });
 #endif
-                         state_dat, AMREX_ARLIM(slo), AMREX_ARLIM(shi),
-                         &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                         bc.dataPtr());
 
 #endif /*(AMREX_SPACEDIM == 1)*/
-
 }
-#endif
 
-#ifndef BL_NO_FORT
 CellConservativeQuartic::~CellConservativeQuartic () {}
 
 Box
@@ -827,74 +759,36 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
 				 const Geometry&   /* crse_geom */,
 				 const Geometry&   /* fine_geom */,
 				 Vector<BCRec> const&   bcr,
-				 int               actual_comp,
-				 int               actual_state,
-                                 RunOn             /*runon*/)
+				 int               /*actual_comp*/,
+				 int               /*actual_state*/,
+                                 RunOn             runon)
 {
     BL_PROFILE("CellConservativeQuartic::interp()");
     BL_ASSERT(bcr.size() >= ncomp);
-    BL_ASSERT(ratio[0]==2);
-#if (AMREX_SPACEDIM >= 2)
-    BL_ASSERT(ratio[0] == ratio[1]);
-#endif
-#if (AMREX_SPACEDIM == 3)
-    BL_ASSERT(ratio[1] == ratio[2]);
-#endif
+    amrex::ignore_unused(bcr);
+
+    if (ratio != IntVect(2)) {
+        amrex::Abort("CellConservativeQuartic::interp: unsupported refinement ratio");
+    }
 
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
     Box target_fine_region = fine_region & fine.box();
     //
-    // crse_bx is coarsening of target_fine_region, grown by 2.
+    // crse_bx2 is coarsening of target_fine_region.
     //
-    Box crse_bx = CoarseBox(target_fine_region,ratio);
-
-    Box crse_bx2(crse_bx);
-    crse_bx2.grow(-2);
-    Box fine_bx2 = amrex::refine(crse_bx2,ratio);
-
-    Real* fdat       = fine.dataPtr(fine_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* cblo   = crse_bx.loVect();
-    const int* cbhi   = crse_bx.hiVect();
-    const int* cb2lo  = crse_bx2.loVect();
-    const int* cb2hi  = crse_bx2.hiVect();
-    const int* fb2lo  = fine_bx2.loVect();
-    const int* fb2hi  = fine_bx2.hiVect();
-
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-
-    int ltmp = fb2hi[0]-fb2lo[0]+1;
-    Vector<Real> ftmp(ltmp);
-
-#if (AMREX_SPACEDIM >= 2)
-    ltmp = (cbhi[0]-cblo[0]+1)*ratio[1];
-    Vector<Real> ctmp(ltmp);
-#endif
+    Box crse_bx2 = amrex::coarsen(target_fine_region,ratio);
+    BL_ASSERT(crse.box().contains(amrex::grow(crse_bx2,2)));
 
-#if (AMREX_SPACEDIM == 3)
-    ltmp = (cbhi[0]-cblo[0]+1)*(cbhi[1]-cblo[1]+1)*ratio[2];
-    Vector<Real> ctmp2(ltmp);
-#endif
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    amrex_quartinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-		      fblo, fbhi, fb2lo, fb2hi,
-		      cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-		      cblo, cbhi, cb2lo, cb2hi,
-		      &ncomp,
-		      AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-		      AMREX_D_DECL(ftmp.dataPtr(), ctmp.dataPtr(), ctmp2.dataPtr()),
-		      bc.dataPtr(),&actual_comp,&actual_state);
+    AMREX_HOST_DEVICE_PARALLEL_FOR_3D_FLAG(runon, crse_bx2, i, j, k,
+    {
+        amrex::quartinterp_interp(i, j, k, target_fine_region, finearr, fine_comp, ncomp,
+                                  crsearr, crse_comp);
+    });
 }
-#endif
 
 }
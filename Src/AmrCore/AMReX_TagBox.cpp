@@ -577,19 +577,25 @@ TagBoxArray::local_collate_gpu (Vector<IntVect>& v) const
 #endif
 
 void
-TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
+TagBoxArray::local_collate (Vector<IntVect>& v) const
 {
-    BL_PROFILE("TagBoxArray::collate()");
-
-    Vector<IntVect> TheLocalCollateSpace;
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
-        local_collate_gpu(TheLocalCollateSpace);
+        local_collate_gpu(v);
     } else
 #endif
     {
-        local_collate_cpu(TheLocalCollateSpace);
+        local_collate_cpu(v);
     }
+}
+
+void
+TagBoxArray::collate (Vector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("TagBoxArray::collate()");
+
+    Vector<IntVect> TheLocalCollateSpace;
+    local_collate(TheLocalCollateSpace);
 
     Long count = TheLocalCollateSpace.size();
 
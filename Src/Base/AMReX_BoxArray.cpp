@@ -568,6 +568,24 @@ BoxArray::maxSize (const IntVect& block_size)
     return *this;
 }
 
+BoxArray&
+BoxArray::orderSFC ()
+{
+    if ((not m_bat.is_simple()) or (crseRatio() != IntVect::TheUnitVector())) {
+        uniqify();
+    }
+    BoxList blst(*this);
+    blst.orderSFC();
+    if (*this != blst.data()) { // If the order doesn't change, do nothing.
+        BoxList bak = (m_simplified_list) ? *m_simplified_list : BoxList();
+        define(std::move(blst));
+        if (bak.isNotEmpty()) {
+            m_simplified_list = std::make_shared<BoxList>(std::move(bak));
+        }
+    }
+    return *this;
+}
+
 BoxArray&
 BoxArray::refine (int refinement_ratio)
 {
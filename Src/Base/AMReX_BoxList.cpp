@@ -7,6 +7,7 @@
 #include <AMReX_BoxArray.H>
 #include <AMReX_BoxList.H>
 #include <AMReX_BLProfiler.H>
+#include <AMReX_SFC.H>
 #include <AMReX_ParallelDescriptor.H>
 
 #ifdef _OPENMP
@@ -828,6 +829,28 @@ BoxList::maxSize (int chunk)
     return maxSize(IntVect(AMREX_D_DECL(chunk,chunk,chunk)));
 }
 
+BoxList&
+BoxList::orderSFC ()
+{
+    BL_PROFILE("BoxList::orderSFC()");
+
+    const int N = m_lbox.size();
+    std::vector<SFCToken> tokens;
+    tokens.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        tokens.push_back(makeSFCToken(i, m_lbox[i].smallEnd()));
+    }
+    std::sort(tokens.begin(), tokens.end(), SFCToken::Compare());
+
+    Vector<Box> new_boxes;
+    new_boxes.reserve(N);
+    for (const auto& t : tokens) {
+        new_boxes.push_back(m_lbox[t.m_box]);
+    }
+    m_lbox.swap(new_boxes);
+    return *this;
+}
+
 BoxList&
 BoxList::surroundingNodes () noexcept
 {
@@ -1,12 +1,14 @@
 
 #include <AMReX_MFIter.H>
 #include <AMReX_FabArray.H>
+#include <AMReX_LayoutData.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_OpenMP.H>
 
 namespace amrex {
 
 int MFIter::nextDynamicIndex = std::numeric_limits<int>::min();
+LayoutData<Real>* MFIter::cost_timer = nullptr;
 
 MFIter::MFIter (const FabArrayBase& fabarray_, 
 		unsigned char       flags_)
@@ -327,6 +329,15 @@ MFIter::Initialize ()
 
 	currentIndex = beginIndex;
 
+        // Only the loops over data on the grids of the costs.  Another level
+        // can have a DistributionMapping with the same owners.
+        if (cost_timer != nullptr &&
+            DistributionMap().getRefID() == cost_timer->DistributionMap().getRefID() &&
+            fabArray.boxArray().CellEqual(cost_timer->boxArray())) {
+            m_costs = cost_timer;
+            m_cost_t0 = ParallelDescriptor::second();
+        }
+
 #ifdef AMREX_USE_GPU
 	Gpu::Device::setStreamIndex((streams > 0) ? currentIndex%streams : -1);
         Gpu::resetNumCallbacks();
@@ -341,6 +352,21 @@ MFIter::Initialize ()
     }
 }
 
+void
+MFIter::addCost () noexcept
+{
+#ifdef AMREX_USE_GPU
+    Gpu::streamSynchronize();
+#endif
+    const double t = ParallelDescriptor::second();
+    Real& cost = (*m_costs)[*this];
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    cost += static_cast<Real>(t - m_cost_t0);
+    m_cost_t0 = t;
+}
+
 Box 
 MFIter::tilebox () const noexcept
 { 
@@ -481,6 +507,10 @@ MFIter::grownnodaltilebox (int dir, IntVect const& a_ng) const noexcept
 void
 MFIter::operator++ () noexcept
 {
+    if (m_costs != nullptr && isValid()) {
+        addCost();
+    }
+
 #ifdef _OPENMP
     if (dynamic)
     {
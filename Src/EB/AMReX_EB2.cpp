@@ -11,7 +11,12 @@
 #include <AMReX_EB2.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX.H>
+#include <AMReX_Utility.H>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -196,6 +201,23 @@ static int comp_max_crse_level (Box cdomain, const Box& domain)
 }
 }
 
+std::string
+coarseningStopReason (CoarseningStop stop)
+{
+    switch (stop) {
+    case CoarseningStop::MaxLevel:
+        return "the EB max_coarsening_level was reached";
+    case CoarseningStop::Domain:
+        return "the domain is not coarsenable";
+    case CoarseningStop::Grids:
+        return "the EB cut cell boxes are not coarsenable";
+    case CoarseningStop::MultiValued:
+        return "coarsening would create multi-valued or multi-cut EB cells";
+    default:
+        return "the EB index space was read from a file";
+    }
+}
+
 int
 maxCoarseningLevel (const Geometry& geom)
 {
@@ -212,4 +234,156 @@ maxCoarseningLevel (IndexSpace const* ebis, const Geometry& geom)
     return comp_max_crse_level(cdomain,domain);
 }
 
+namespace {
+    const std::string index_space_version("EB2_IndexSpace_Version_One");
+
+    // 64-bit FNV-1a
+    class Hasher
+    {
+    public:
+        template <class T>
+        void add (const T& x) noexcept {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &x, sizeof(T));
+            for (unsigned char b : bytes) {
+                m_hash = (m_hash ^ b) * 1099511628211ULL;
+            }
+        }
+        std::uint64_t value () const noexcept { return m_hash; }
+    private:
+        std::uint64_t m_hash = 14695981039346656037ULL;
+    };
+}
+
+IndexSpaceFromFile::IndexSpaceFromFile (const std::string& dir, const Geometry& geom)
+{
+    BL_PROFILE("EB2::IndexSpaceFromFile()");
+
+    m_coarsening_stop = CoarseningStop::Unknown;
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(dir + "/Header", fileCharPtr);
+    std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+
+    std::string version;
+    int nlevels;
+    is >> version >> nlevels;
+    if (version != index_space_version) {
+        amrex::Abort("EB2::IndexSpaceFromFile: unknown version " + version);
+    }
+
+    m_level.reserve(nlevels);
+    for (int ilev = 0; ilev < nlevels; ++ilev)
+    {
+        Box domain;
+        is >> domain;
+        Geometry g = (ilev == 0) ? geom : amrex::coarsen(m_geom.back(),2);
+        if (g.Domain() != domain) {
+            amrex::Abort("EB2::IndexSpaceFromFile: domain does not match " + dir);
+        }
+        m_geom.push_back(g);
+        m_domain.push_back(domain);
+        m_level.emplace_back(this, g, dir + "/Level_" + std::to_string(ilev));
+    }
+}
+
+const Level&
+IndexSpaceFromFile::getLevel (const Geometry& geom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), geom.Domain());
+    int i = std::distance(m_domain.begin(), it);
+    return m_level[i];
+}
+
+const Geometry&
+IndexSpaceFromFile::getGeometry (const Box& dom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), dom);
+    int i = std::distance(m_domain.begin(), it);
+    return m_geom[i];
+}
+
+void
+WriteIndexSpace (const IndexSpace& ebis, const Geometry& geom, const std::string& dir)
+{
+    BL_PROFILE("EB2::WriteIndexSpace()");
+
+    if (ParallelDescriptor::IOProcessor()) {
+        if (!amrex::UtilCreateDirectory(dir, 0755)) {
+            amrex::CreateDirectoryFailed(dir);
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    Vector<Box> domains;
+    Box domain = geom.Domain();
+    while (true)
+    {
+        const Geometry& g = ebis.getGeometry(domain);
+        ebis.getLevel(g).write(dir + "/Level_" + std::to_string(domains.size()));
+        domains.push_back(domain);
+        if (domain == ebis.coarsestDomain()) break;
+        domain.coarsen(2);
+    }
+
+    // The Header is written last, so that its presence means the index space is complete.
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const std::string HeaderFileName = dir + "/Header";
+        std::ofstream HeaderFile(HeaderFileName.c_str());
+        if (!HeaderFile.good()) amrex::FileOpenFailed(HeaderFileName);
+        HeaderFile << index_space_version << '\n' << domains.size() << '\n';
+        for (const auto& b : domains) {
+            HeaderFile << b << '\n';
+        }
+        if (!HeaderFile.good()) {
+            amrex::Abort("EB2::WriteIndexSpace: problem writing " + HeaderFileName);
+        }
+    }
+    ParallelDescriptor::Barrier();
+}
+
+bool
+IndexSpaceFileExists (const std::string& dir)
+{
+    int exists = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        exists = amrex::FileExists(dir + "/Header");
+    }
+    ParallelDescriptor::Bcast(&exists, 1, ParallelDescriptor::IOProcessorNumber());
+    return exists;
+}
+
+std::string
+IndexSpaceCacheKey (const Vector<Real>& if_samples, const Geometry& geom,
+                    const Vector<int>& build_params)
+{
+    Real small_volfrac = 1.e-14;
+    {
+        ParmParse pp("eb2");
+        pp.query("small_volfrac", small_volfrac);
+    }
+
+    Hasher h;
+    for (char c : index_space_version) h.add(c);
+    h.add(AMREX_SPACEDIM);
+    h.add(sizeof(Real));
+    h.add(max_grid_size);
+    h.add(small_volfrac);
+    h.add(geom.Coord());
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        h.add(geom.Domain().smallEnd(idim));
+        h.add(geom.Domain().bigEnd(idim));
+        h.add(geom.ProbLo(idim));
+        h.add(geom.ProbHi(idim));
+        h.add(geom.isPeriodic(idim));
+    }
+    for (int p : build_params) h.add(p);
+    for (Real v : if_samples) h.add(v);
+
+    std::ostringstream os;
+    os << "eb2_" << std::hex << std::setw(16) << std::setfill('0') << h.value();
+    return os.str();
+}
+
 }}
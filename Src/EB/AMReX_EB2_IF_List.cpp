@@ -0,0 +1,78 @@
+#include <AMReX_EB2_IF_List.H>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace amrex { namespace EB2 { namespace LIF_detail {
+
+namespace {
+    constexpr int max_leaf_size = 4;
+}
+
+BoxTree::BoxTree (const Vector<RealBox>& a_boxes)
+    : m_boxes(a_boxes)
+{
+    const int nboxes = m_boxes.size();
+    if (nboxes == 0) return;
+
+    Vector<Real> cen(AMREX_SPACEDIM*nboxes);
+    for (int i = 0; i < nboxes; ++i) {
+        for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+            cen[AMREX_SPACEDIM*i+n] = 0.5*(m_boxes[i].lo(n) + m_boxes[i].hi(n));
+        }
+    }
+
+    m_item.resize(nboxes);
+    std::iota(m_item.begin(), m_item.end(), 0);
+    m_nodes.reserve(2*(nboxes/max_leaf_size+1));
+    buildNode(cen, 0, nboxes);
+}
+
+int
+BoxTree::buildNode (const Vector<Real>& cen, int first, int last)
+{
+    const int inode = m_nodes.size();
+    m_nodes.emplace_back();
+
+    Node node;
+    Real clo[AMREX_SPACEDIM], chi[AMREX_SPACEDIM];
+    for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+        node.lo[n] = clo[n] =  std::numeric_limits<Real>::max();
+        node.hi[n] = chi[n] = -std::numeric_limits<Real>::max();
+    }
+    for (int i = first; i < last; ++i) {
+        const RealBox& b = m_boxes[m_item[i]];
+        for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+            node.lo[n] = std::min(node.lo[n], b.lo(n));
+            node.hi[n] = std::max(node.hi[n], b.hi(n));
+            clo[n] = std::min(clo[n], cen[AMREX_SPACEDIM*m_item[i]+n]);
+            chi[n] = std::max(chi[n], cen[AMREX_SPACEDIM*m_item[i]+n]);
+        }
+    }
+    node.first = first;
+    node.count = last - first;
+    node.right = -1;
+
+    int axis = 0;
+    for (int n = 1; n < AMREX_SPACEDIM; ++n) {
+        if (chi[n]-clo[n] > chi[axis]-clo[axis]) axis = n;
+    }
+
+    if (node.count > max_leaf_size && chi[axis] > clo[axis])
+    {
+        const int mid = first + (last-first)/2;
+        std::nth_element(m_item.begin()+first, m_item.begin()+mid, m_item.begin()+last,
+                         [&] (int a, int b) {
+                             return cen[AMREX_SPACEDIM*a+axis] < cen[AMREX_SPACEDIM*b+axis];
+                         });
+        node.count = 0;
+        buildNode(cen, first, mid);
+        node.right = buildNode(cen, mid, last);
+    }
+
+    m_nodes[inode] = node;
+    return inode;
+}
+
+}}}
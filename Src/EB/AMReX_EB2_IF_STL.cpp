@@ -0,0 +1,472 @@
+#include <AMReX_EB2_IF_STL.H>
+#include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+namespace amrex { namespace EB2 {
+
+#if (AMREX_SPACEDIM == 3)
+
+struct STLIF::Data
+{
+    //! An internal node's left child is the next node.  count > 0 for leaves.
+    struct Node
+    {
+        Real lo[3];
+        Real hi[3];
+        int first;
+        int count;
+        int right;
+    };
+
+    //! 9 coordinates per triangle, in the order of the leaves.
+    Vector<Real> tri;
+    Vector<Node> nodes;
+    Real tol;
+};
+
+namespace {
+
+constexpr int max_leaf_size = 4;
+constexpr int max_stack_size = 128;
+
+inline Real dot3 (const Real* a, const Real* b) noexcept
+{
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+inline void sub3 (Real* r, const Real* a, const Real* b) noexcept
+{
+    r[0] = a[0]-b[0];
+    r[1] = a[1]-b[1];
+    r[2] = a[2]-b[2];
+}
+
+inline void cross3 (Real* r, const Real* a, const Real* b) noexcept
+{
+    r[0] = a[1]*b[2] - a[2]*b[1];
+    r[1] = a[2]*b[0] - a[0]*b[2];
+    r[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+inline Real dist2 (const Real* p, const Real* q) noexcept
+{
+    Real d[3];
+    sub3(d, p, q);
+    return dot3(d, d);
+}
+
+// Squared distance from p to triangle t (Ericson, Real-Time Collision Detection, 5.1.5)
+Real dist2PointTriangle (const Real* p, const Real* t) noexcept
+{
+    const Real* a = t;
+    const Real* b = t+3;
+    const Real* c = t+6;
+    Real ab[3], ac[3], ap[3], bp[3], cp[3], q[3];
+    sub3(ab, b, a);
+    sub3(ac, c, a);
+
+    sub3(ap, p, a);
+    const Real d1 = dot3(ab, ap);
+    const Real d2 = dot3(ac, ap);
+    if (d1 <= 0.0 && d2 <= 0.0) return dot3(ap, ap);
+
+    sub3(bp, p, b);
+    const Real d3 = dot3(ab, bp);
+    const Real d4 = dot3(ac, bp);
+    if (d3 >= 0.0 && d4 <= d3) return dot3(bp, bp);
+
+    const Real vc = d1*d4 - d3*d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        const Real v = d1/(d1-d3);
+        for (int n = 0; n < 3; ++n) q[n] = a[n] + v*ab[n];
+        return dist2(p, q);
+    }
+
+    sub3(cp, p, c);
+    const Real d5 = dot3(ab, cp);
+    const Real d6 = dot3(ac, cp);
+    if (d6 >= 0.0 && d5 <= d6) return dot3(cp, cp);
+
+    const Real vb = d5*d2 - d1*d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        const Real w = d2/(d2-d6);
+        for (int n = 0; n < 3; ++n) q[n] = a[n] + w*ac[n];
+        return dist2(p, q);
+    }
+
+    const Real va = d3*d6 - d5*d4;
+    if (va <= 0.0 && (d4-d3) >= 0.0 && (d5-d6) >= 0.0) {
+        const Real w = (d4-d3)/((d4-d3)+(d5-d6));
+        for (int n = 0; n < 3; ++n) q[n] = b[n] + w*(c[n]-b[n]);
+        return dist2(p, q);
+    }
+
+    const Real denom = 1.0/(va+vb+vc);
+    const Real v = vb*denom;
+    const Real w = vc*denom;
+    for (int n = 0; n < 3; ++n) q[n] = a[n] + ab[n]*v + ac[n]*w;
+    return dist2(p, q);
+}
+
+// Does the ray o + s*dir, s > 0, cross triangle t?  (Moller-Trumbore)
+bool rayHitsTriangle (const Real* o, const Real* dir, const Real* t) noexcept
+{
+    Real e1[3], e2[3], pv[3], tv[3], qv[3];
+    sub3(e1, t+3, t);
+    sub3(e2, t+6, t);
+    cross3(pv, dir, e2);
+    const Real det = dot3(e1, pv);
+    if (det == 0.0) return false;
+    const Real inv = 1.0/det;
+    sub3(tv, o, t);
+    const Real u = dot3(tv, pv)*inv;
+    if (u < 0.0 || u > 1.0) return false;
+    cross3(qv, tv, e1);
+    const Real v = dot3(dir, qv)*inv;
+    if (v < 0.0 || u+v > 1.0) return false;
+    return dot3(e2, qv)*inv > 0.0;
+}
+
+inline bool rayHitsBox (const Real* o, const Real* invdir, const Real* lo, const Real* hi) noexcept
+{
+    Real tmin = 0.0;
+    Real tmax = std::numeric_limits<Real>::max();
+    for (int n = 0; n < 3; ++n) {
+        Real t0 = (lo[n]-o[n])*invdir[n];
+        Real t1 = (hi[n]-o[n])*invdir[n];
+        if (t0 > t1) std::swap(t0, t1);
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+        if (tmin > tmax) return false;
+    }
+    return true;
+}
+
+inline Real dist2PointBox (const Real* p, const Real* lo, const Real* hi) noexcept
+{
+    Real r = 0.0;
+    for (int n = 0; n < 3; ++n) {
+        Real d = std::max(std::max(lo[n]-p[n], p[n]-hi[n]), Real(0.0));
+        r += d*d;
+    }
+    return r;
+}
+
+void triangleBox (const Real* t, Real* lo, Real* hi) noexcept
+{
+    for (int n = 0; n < 3; ++n) {
+        lo[n] = std::min(std::min(t[n], t[3+n]), t[6+n]);
+        hi[n] = std::max(std::max(t[n], t[3+n]), t[6+n]);
+    }
+}
+
+int buildNode (Vector<STLIF::Data::Node>& nodes, Vector<int>& idx, const Vector<Real>& cen,
+               const Vector<Real>& tri, int first, int last)
+{
+    const int inode = nodes.size();
+    nodes.emplace_back();
+
+    STLIF::Data::Node node;
+    Real clo[3], chi[3];
+    for (int n = 0; n < 3; ++n) {
+        node.lo[n] = clo[n] =  std::numeric_limits<Real>::max();
+        node.hi[n] = chi[n] = -std::numeric_limits<Real>::max();
+    }
+    for (int i = first; i < last; ++i) {
+        Real tlo[3], thi[3];
+        triangleBox(&tri[9*idx[i]], tlo, thi);
+        for (int n = 0; n < 3; ++n) {
+            node.lo[n] = std::min(node.lo[n], tlo[n]);
+            node.hi[n] = std::max(node.hi[n], thi[n]);
+            clo[n] = std::min(clo[n], cen[3*idx[i]+n]);
+            chi[n] = std::max(chi[n], cen[3*idx[i]+n]);
+        }
+    }
+    node.first = first;
+    node.count = last - first;
+    node.right = -1;
+
+    int axis = 0;
+    for (int n = 1; n < 3; ++n) {
+        if (chi[n]-clo[n] > chi[axis]-clo[axis]) axis = n;
+    }
+
+    if (node.count > max_leaf_size && chi[axis] > clo[axis])
+    {
+        const int mid = first + (last-first)/2;
+        std::nth_element(idx.begin()+first, idx.begin()+mid, idx.begin()+last,
+                         [&] (int a, int b) { return cen[3*a+axis] < cen[3*b+axis]; });
+        node.count = 0;
+        buildNode(nodes, idx, cen, tri, first, mid);
+        node.right = buildNode(nodes, idx, cen, tri, mid, last);
+    }
+
+    nodes[inode] = node;
+    return inode;
+}
+
+bool isBinarySTL (const Vector<char>& buf, Long nbytes, std::uint32_t& ntri)
+{
+    if (nbytes < 84) return false;
+    std::memcpy(&ntri, buf.data()+80, sizeof(std::uint32_t));
+    return nbytes == 84 + 50*static_cast<Long>(ntri);
+}
+
+}
+
+STLIF::STLIF (const std::string& a_filename, bool a_inside, Real a_scale,
+              const RealArray& a_center)
+    : m_sign(a_inside ? 1.0 : -1.0)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(a_filename, buf);
+    // ReadAndBcastFile appends a null character.
+    const Long nbytes = buf.size() - 1;
+
+    Vector<Real> vertices;
+    std::uint32_t ntri = 0;
+    if (isBinarySTL(buf, nbytes, ntri))
+    {
+        vertices.reserve(9*ntri);
+        const char* p = buf.data() + 84;
+        for (std::uint32_t i = 0; i < ntri; ++i, p += 50) {
+            // 3 floats of normal, 9 floats of vertices and a 2-byte attribute
+            float v[9];
+            std::memcpy(v, p + 3*sizeof(float), 9*sizeof(float));
+            for (int n = 0; n < 9; ++n) vertices.push_back(v[n]);
+        }
+    }
+    else
+    {
+        std::istringstream is(std::string(buf.data(), nbytes));
+        std::string word;
+        while (is >> word) {
+            if (word == "vertex") {
+                Real x, y, z;
+                is >> x >> y >> z;
+                vertices.push_back(x);
+                vertices.push_back(y);
+                vertices.push_back(z);
+            }
+        }
+        if (vertices.size() % 9 != 0) {
+            amrex::Abort("EB2::STLIF: problem reading " + a_filename);
+        }
+    }
+
+    for (Long i = 0, n = vertices.size(); i < n; ++i) {
+        vertices[i] = vertices[i]*a_scale + a_center[i%3];
+    }
+
+    build(std::move(vertices));
+}
+
+STLIF::STLIF (const Vector<Real>& a_vertices, bool a_inside)
+    : m_sign(a_inside ? 1.0 : -1.0)
+{
+    AMREX_ALWAYS_ASSERT(a_vertices.size() % 9 == 0);
+    Vector<Real> vertices(a_vertices);
+    build(std::move(vertices));
+}
+
+void
+STLIF::build (Vector<Real>&& a_vertices)
+{
+    // Degenerate triangles have no area and break the closest point test.
+    Vector<Real> tri;
+    tri.reserve(a_vertices.size());
+    for (Long i = 0, n = a_vertices.size(); i < n; i += 9) {
+        const Real* t = &a_vertices[i];
+        Real e1[3], e2[3], nrm[3];
+        sub3(e1, t+3, t);
+        sub3(e2, t+6, t);
+        cross3(nrm, e1, e2);
+        if (dot3(nrm, nrm) > 0.0) {
+            tri.insert(tri.end(), t, t+9);
+        }
+    }
+    a_vertices.clear();
+
+    const int ntri = tri.size() / 9;
+    if (ntri == 0) {
+        amrex::Abort("EB2::STLIF: no triangles");
+    }
+
+    Vector<Real> cen(3*ntri);
+    Vector<int> idx(ntri);
+    for (int i = 0; i < ntri; ++i) {
+        idx[i] = i;
+        for (int n = 0; n < 3; ++n) {
+            cen[3*i+n] = (tri[9*i+n] + tri[9*i+3+n] + tri[9*i+6+n]) * (1./3.);
+        }
+    }
+
+    auto data = std::make_shared<Data>();
+    data->nodes.reserve(2*(ntri/max_leaf_size+1));
+    buildNode(data->nodes, idx, cen, tri, 0, ntri);
+
+    data->tri.resize(tri.size());
+    for (int i = 0; i < ntri; ++i) {
+        std::copy(&tri[9*idx[i]], &tri[9*idx[i]]+9, &data->tri[9*i]);
+    }
+
+    const auto& root = data->nodes[0];
+    Real extent = 0.0;
+    for (int n = 0; n < 3; ++n) extent = std::max(extent, root.hi[n]-root.lo[n]);
+    data->tol = 1.e-10*extent;
+
+    m_data = data;
+}
+
+Real
+STLIF::distance (const RealArray& p) const noexcept
+{
+    const auto& nodes = m_data->nodes;
+    const Real* tri = m_data->tri.data();
+
+    Real d2min = std::numeric_limits<Real>::max();
+    int stack[max_stack_size];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const auto& node = nodes[stack[--top]];
+        if (dist2PointBox(p.data(), node.lo, node.hi) >= d2min) continue;
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first+node.count; ++i) {
+                d2min = std::min(d2min, dist2PointTriangle(p.data(), tri+9*i));
+            }
+        } else {
+            AMREX_ASSERT(top+2 <= max_stack_size);
+            const int left = &node - nodes.data() + 1;
+            const int right = node.right;
+            // Visit the nearer child first so that the other one is more likely pruned.
+            if (dist2PointBox(p.data(), nodes[left].lo, nodes[left].hi) <
+                dist2PointBox(p.data(), nodes[right].lo, nodes[right].hi)) {
+                stack[top++] = right;
+                stack[top++] = left;
+            } else {
+                stack[top++] = left;
+                stack[top++] = right;
+            }
+        }
+    }
+    return std::sqrt(d2min);
+}
+
+bool
+STLIF::insideSurface (const RealArray& p) const noexcept
+{
+    // The directions are not aligned with the axes, so that rays from grid
+    // nodes seldom graze the edges of meshes made on nice coordinates.
+    // A majority vote of three rays protects against the rest.
+    static constexpr Real dirs[3][3] = {{1.0, 0.2113248654, 0.1087731496},
+                                        {0.1306563965, 1.0, 0.2742382982},
+                                        {0.2350482341, 0.0927318305, 1.0}};
+
+    const auto& nodes = m_data->nodes;
+    const Real* tri = m_data->tri.data();
+
+    int ninside = 0;
+    for (int r = 0; r < 3; ++r)
+    {
+        const Real* dir = dirs[r];
+        const Real invdir[3] = {1.0/dir[0], 1.0/dir[1], 1.0/dir[2]};
+        int ncross = 0;
+        int stack[max_stack_size];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const auto& node = nodes[stack[--top]];
+            if (!rayHitsBox(p.data(), invdir, node.lo, node.hi)) continue;
+            if (node.count > 0) {
+                for (int i = node.first; i < node.first+node.count; ++i) {
+                    if (rayHitsTriangle(p.data(), dir, tri+9*i)) ++ncross;
+                }
+            } else {
+                AMREX_ASSERT(top+2 <= max_stack_size);
+                stack[top++] = node.right;
+                stack[top++] = &node - nodes.data() + 1;
+            }
+        }
+        if (ncross % 2 == 1) ++ninside;
+        if (ninside == 2 || ninside + (2-r) < 2) break;
+    }
+    return ninside >= 2;
+}
+
+Real
+STLIF::operator() (const RealArray& p) const noexcept
+{
+    const Real d = distance(p);
+    return insideSurface(p) ? -m_sign*d : m_sign*d;
+}
+
+int
+STLIF::regionType (const RealArray& lo, const RealArray& hi) const noexcept
+{
+    const auto& nodes = m_data->nodes;
+    const Real* tri = m_data->tri.data();
+    const Real tol = m_data->tol;
+
+    auto overlaps = [&] (const Real* blo, const Real* bhi) -> bool
+    {
+        for (int n = 0; n < 3; ++n) {
+            if (blo[n] > hi[n]+tol || bhi[n] < lo[n]-tol) return false;
+        }
+        return true;
+    };
+
+    int stack[max_stack_size];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const auto& node = nodes[stack[--top]];
+        if (!overlaps(node.lo, node.hi)) continue;
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first+node.count; ++i) {
+                Real tlo[3], thi[3];
+                triangleBox(tri+9*i, tlo, thi);
+                if (overlaps(tlo, thi)) return 0;
+            }
+        } else {
+            AMREX_ASSERT(top+2 <= max_stack_size);
+            stack[top++] = node.right;
+            stack[top++] = &node - nodes.data() + 1;
+        }
+    }
+
+    // No triangle comes near the region, so it is all on one side.
+    const RealArray center{0.5*(lo[0]+hi[0]), 0.5*(lo[1]+hi[1]), 0.5*(lo[2]+hi[2])};
+    const Real s = insideSurface(center) ? -m_sign : m_sign;
+    return (s > 0.0) ? 1 : -1;
+}
+
+Long
+STLIF::numTriangles () const noexcept
+{
+    return m_data->tri.size() / 9;
+}
+
+void
+STLIF::boundingBox (RealArray& lo, RealArray& hi) const noexcept
+{
+    const auto& root = m_data->nodes[0];
+    for (int n = 0; n < 3; ++n) {
+        lo[n] = root.lo[n];
+        hi[n] = root.hi[n];
+    }
+}
+
+#endif
+
+}}
@@ -1,7 +1,9 @@
 
 #include <AMReX_EB2_Level.H>
 #include <AMReX_IArrayBox.H>
+#include <AMReX_Utility.H>
 #include <algorithm>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -76,6 +78,90 @@ Level::prepareForCoarsening (const Level& rhs, int max_grid_size, IntVect ngrow)
     m_ok = true;
 }
 
+namespace {
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int levelset_sign (Real v) noexcept
+    {
+        return (v < 0.0) ? -1 : ((v > 0.0) ? 1 : 0);
+    }
+
+    // Does the node change its sign, or its value at the end of an edge
+    // crossing the boundary?
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool levelset_node_changed (IntVect const& iv, Box const& bx,
+                                Array4<Real const> const& a, Array4<Real const> const& b) noexcept
+    {
+        const int s = levelset_sign(a(iv));
+        if (s != levelset_sign(b(iv))) return true;
+        if (a(iv) == b(iv)) return false;
+        if (s == 0) return true;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            for (int d = -1; d <= 1; d += 2) {
+                IntVect nb = iv;
+                nb[idim] += d;
+                if (bx.contains(nb) && levelset_sign(a(nb)) != s) return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool
+sameCutCells (BaseFab<Real> const& a, BaseFab<Real> const& b)
+{
+    AMREX_ASSERT(a.box() == b.box());
+    const Box& bx = a.box();
+    auto const& aa = a.const_array();
+    auto const& ba = b.const_array();
+
+    if (Gpu::notInLaunchRegion())
+    {
+        bool same = true;
+        amrex::LoopOnCpu(bx, [=,&same] (int i, int j, int k) noexcept
+        {
+            if (levelset_node_changed(IntVect(AMREX_D_DECL(i,j,k)), bx, aa, ba)) same = false;
+        });
+        return same;
+    }
+    else
+    {
+        ReduceOps<ReduceOpMax> reduce_op;
+        ReduceData<int> reduce_data(reduce_op);
+        using ReduceTuple = typename decltype(reduce_data)::Type;
+        reduce_op.eval(bx, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+        {
+            return {static_cast<int>(levelset_node_changed(IntVect(AMREX_D_DECL(i,j,k)),
+                                                           bx, aa, ba))};
+        });
+        ReduceTuple rv = reduce_data.value();
+        return amrex::get<0>(rv) == 0;
+    }
+}
+
+void
+Level::clear ()
+{
+    m_grids = BoxArray();
+    m_covered_grids = BoxArray();
+    m_dmap = DistributionMapping();
+    m_mgf = MultiGFab();
+    m_levelset.clear();
+    m_cellflag.clear();
+    m_volfrac.clear();
+    m_centroid.clear();
+    m_bndryarea.clear();
+    m_bndrycent.clear();
+    m_bndrynorm.clear();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        m_areafrac[idim].clear();
+        m_facecent[idim].clear();
+    }
+    m_allregular = false;
+    m_ok = false;
+    m_coarsen_error = 0;
+}
+
 int
 Level::coarsenFromFine (Level& fineLevel, bool fill_boundary)
 {
@@ -88,7 +174,7 @@ Level::coarsenFromFine (Level& fineLevel, bool fill_boundary)
 
     if (! (fine_grids.coarsenable(2,2) &&
            (fine_covered_grids.empty() || fine_covered_grids.coarsenable(2,2)))) {
-        return 1;
+        return 2;
     }
 
     auto const& f_levelset = fineLevel.m_levelset;
@@ -871,4 +957,163 @@ Level::fillLevelSet (MultiFab& levelset, const Geometry& geom) const
     }
 }
         
+namespace {
+    // EBCellFlag is 32 bits, which single precision Real cannot hold, so it
+    // is stored as two 16-bit halves.
+    void copyCellFlagToMultiFab (MultiFab& dst, const FabArray<EBCellFlagFab>& src)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(dst); mfi.isValid(); ++mfi)
+        {
+            auto const& d = dst.array(mfi);
+            auto const& f = src.const_array(mfi);
+            const Box& box = mfi.fabbox();
+            AMREX_HOST_DEVICE_PARALLEL_FOR_3D (box, i, j, k,
+            {
+                const uint32_t v = f(i,j,k).getValue();
+                d(i,j,k,0) = static_cast<Real>(v & 0xFFFFu);
+                d(i,j,k,1) = static_cast<Real>(v >> 16);
+            });
+        }
+    }
+
+    void copyMultiFabToCellFlag (FabArray<EBCellFlagFab>& dst, const MultiFab& src)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(dst); mfi.isValid(); ++mfi)
+        {
+            auto const& f = dst.array(mfi);
+            auto const& s = src.const_array(mfi);
+            const Box& box = mfi.fabbox();
+            AMREX_HOST_DEVICE_PARALLEL_FOR_3D (box, i, j, k,
+            {
+                const uint32_t lo = static_cast<uint32_t>(s(i,j,k,0));
+                const uint32_t hi = static_cast<uint32_t>(s(i,j,k,1));
+                f(i,j,k) = EBCellFlag(lo | (hi << 16));
+            });
+        }
+    }
+
+    // Define mf on the layout of the level and read it.  The BoxArray on
+    // disk must match.
+    void readLevelMultiFab (MultiFab& mf, const std::string& name, const BoxArray& ba,
+                            const DistributionMapping& dm, int ncomp, int ngrow)
+    {
+        mf.define(ba, dm, ncomp, ngrow);
+        VisMF::Read(mf, name);
+    }
+}
+
+void
+Level::write (const std::string& dir) const
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        if (!amrex::UtilCreateDirectory(dir, 0755)) {
+            amrex::CreateDirectoryFailed(dir);
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    if (!m_allregular)
+    {
+        VisMF::Write(m_levelset,  dir + "/LevelSet");
+        VisMF::Write(m_volfrac,   dir + "/VolFrac");
+        VisMF::Write(m_centroid,  dir + "/Centroid");
+        VisMF::Write(m_bndryarea, dir + "/BndryArea");
+        VisMF::Write(m_bndrycent, dir + "/BndryCent");
+        VisMF::Write(m_bndrynorm, dir + "/BndryNorm");
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            VisMF::Write(m_areafrac[idim], dir + "/AreaFrac_" + std::to_string(idim));
+            VisMF::Write(m_facecent[idim], dir + "/FaceCent_" + std::to_string(idim));
+        }
+
+        MultiFab cellflag(m_grids, m_dmap, 2, m_cellflag.nGrow());
+        copyCellFlagToMultiFab(cellflag, m_cellflag);
+        VisMF::Write(cellflag, dir + "/CellFlag");
+    }
+
+    // The Header is written last, so that its presence means the level is complete.
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const std::string HeaderFileName = dir + "/Header";
+        std::ofstream HeaderFile(HeaderFileName.c_str());
+        if (!HeaderFile.good()) amrex::FileOpenFailed(HeaderFileName);
+        HeaderFile << m_allregular << '\n'
+                   << m_ngrow << '\n'
+                   << m_levelset.nGrow() << ' ' << m_volfrac.nGrow() << '\n';
+        HeaderFile << m_covered_grids.size() << '\n';
+        for (int i = 0, N = m_covered_grids.size(); i < N; ++i) {
+            HeaderFile << m_covered_grids[i] << '\n';
+        }
+        if (!HeaderFile.good()) {
+            amrex::Abort("EB2::Level::write: problem writing " + HeaderFileName);
+        }
+    }
+    ParallelDescriptor::Barrier();
+}
+
+void
+Level::read (const std::string& dir)
+{
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(dir + "/Header", fileCharPtr);
+    std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+
+    int ng_levelset, ng;
+    is >> m_allregular >> m_ngrow >> ng_levelset >> ng;
+    int ncovered;
+    is >> ncovered;
+    m_covered_grids = BoxArray();
+    if (ncovered > 0) {
+        BoxList bl;
+        for (int i = 0; i < ncovered; ++i) {
+            Box b;
+            is >> b;
+            bl.push_back(b);
+        }
+        m_covered_grids = BoxArray(std::move(bl));
+    }
+
+    m_ok = true;
+    if (m_allregular) return;
+
+    // The volume fraction brings the BoxArray, and a DistributionMapping
+    // for the current number of processes.
+    MultiFab volfrac;
+    VisMF::Read(volfrac, dir + "/VolFrac");
+    m_grids = volfrac.boxArray();
+    m_dmap = volfrac.DistributionMap();
+    m_volfrac = std::move(volfrac);
+
+    readLevelMultiFab(m_levelset, dir + "/LevelSet",
+                      amrex::convert(m_grids,IntVect::TheNodeVector()), m_dmap, 1, ng_levelset);
+    readLevelMultiFab(m_centroid,  dir + "/Centroid",  m_grids, m_dmap, AMREX_SPACEDIM, ng);
+    readLevelMultiFab(m_bndryarea, dir + "/BndryArea", m_grids, m_dmap, 1, ng);
+    readLevelMultiFab(m_bndrycent, dir + "/BndryCent", m_grids, m_dmap, AMREX_SPACEDIM, ng);
+    readLevelMultiFab(m_bndrynorm, dir + "/BndryNorm", m_grids, m_dmap, AMREX_SPACEDIM, ng);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const BoxArray& fba = amrex::convert(m_grids, IntVect::TheDimensionVector(idim));
+        readLevelMultiFab(m_areafrac[idim], dir + "/AreaFrac_" + std::to_string(idim),
+                          fba, m_dmap, 1, ng);
+        readLevelMultiFab(m_facecent[idim], dir + "/FaceCent_" + std::to_string(idim),
+                          fba, m_dmap, AMREX_SPACEDIM-1, ng);
+    }
+
+    MultiFab cellflag;
+    readLevelMultiFab(cellflag, dir + "/CellFlag", m_grids, m_dmap, 2, ng);
+    m_cellflag.define(m_grids, m_dmap, 1, ng);
+    copyMultiFabToCellFlag(m_cellflag, cellflag);
+}
+
+FileLevel::FileLevel (IndexSpace const* is, const Geometry& geom, const std::string& dir)
+    : Level(is, geom)
+{
+    BL_PROFILE("EB2::FileLevel()");
+    read(dir);
+}
+
 }}
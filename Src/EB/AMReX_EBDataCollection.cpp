@@ -2,11 +2,52 @@
 #include <AMReX_EBDataCollection.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_MultiCutFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_LayoutData.H>
 
 #include <AMReX_EB2_Level.H>
 
 namespace amrex {
 
+namespace {
+    // Copy the fabs of src, which are on the boxes of dst listed by
+    // sub_index, into dst.
+    template <class FAB>
+    void copyDirtyFabs (FabArray<FAB>& dst, const FabArray<FAB>& src, const Vector<int>& sub_index)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(dst); mfi.isValid(); ++mfi)
+        {
+            const int k = sub_index[mfi.index()];
+            if (k >= 0) {
+                dst[mfi].template copy<RunOn::Device>(src[k]);
+            }
+        }
+    }
+
+    void copyDirtyFabs (MultiCutFab& dst, const MultiFab& src, const Vector<int>& sub_index)
+    {
+        const int ncomp = dst.nComp();
+        for (MFIter mfi(dst.data()); mfi.isValid(); ++mfi)
+        {
+            const int k = sub_index[mfi.index()];
+            if (k >= 0) {
+                dst.remake(mfi);
+                if (dst.ok(mfi)) {
+                    auto const& d = dst.array(mfi);
+                    auto const& s = src.const_array(k);
+                    AMREX_HOST_DEVICE_PARALLEL_FOR_4D(mfi.fabbox(), ncomp, i, j, kk, n,
+                    {
+                        d(i,j,kk,n) = s(i,j,kk,n);
+                    });
+                }
+            }
+        }
+    }
+}
+
 EBDataCollection::EBDataCollection (const EB2::Level& a_level,
                                     const Geometry& a_geom,
                                     const BoxArray& a_ba_in,
@@ -14,11 +55,17 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
                                     const Vector<int>& a_ngrow, EBSupport a_support)
     : m_ngrow(a_ngrow),
       m_support(a_support),
-      m_geom(a_geom)
+      m_geom(a_geom),
+      m_update_count(a_level.updateCount())
 {
     // The BoxArray argument may not be cell-centered BoxArray.
     const BoxArray& a_ba = amrex::convert(a_ba_in, IntVect::TheZeroVector());
 
+    m_dirty = new LayoutData<int>(a_ba, a_dm);
+    for (MFIter mfi(*m_dirty); mfi.isValid(); ++mfi) {
+        (*m_dirty)[mfi] = 0;
+    }
+
     if (m_support >= EBSupport::basic)
     {
         m_cellflags = new FabArray<EBCellFlagFab>(a_ba, a_dm, 1, m_ngrow[0], MFInfo(),
@@ -26,6 +73,27 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
         a_level.fillEBCellFlag(*m_cellflags, m_geom);
     }
 
+    bool sparse = false;
+    if (m_support >= EBSupport::volume)
+    {
+        ParmParse pp("eb2");
+        pp.query("sparse_cut_data", sparse);
+        if (sparse) {
+            m_cutindex = std::make_shared<CutCellIndex>(*m_cellflags);
+        }
+    }
+
+    // Pack one field at a time so that at most one dense copy is alive.
+    auto pack = [&] (MultiCutFab*& dense, MultiSparseCutFab*& packed, Real fill)
+    {
+        if (sparse) {
+            packed = new MultiSparseCutFab(m_cutindex, *dense, fill);
+            delete dense;
+            dense = nullptr;
+        }
+    };
+
+    // The fill values are what EB2::Level stores for regular and covered cells.
     if (m_support >= EBSupport::volume)
     {
         m_volfrac = new MultiFab(a_ba, a_dm, 1, m_ngrow[1], MFInfo(), FArrayBoxFactory());
@@ -33,6 +101,7 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
 
         m_centroid = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, m_ngrow[1], *m_cellflags);
         a_level.fillCentroid(*m_centroid, m_geom);
+        pack(m_centroid, m_sparse_centroid, 0.0);
     }
 
     if (m_support == EBSupport::full)
@@ -41,12 +110,18 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
 
         m_bndrycent = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, ng, *m_cellflags);
         a_level.fillBndryCent(*m_bndrycent, m_geom);
+        pack(m_bndrycent, m_sparse_bndrycent, -1.0);
 
         m_bndryarea = new MultiCutFab(a_ba, a_dm, 1, ng, *m_cellflags);
         a_level.fillBndryArea(*m_bndryarea, m_geom);
+        pack(m_bndryarea, m_sparse_bndryarea, 0.0);
 
         m_bndrynorm = new MultiCutFab(a_ba, a_dm, AMREX_SPACEDIM, ng, *m_cellflags);
         a_level.fillBndryNorm(*m_bndrynorm, m_geom);
+        pack(m_bndrynorm, m_sparse_bndrynorm, 0.0);
+
+        // The face data stay dense.  Their values for faces that are not
+        // cut depend on the neighboring cells, not only on the cell flag.
 
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
             const BoxArray& faceba = amrex::convert(a_ba, IntVect::TheDimensionVector(idim));
@@ -61,18 +136,166 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
 
 EBDataCollection::~EBDataCollection ()
 {
+    delete m_dirty;
     delete m_cellflags;
     delete m_volfrac;
     delete m_centroid;
     delete m_bndrycent;
     delete m_bndrynorm;
     delete m_bndryarea;
+    delete m_sparse_centroid;
+    delete m_sparse_bndrycent;
+    delete m_sparse_bndryarea;
+    delete m_sparse_bndrynorm;
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         delete m_areafrac[idim];
         delete m_facecent[idim];
     }
 }
 
+void
+EBDataCollection::update (const EB2::Level& a_level)
+{
+    const int nupdates = a_level.updateCount() - m_update_count;
+    if (nupdates == 0) return;
+
+    BL_PROFILE("EBDataCollection::update()");
+
+    m_update_count = a_level.updateCount();
+
+    const BoxArray& ba = m_dirty->boxArray();
+    const DistributionMapping& dm = m_dirty->DistributionMap();
+    const BoxArray& dirty_grids = a_level.dirtyGrids();
+
+    // The face data extend one more cell.
+    const int ngrow = *std::max_element(m_ngrow.begin(), m_ngrow.end()) + 1;
+    const std::vector<IntVect>& pshifts = m_geom.periodicity().shiftIntVect();
+
+    BoxList bl;
+    Vector<int> procs;
+    Vector<int> sub_index(ba.size(), -1);
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        bool dirty = (nupdates > 1);
+        const Box& gbx = amrex::grow(ba[i], ngrow);
+        for (const auto& iv : pshifts) {
+            if (dirty) break;
+            dirty = dirty_grids.intersects(gbx+iv);
+        }
+        if (dirty) {
+            sub_index[i] = bl.size();
+            bl.push_back(ba[i]);
+            procs.push_back(dm[i]);
+        }
+    }
+
+    for (MFIter mfi(*m_dirty); mfi.isValid(); ++mfi) {
+        (*m_dirty)[mfi] = (sub_index[mfi.index()] >= 0);
+    }
+
+    if (bl.isEmpty() || m_support == EBSupport::none) return;
+
+    // The new data of the dirty boxes are built on the same processes.
+    const BoxArray sub_ba(std::move(bl));
+    const DistributionMapping sub_dm(std::move(procs));
+
+    {
+        FabArray<EBCellFlagFab> cellflags(sub_ba, sub_dm, 1, m_cellflags->nGrow(), MFInfo(),
+                                          DefaultFabFactory<EBCellFlagFab>());
+        a_level.fillEBCellFlag(cellflags, m_geom);
+        copyDirtyFabs(*m_cellflags, cellflags, sub_index);
+        for (MFIter mfi(*m_cellflags); mfi.isValid(); ++mfi) {
+            const int k = sub_index[mfi.index()];
+            if (k >= 0) {
+                (*m_cellflags)[mfi].setType(cellflags[k].getType());
+            }
+        }
+    }
+
+    if (m_support >= EBSupport::volume)
+    {
+        MultiFab volfrac(sub_ba, sub_dm, 1, m_volfrac->nGrow());
+        a_level.fillVolFrac(volfrac, m_geom);
+        copyDirtyFabs(*m_volfrac, volfrac, sub_index);
+    }
+
+    if (hasSparseCutData())
+    {
+        // The packed data of all the boxes move when the number of cut
+        // cells of a box changes.
+        m_cutindex = std::make_shared<CutCellIndex>(*m_cellflags);
+
+        auto repack = [&] (MultiSparseCutFab*& packed, Real fill, int ncomp, int ng,
+                           void (EB2::Level::*fillfn)(MultiCutFab&, const Geometry&) const)
+        {
+            MultiCutFab tmp(m_dirty->boxArray(), m_dirty->DistributionMap(),
+                            ncomp, ng, *m_cellflags);
+            (a_level.*fillfn)(tmp, m_geom);
+            delete packed;
+            packed = new MultiSparseCutFab(m_cutindex, tmp, fill);
+        };
+
+        repack(m_sparse_centroid, 0.0, AMREX_SPACEDIM, m_ngrow[1],
+               &EB2::Level::fillCentroid);
+        if (m_support == EBSupport::full)
+        {
+            const int ng = m_ngrow[2];
+            repack(m_sparse_bndrycent, -1.0, AMREX_SPACEDIM, ng,
+                   &EB2::Level::fillBndryCent);
+            repack(m_sparse_bndryarea, 0.0, 1, ng, &EB2::Level::fillBndryArea);
+            repack(m_sparse_bndrynorm, 0.0, AMREX_SPACEDIM, ng,
+                   &EB2::Level::fillBndryNorm);
+        }
+    }
+    else if (m_support >= EBSupport::volume)
+    {
+        MultiFab centroid(sub_ba, sub_dm, AMREX_SPACEDIM, m_centroid->nGrow());
+        a_level.fillCentroid(centroid, m_geom);
+        copyDirtyFabs(*m_centroid, centroid, sub_index);
+
+        if (m_support == EBSupport::full)
+        {
+            const int ng = m_ngrow[2];
+
+            MultiFab bndrycent(sub_ba, sub_dm, AMREX_SPACEDIM, ng);
+            a_level.fillBndryCent(bndrycent, m_geom);
+            copyDirtyFabs(*m_bndrycent, bndrycent, sub_index);
+
+            MultiFab bndryarea(sub_ba, sub_dm, 1, ng);
+            a_level.fillBndryArea(bndryarea, m_geom);
+            copyDirtyFabs(*m_bndryarea, bndryarea, sub_index);
+
+            MultiFab bndrynorm(sub_ba, sub_dm, AMREX_SPACEDIM, ng);
+            a_level.fillBndryNorm(bndrynorm, m_geom);
+            copyDirtyFabs(*m_bndrynorm, bndrynorm, sub_index);
+        }
+    }
+
+    if (m_support == EBSupport::full)
+    {
+        const int ng = m_ngrow[2];
+        Array<MultiFab,AMREX_SPACEDIM> areafrac;
+        Array<MultiFab,AMREX_SPACEDIM> facecent;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const BoxArray& faceba = amrex::convert(sub_ba, IntVect::TheDimensionVector(idim));
+            areafrac[idim].define(faceba, sub_dm, 1, ng);
+            facecent[idim].define(faceba, sub_dm, AMREX_SPACEDIM-1, ng);
+        }
+        a_level.fillAreaFrac(amrex::GetArrOfPtrs(areafrac), m_geom);
+        a_level.fillFaceCent(amrex::GetArrOfPtrs(facecent), m_geom);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            copyDirtyFabs(*m_areafrac[idim], areafrac[idim], sub_index);
+            copyDirtyFabs(*m_facecent[idim], facecent[idim], sub_index);
+        }
+    }
+}
+
+const LayoutData<int>&
+EBDataCollection::getDirtyBoxes () const
+{
+    return *m_dirty;
+}
+
 const FabArray<EBCellFlagFab>&
 EBDataCollection::getMultiEBCellFlagFab () const
 {
@@ -90,22 +313,19 @@ EBDataCollection::getVolFrac () const
 const MultiCutFab&
 EBDataCollection::getCentroid () const
 {
-    AMREX_ASSERT(m_centroid != nullptr);
-    return *m_centroid;
+    return getDense(m_centroid, "getCentroid");
 }
 
 const MultiCutFab&
 EBDataCollection::getBndryCent () const
 {
-    AMREX_ASSERT(m_bndrycent != nullptr);
-    return *m_bndrycent;
+    return getDense(m_bndrycent, "getBndryCent");
 }
 
 const MultiCutFab&
 EBDataCollection::getBndryArea () const
 {
-    AMREX_ASSERT(m_bndryarea != nullptr);
-    return *m_bndryarea;
+    return getDense(m_bndryarea, "getBndryArea");
 }
 
 Array<const MultiCutFab*, AMREX_SPACEDIM>
@@ -125,8 +345,46 @@ EBDataCollection::getFaceCent () const
 const MultiCutFab&
 EBDataCollection::getBndryNormal () const
 {
-    AMREX_ASSERT(m_bndrynorm != nullptr);
-    return *m_bndrynorm;
+    return getDense(m_bndrynorm, "getBndryNormal");
+}
+
+const MultiCutFab&
+EBDataCollection::getDense (const MultiCutFab* dense, const char* name) const
+{
+    if (dense == nullptr && hasSparseCutData()) {
+        amrex::Abort(std::string("EBDataCollection::") + name
+                     + ": this code needs the dense cut cell data, which eb2.sparse_cut_data = 1 does not keep");
+    }
+    AMREX_ASSERT(dense != nullptr);
+    return *dense;
+}
+
+EBCutData
+EBDataCollection::getCentroidData () const
+{
+    AMREX_ASSERT(m_centroid != nullptr || m_sparse_centroid != nullptr);
+    return EBCutData(m_centroid, m_sparse_centroid);
+}
+
+EBCutData
+EBDataCollection::getBndryCentData () const
+{
+    AMREX_ASSERT(m_bndrycent != nullptr || m_sparse_bndrycent != nullptr);
+    return EBCutData(m_bndrycent, m_sparse_bndrycent);
+}
+
+EBCutData
+EBDataCollection::getBndryAreaData () const
+{
+    AMREX_ASSERT(m_bndryarea != nullptr || m_sparse_bndryarea != nullptr);
+    return EBCutData(m_bndryarea, m_sparse_bndryarea);
+}
+
+EBCutData
+EBDataCollection::getBndryNormalData () const
+{
+    AMREX_ASSERT(m_bndrynorm != nullptr || m_sparse_bndrynorm != nullptr);
+    return EBCutData(m_bndrynorm, m_sparse_bndrynorm);
 }
 
 }
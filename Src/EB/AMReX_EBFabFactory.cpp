@@ -4,6 +4,7 @@
 #include <AMReX_EBFArrayBox.H>
 #include <AMReX_EBCellFlag.H>
 #include <AMReX_FabArray.H>
+#include <AMReX_MultiCutFab.H>
 
 #include <AMReX_EB2_Level.H>
 #include <AMReX_EB2.H>
@@ -77,6 +78,30 @@ EBFArrayBoxFactory::isAllRegular () const noexcept
     return m_parent->isAllRegular();
 }
 
+EBCutData
+EBFArrayBoxFactory::getCentroidData () const noexcept
+{
+    return m_ebdc->getCentroidData();
+}
+
+EBCutData
+EBFArrayBoxFactory::getBndryCentData () const noexcept
+{
+    return m_ebdc->getBndryCentData();
+}
+
+EBCutData
+EBFArrayBoxFactory::getBndryNormalData () const noexcept
+{
+    return m_ebdc->getBndryNormalData();
+}
+
+EBCutData
+EBFArrayBoxFactory::getBndryAreaData () const noexcept
+{
+    return m_ebdc->getBndryAreaData();
+}
+
 EB2::IndexSpace const*
 EBFArrayBoxFactory::getEBIndexSpace () const noexcept
 {
@@ -208,6 +208,24 @@ EBFluxRegister::FineAdd (const MFIter& mfi,
         }
     }
 
+    FineAddDM(mfi, volfrac, dm, runon);
+}
+
+
+void
+EBFluxRegister::FineAddDM (const MFIter& mfi, const FArrayBox& volfrac, const FArrayBox& dm,
+                           RunOn runon)
+{
+    const int li = mfi.LocalIndex();
+    Vector<FArrayBox*>& cfp_fabs = m_cfp_fab[li];
+    if (cfp_fabs.empty()) return;
+
+    const int nc = m_cfpatch.nComp();
+    const Box& tbx = mfi.tilebox();
+    const Box& cbx = amrex::coarsen(tbx, m_ratio);
+    Array4<Real const> const& vfrac = volfrac.const_array();
+    Dim3 ratio = m_ratio.dim3();
+
     Real threshold = amrex_eb_get_reredistribution_threshold()*(AMREX_D_TERM(ratio.x,*ratio.y,*ratio.z));
     const Box& tbxg1 = amrex::grow(tbx,1);
     const Box& cbxg1 = amrex::grow(cbx,1);
@@ -637,7 +637,7 @@ void EB_average_down_boundaries (const MultiFab& fine, MultiFab& crse,
 
         const auto& factory = dynamic_cast<EBFArrayBoxFactory const&>(fine.Factory());
         const auto& flags = factory.getMultiEBCellFlagFab();
-        const auto& barea = factory.getBndryArea();
+        const EBCutData barea = factory.getBndryAreaData();
 
         if (isMFIterSafe(fine, crse))
         {
@@ -658,7 +658,7 @@ void EB_average_down_boundaries (const MultiFab& fine, MultiFab& crse,
                     });
                 } else {
                     Array4<Real const> const& fa = fine.const_array(mfi);
-                    Array4<Real const> const& ba = barea.const_array(mfi);
+                    CutArray4<Real> const& ba = barea.const_array(mfi);
                     AMREX_HOST_DEVICE_FOR_3D(tbx,i,j,k,
                     {
                         eb_avgdown_boundaries(i,j,k,fa,0,ca,0,ba,dratio,ncomp);
@@ -0,0 +1,412 @@
+#include <AMReX_EBRedistribution.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBFluxRegister.H>
+#include <AMReX_iMultiFab.H>
+
+namespace amrex {
+
+#if (AMREX_SPACEDIM > 1)
+
+namespace {
+    // The values of the level mask of the ghost cells
+    constexpr int lmask_interior    = 0;
+    constexpr int lmask_covered     = 1;
+    constexpr int lmask_notcovered  = 2;
+    constexpr int lmask_physbnd     = 3;
+
+    template <typename T>
+    void copyToDevice (Vector<T> const& h, Gpu::DeviceVector<T>& d)
+    {
+        d.resize(h.size());
+        Gpu::copy(Gpu::hostToDevice, h.begin(), h.end(), d.begin());
+    }
+}
+
+EBRedistributor::EBRedistributor (const EBFArrayBoxFactory& factory, const MultiFab* weights)
+{
+    define(factory, weights);
+}
+
+void
+EBRedistributor::define (const EBFArrayBoxFactory& factory, const MultiFab* weights)
+{
+    BL_PROFILE("EBRedistributor::define()");
+
+    m_factory = &factory;
+    m_plan.reset(new LayoutData<Plan>(factory.boxArray(), factory.DistributionMap()));
+    makePlans(weights, nullptr);
+}
+
+void
+EBRedistributor::update (const MultiFab* weights)
+{
+    BL_PROFILE("EBRedistributor::update()");
+    AMREX_ASSERT(isDefined());
+    makePlans(weights, &(m_factory->getDirtyBoxes()));
+}
+
+void
+EBRedistributor::makePlans (const MultiFab* weights, const LayoutData<int>* dirty)
+{
+    const EBFArrayBoxFactory& factory = *m_factory;
+    const BoxArray& ba = factory.boxArray();
+    const DistributionMapping& dm = factory.DistributionMap();
+    const Geometry& geom = factory.Geom();
+    const auto& flags = factory.getMultiEBCellFlagFab();
+    const MultiFab& volfrac = factory.getVolFrac();
+
+    AMREX_ALWAYS_ASSERT(flags.nGrow() >= 2 && volfrac.nGrow() >= 2);
+    AMREX_ALWAYS_ASSERT(weights == nullptr || weights->nGrow() >= 2);
+
+    const Box dbox = geom.growPeriodicDomain(2);
+
+    // Ghost cells not covered by other boxes of the level
+    iMultiFab lmask(ba, dm, 1, 1);
+    lmask.BuildMask(geom.Domain(), geom.periodicity(),
+                    lmask_covered, lmask_notcovered, lmask_physbnd, lmask_interior);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(lmask, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+    {
+        if (dirty != nullptr && (*dirty)[mfi] == 0) continue;
+
+        Plan& plan = (*m_plan)[mfi];
+        plan = Plan();
+
+        const Box& bx = mfi.validbox();
+        const Box& gbx = amrex::grow(bx,1);
+        const auto& flagfab = flags[mfi];
+        if (flagfab.getType(gbx) == FabType::regular ||
+            flagfab.getType(bx)  == FabType::covered) {
+            continue;
+        }
+
+        auto const& flag = flagfab.const_array();
+        auto const& vfrac = volfrac.const_array(mfi);
+        auto const& lm = lmask.const_array(mfi);
+        Array4<Real const> wt;
+        if (weights) wt = weights->const_array(mfi);
+
+        Vector<IntVect> src_cells;
+        Vector<Real> src_vfrac, src_mask;
+        Vector<int> src_ghost;
+        Vector<int> nbr_offset(1,0);
+        Vector<IntVect> nbr_cells;
+        Vector<Real> nbr_avgwt, nbr_diswt;
+
+        // Index of the cell in the sources, or -1
+        BaseFab<int> src_index(gbx, 1);
+        src_index.setVal<RunOn::Host>(-1);
+        auto const& sidx = src_index.array();
+
+        IntVect nbrs[AMREX_D_TERM(3,*3,*3)];
+        amrex::LoopOnCpu(gbx, [&] (int i, int j, int k) noexcept
+        {
+            if (!flag(i,j,k).isSingleValued()) return;
+
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            int nnbrs = 0;
+            bool reaches_box = bx.contains(iv);
+            Real vtot = 0.0;
+#if (AMREX_SPACEDIM == 3)
+            for (int kk = -1; kk <= 1; ++kk)
+#else
+            const int kk = 0;
+#endif
+            for (int jj = -1; jj <= 1; ++jj) {
+            for (int ii = -1; ii <= 1; ++ii) {
+                const IntVect nb(AMREX_D_DECL(i+ii,j+jj,k+kk));
+                if ((ii != 0 || jj != 0 || kk != 0) &&
+                    flag(i,j,k).isConnected(ii,jj,kk) && dbox.contains(nb))
+                {
+                    nbrs[nnbrs++] = nb;
+                    vtot += vfrac(nb) * ((wt) ? wt(nb) : 1.0);
+                    reaches_box = reaches_box || bx.contains(nb);
+                }
+            }}
+            if (!reaches_box) return;
+
+            sidx(iv) = src_cells.size();
+            src_cells.push_back(iv);
+            src_vfrac.push_back(vfrac(iv));
+            src_mask.push_back(dbox.contains(iv) ? 1.0 : 0.0);
+            src_ghost.push_back((lm.contains(i,j,k) && lm(iv) == lmask_notcovered) ? 1 : 0);
+
+            const Real vinv = 1.0/(vtot + 1.e-80);
+            for (int m = 0; m < nnbrs; ++m) {
+                const IntVect& nb = nbrs[m];
+                const Real w = (wt) ? wt(nb) : 1.0;
+                nbr_cells.push_back(nb);
+                nbr_avgwt.push_back(vfrac(nb)*w*vinv);
+                nbr_diswt.push_back(w*vinv);
+            }
+            nbr_offset.push_back(nbr_cells.size());
+        });
+
+        // Transpose the neighbor lists.  The incoming of a ghost cell are
+        // only needed from the sources in the box.
+        const int nsrc = src_cells.size();
+        Vector<Vector<std::pair<int,Real> > > incoming;
+        BaseFab<int> in_index(gbx, 1);
+        in_index.setVal<RunOn::Host>(-1);
+        auto const& iidx = in_index.array();
+        for (int s = 0; s < nsrc; ++s) {
+            const bool valid_src = bx.contains(src_cells[s]);
+            for (int m = nbr_offset[s]; m < nbr_offset[s+1]; ++m) {
+                const IntVect& nb = nbr_cells[m];
+                if (!gbx.contains(nb) || !(valid_src || bx.contains(nb))) continue;
+                if (iidx(nb) < 0) {
+                    iidx(nb) = incoming.size();
+                    incoming.emplace_back();
+                }
+                incoming[iidx(nb)].emplace_back(s, nbr_diswt[m]);
+            }
+        }
+
+        Vector<IntVect> dst_cells;
+        Vector<int> dst_self;
+        Vector<int> in_offset(1,0);
+        Vector<int> in_src;
+        Vector<Real> in_diswt;
+        for (int pass = 0; pass < 2; ++pass) {
+            amrex::LoopOnCpu(gbx, [&] (int i, int j, int k) noexcept
+            {
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                if (bx.contains(iv) != (pass == 0)) return;
+                if (sidx(iv) < 0 && iidx(iv) < 0) return;
+                dst_cells.push_back(iv);
+                dst_self.push_back(sidx(iv));
+                if (iidx(iv) >= 0) {
+                    for (auto const& p : incoming[iidx(iv)]) {
+                        in_src.push_back(p.first);
+                        in_diswt.push_back(p.second);
+                    }
+                }
+                in_offset.push_back(in_src.size());
+            });
+            if (pass == 0) plan.num_valid_dst = dst_cells.size();
+        }
+
+        copyToDevice(src_cells, plan.src_cells);
+        copyToDevice(src_vfrac, plan.src_vfrac);
+        copyToDevice(src_mask, plan.src_mask);
+        copyToDevice(src_ghost, plan.src_ghost);
+        copyToDevice(nbr_offset, plan.nbr_offset);
+        copyToDevice(nbr_cells, plan.nbr_cells);
+        copyToDevice(nbr_avgwt, plan.nbr_avgwt);
+        copyToDevice(nbr_diswt, plan.nbr_diswt);
+        copyToDevice(dst_cells, plan.dst_cells);
+        copyToDevice(dst_self, plan.dst_self);
+        copyToDevice(in_offset, plan.in_offset);
+        copyToDevice(in_src, plan.in_src);
+        copyToDevice(in_diswt, plan.in_diswt);
+    }
+}
+
+Long
+EBRedistributor::numLocalSources () const noexcept
+{
+    Long r = 0;
+    if (m_plan) {
+        for (MFIter mfi(*m_plan); mfi.isValid(); ++mfi) {
+            r += (*m_plan)[mfi].src_cells.size();
+        }
+    }
+    return r;
+}
+
+void
+EBRedistributor::apply (MultiFab& div_out, int div_comp, const MultiFab& divc, int divc_comp,
+                        int ncomp) const
+{
+    apply(div_out, div_comp, divc, divc_comp, ncomp, 0.0, nullptr, nullptr);
+}
+
+void
+EBRedistributor::apply (MultiFab& div_out, int div_comp, const MultiFab& divc, int divc_comp,
+                        int ncomp, Real dt, EBFluxRegister* fr_as_crse, EBFluxRegister* fr_as_fine) const
+{
+    BL_PROFILE("EBRedistributor::apply()");
+
+    AMREX_ASSERT(isDefined());
+    AMREX_ASSERT(div_out.boxArray() == m_factory->boxArray() &&
+                 div_out.DistributionMap() == m_factory->DistributionMap());
+    AMREX_ASSERT(divc.nGrow() >= 2);
+
+    const MultiFab& volfrac = m_factory->getVolFrac();
+    const Real threshold = amrex_eb_get_reredistribution_threshold();
+    const RunOn runon = Gpu::inLaunchRegion() ? RunOn::Gpu : RunOn::Cpu;
+    constexpr int crse_fine_boundary_cell = YAFluxRegister::crse_fine_boundary_cell;
+    constexpr int covered_by_fine = YAFluxRegister::fine_cell;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    {
+        FArrayBox dm_as_fine;
+        Gpu::DeviceVector<Real> optmp_v, delm_v;
+        for (MFIter mfi(div_out, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<Real> const& out = div_out.array(mfi, div_comp);
+            Array4<Real const> const& in = divc.const_array(mfi, divc_comp);
+
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                out(i,j,k,n) = in(i,j,k,n);
+            });
+
+            const Plan& plan = (*m_plan)[mfi];
+            const int nsrc = plan.src_cells.size();
+            if (nsrc == 0) continue;
+
+            IntVect const* src_cells = plan.src_cells.data();
+            Real const* src_vfrac = plan.src_vfrac.data();
+            Real const* src_mask = plan.src_mask.data();
+            int const* src_ghost = plan.src_ghost.data();
+            int const* nbr_offset = plan.nbr_offset.data();
+            IntVect const* nbr_cells = plan.nbr_cells.data();
+            Real const* nbr_avgwt = plan.nbr_avgwt.data();
+            Real const* nbr_diswt = plan.nbr_diswt.data();
+            IntVect const* dst_cells = plan.dst_cells.data();
+            int const* dst_self = plan.dst_self.data();
+            int const* in_offset = plan.in_offset.data();
+            int const* in_src = plan.in_src.data();
+            Real const* in_diswt = plan.in_diswt.data();
+            const int nvdst = plan.num_valid_dst;
+            const int ndst = plan.dst_cells.size();
+
+            optmp_v.resize(nsrc*ncomp);
+            delm_v.resize(nsrc*ncomp);
+            Real* optmp = optmp_v.data();
+            Real* delm = delm_v.data();
+
+            // The hybrid divergence and the excess mass of the sources
+            AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( nsrc, s,
+            {
+                const IntVect& iv = src_cells[s];
+                for (int n = 0; n < ncomp; ++n) {
+                    Real divnc = 0.0;
+                    for (int m = nbr_offset[s]; m < nbr_offset[s+1]; ++m) {
+                        divnc += nbr_avgwt[m] * in(nbr_cells[m],n);
+                    }
+                    const Real op = (1.0-src_vfrac[s]) * (divnc - in(iv,n)*src_mask[s]);
+                    optmp[s*ncomp+n] = op;
+                    delm[s*ncomp+n] = -src_vfrac[s] * op;
+                }
+            });
+
+            // Gather the excess mass of the neighborhoods
+            AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( nvdst, d,
+            {
+                const IntVect& iv = dst_cells[d];
+                const int self = dst_self[d];
+                for (int n = 0; n < ncomp; ++n) {
+                    Real r = in(iv,n);
+                    if (self >= 0) r += optmp[self*ncomp+n];
+                    for (int m = in_offset[d]; m < in_offset[d+1]; ++m) {
+                        r += delm[in_src[m]*ncomp+n] * in_diswt[m];
+                    }
+                    out(iv,n) = r;
+                }
+            });
+
+            Array4<Real const> const& vfrac = volfrac.const_array(mfi);
+
+            if (fr_as_crse && fr_as_crse->CrseHasWork(mfi))
+            {
+                Array4<Real> const& rr_drho = fr_as_crse->getCrseData(mfi)->array();
+                Array4<int const> const& rr_flag = fr_as_crse->getCrseFlag(mfi)->const_array();
+
+                // Loss of the coarse/fine boundary cells to the covered cells
+                AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( nsrc, s,
+                {
+                    const IntVect& iv = src_cells[s];
+                    if (bx.contains(iv) && rr_flag(iv) == crse_fine_boundary_cell
+                        && src_vfrac[s] > threshold)
+                    {
+                        for (int n = 0; n < ncomp; ++n) {
+                            Real loss = 0.0;
+                            for (int m = nbr_offset[s]; m < nbr_offset[s+1]; ++m) {
+                                const IntVect& nb = nbr_cells[m];
+                                if (rr_flag(nb) == covered_by_fine) {
+                                    loss += delm[s*ncomp+n] * nbr_diswt[m] * vfrac(nb);
+                                }
+                            }
+                            rr_drho(iv,n) += dt * loss / src_vfrac[s];
+                        }
+                    }
+                });
+
+                // Gain of the coarse/fine boundary cells from the covered cells
+                AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( nvdst, d,
+                {
+                    const IntVect& iv = dst_cells[d];
+                    if (rr_flag(iv) == crse_fine_boundary_cell && vfrac(iv) > threshold)
+                    {
+                        for (int n = 0; n < ncomp; ++n) {
+                            Real gain = 0.0;
+                            for (int m = in_offset[d]; m < in_offset[d+1]; ++m) {
+                                const int s = in_src[m];
+                                if (rr_flag(src_cells[s]) == covered_by_fine) {
+                                    gain += delm[s*ncomp+n] * in_diswt[m];
+                                }
+                            }
+                            rr_drho(iv,n) -= dt * gain;
+                        }
+                    }
+                });
+            }
+
+            if (fr_as_fine && fr_as_fine->FineHasWork(mfi))
+            {
+                dm_as_fine.resize(amrex::grow(bx,1), ncomp);
+                Elixir dmeli = dm_as_fine.elixir();
+                Array4<Real> const& dmf = dm_as_fine.array();
+                dm_as_fine.setVal<RunOn::Device>(0.0);
+
+                // Gain of the ghost cells from the valid cells
+                AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( ndst-nvdst, dg,
+                {
+                    const int d = dg + nvdst;
+                    const IntVect& iv = dst_cells[d];
+                    for (int n = 0; n < ncomp; ++n) {
+                        Real gain = 0.0;
+                        for (int m = in_offset[d]; m < in_offset[d+1]; ++m) {
+                            gain += delm[in_src[m]*ncomp+n] * in_diswt[m];
+                        }
+                        dmf(iv,n) += dt * gain * vfrac(iv);
+                    }
+                });
+
+                // Loss of the ghost cells not covered by other boxes to the valid cells
+                AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( nsrc, s,
+                {
+                    if (src_ghost[s]) {
+                        const IntVect& iv = src_cells[s];
+                        for (int n = 0; n < ncomp; ++n) {
+                            Real loss = 0.0;
+                            for (int m = nbr_offset[s]; m < nbr_offset[s+1]; ++m) {
+                                const IntVect& nb = nbr_cells[m];
+                                if (bx.contains(nb)) {
+                                    loss += delm[s*ncomp+n] * nbr_diswt[m] * vfrac(nb);
+                                }
+                            }
+                            dmf(iv,n) -= dt * loss;
+                        }
+                    }
+                });
+
+                fr_as_fine->FineAddDM(mfi, volfrac[mfi], dm_as_fine, runon);
+            }
+
+            Gpu::streamSynchronize();
+        }
+    }
+}
+
+#endif
+
+}
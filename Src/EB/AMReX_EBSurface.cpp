@@ -0,0 +1,571 @@
+#include <AMReX_EBSurface.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBCellFlag.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace amrex {
+
+namespace {
+
+bool isLittleEndian () noexcept
+{
+    const int one = 1;
+    char c;
+    std::memcpy(&c, &one, 1);
+    return c == 1;
+}
+
+#if (AMREX_SPACEDIM == 3)
+
+// An edge is numbered by its direction and its lower node.
+struct EdgeIndexer
+{
+    explicit EdgeIndexer (const Box& domain) noexcept
+        : lo(domain.smallEnd() - 2)
+    {
+        const IntVect len = domain.length() + 5;
+        nx = len[0];
+        ny = len[1];
+    }
+
+    Long key (int dir, IntVect const& node) const noexcept {
+        return dir + 3*((node[0]-lo[0]) + nx*((node[1]-lo[1]) + ny*static_cast<Long>(node[2]-lo[2])));
+    }
+
+    void decode (Long key, int& dir, IntVect& node) const noexcept {
+        dir = key % 3;
+        key /= 3;
+        node[0] = lo[0] + static_cast<int>(key % nx);
+        key /= nx;
+        node[1] = lo[1] + static_cast<int>(key % ny);
+        node[2] = lo[2] + static_cast<int>(key / ny);
+    }
+
+    IntVect lo;
+    Long nx, ny;
+};
+
+struct CutPolygon
+{
+    int n = 0;
+    Long keys[6];
+    Real pts[6][3];
+};
+
+// Intersect the cell iv with the plane through c normal to n, and order
+// the points counterclockwise around n.  Like amrex_eb_to_polygon, the
+// plane is shifted a little along n if it does not give a polygon.
+bool cutCellPolygon (IntVect const& iv, const Real* n, const Real* c,
+                     const Real* dx, const Real* problo, EdgeIndexer const& ei,
+                     CutPolygon& poly)
+{
+    const Real tol = 0.01*std::min(std::min(dx[0],dx[1]),dx[2]);
+    const Real shifts[3] = {0.0, tol, -tol};
+    bool found = false;
+    for (int is = 0; is < 3 && !found; ++is)
+    {
+        const Real p[3] = {c[0]+shifts[is]*n[0], c[1]+shifts[is]*n[1], c[2]+shifts[is]*n[2]};
+        poly.n = 0;
+        bool too_many = false;
+        for (int dir = 0; dir < 3 && !too_many; ++dir)
+        {
+            if (std::abs(n[dir]) <= std::numeric_limits<Real>::epsilon()) continue;
+            const int d1 = (dir+1)%3;
+            const int d2 = (dir+2)%3;
+            for (int e = 0; e < 4; ++e)
+            {
+                IntVect node = iv;
+                node[d1] += e%2;
+                node[d2] += e/2;
+                Real v[3];
+                for (int d = 0; d < 3; ++d) {
+                    v[d] = problo[d] + node[d]*dx[d];
+                }
+                const Real alpha = ((p[0]-v[0])*n[0] + (p[1]-v[1])*n[1] + (p[2]-v[2])*n[2])
+                    / (n[dir]*dx[dir]);
+                if (alpha > 0.0 && alpha < 1.0) {
+                    if (poly.n == 6) {
+                        too_many = true;
+                        break;
+                    }
+                    poly.keys[poly.n] = ei.key(dir,node);
+                    for (int d = 0; d < 3; ++d) {
+                        poly.pts[poly.n][d] = v[d];
+                    }
+                    poly.pts[poly.n][dir] += alpha*dx[dir];
+                    ++poly.n;
+                }
+            }
+        }
+        found = !too_many && poly.n >= 3;
+    }
+
+    if (!found) {
+        poly.n = 0;
+        return false;
+    }
+
+    int l = 0;
+    for (int d = 1; d < 3; ++d) {
+        if (std::abs(n[d]) > std::abs(n[l])) l = d;
+    }
+    const int a = (l+1)%3;
+    const int b = (l+2)%3;
+    Real ca = 0.0, cb = 0.0;
+    for (int m = 0; m < poly.n; ++m) {
+        ca += poly.pts[m][a];
+        cb += poly.pts[m][b];
+    }
+    ca /= poly.n;
+    cb /= poly.n;
+    AMREX_ASSERT(poly.n <= 6);
+    Real angle[6];
+    int order[6];
+    for (int m = 0; m < poly.n; ++m) {
+        angle[m] = std::atan2(poly.pts[m][b]-cb, poly.pts[m][a]-ca);
+        order[m] = m;
+    }
+    // Insertion sort of at most six vertices by angle.
+    for (int m = 1; m < poly.n; ++m) {
+        const int x = order[m];
+        int k = m;
+        for (; k > 0 && angle[order[k-1]] > angle[x]; --k) {
+            order[k] = order[k-1];
+        }
+        order[k] = x;
+    }
+    if (n[l] < 0.0) {
+        for (int lo = 0, hi = poly.n-1; lo < hi; ++lo, --hi) {
+            std::swap(order[lo], order[hi]);
+        }
+    }
+
+    CutPolygon tmp = poly;
+    for (int m = 0; m < poly.n; ++m) {
+        poly.keys[m] = tmp.keys[order[m]];
+        for (int d = 0; d < 3; ++d) {
+            poly.pts[m][d] = tmp.pts[order[m]][d];
+        }
+    }
+    return true;
+}
+
+// The vertex on an edge belongs to the box with the lowest index among
+// those with a cell next to the edge.
+int edgeOwner (const BoxArray& ba, int dir, IntVect const& node)
+{
+    IntVect lo = node - 1;
+    lo[dir] = node[dir];
+    int owner = std::numeric_limits<int>::max();
+    for (auto const& is : ba.intersections(Box(lo,node))) {
+        owner = std::min(owner, is.first);
+    }
+    return owner;
+}
+
+struct EdgeSum
+{
+    Real x[3] = {0.0, 0.0, 0.0};
+    int n = 0;
+};
+
+#endif
+
+}
+
+EBSurface
+makeEBSurface (const EBFArrayBoxFactory& ebf, bool weld)
+{
+    BL_PROFILE("amrex::makeEBSurface()");
+
+    EBSurface surf;
+
+#if (AMREX_SPACEDIM != 3)
+    amrex::ignore_unused(ebf,weld);
+    amrex::Abort("makeEBSurface: only 3D is supported");
+#else
+    const Geometry& geom = ebf.Geom();
+    const BoxArray& ba = ebf.boxArray();
+    const DistributionMapping& dm = ebf.DistributionMap();
+    const auto& flags = ebf.getMultiEBCellFlagFab();
+    const auto& areafrac = ebf.getAreaFrac();
+    const auto bndrycent = ebf.getBndryCentData();
+    const Real* dx = geom.CellSize();
+    const Real* problo = geom.ProbLo();
+    const EdgeIndexer ei(geom.Domain());
+
+    if (weld && flags.nGrow() < 1) {
+        amrex::Abort("makeEBSurface: welding needs EB data with at least one ghost cell");
+    }
+
+    Vector<Long> poly_keys;
+    std::unordered_map<Long,int> vertex_id;
+    std::unordered_map<Long,std::array<Real,3> > remote;
+
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const auto& flagfab = flags[mfi];
+        // With welding, the box may own the vertices of the cut cells of
+        // its neighbors.
+        const Box& gbx = weld ? (amrex::grow(vbx,1) & flagfab.box()) : vbx;
+        const FabType typ = flagfab.getType(gbx);
+        if (typ == FabType::regular || typ == FabType::covered) continue;
+
+        auto const& flag = flagfab.const_array();
+        auto const& apx = areafrac[0]->const_array(mfi);
+        auto const& apy = areafrac[1]->const_array(mfi);
+        auto const& apz = areafrac[2]->const_array(mfi);
+        auto const& bc = bndrycent.const_array(mfi);
+
+        // The cells outside the BoxArray are skipped, so that all the
+        // boxes next to an edge see the same cells.
+        const BoxList outside = weld ? ba.complementIn(gbx) : BoxList();
+
+        std::map<Long,EdgeSum> edges;
+
+        amrex::LoopOnCpu(gbx, [&] (int i, int j, int k)
+        {
+            const IntVect iv(i,j,k);
+            if (!flag(i,j,k).isSingleValued()) return;
+            for (const Box& b : outside) {
+                if (b.contains(iv)) return;
+            }
+
+            Real n[3] = {apx(i+1,j,k)-apx(i,j,k), apy(i,j+1,k)-apy(i,j,k), apz(i,j,k+1)-apz(i,j,k)};
+            const Real nrm = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+            if (nrm == 0.0) return;
+            Real c[3];
+            for (int d = 0; d < 3; ++d) {
+                n[d] /= nrm;
+                c[d] = problo[d] + (iv[d] + 0.5 + bc(i,j,k,d))*dx[d];
+            }
+
+            CutPolygon poly;
+            if (!cutCellPolygon(iv, n, c, dx, problo, ei, poly)) return;
+
+            if (weld) {
+                for (int m = 0; m < poly.n; ++m) {
+                    EdgeSum& s = edges[poly.keys[m]];
+                    for (int d = 0; d < 3; ++d) {
+                        s.x[d] += poly.pts[m][d];
+                    }
+                    ++s.n;
+                }
+            }
+
+            if (vbx.contains(iv)) {
+                for (int m = 0; m < poly.n; ++m) {
+                    if (weld) {
+                        poly_keys.push_back(poly.keys[m]);
+                    } else {
+                        surf.connectivity.push_back(surf.points.size()/3);
+                        for (int d = 0; d < 3; ++d) {
+                            surf.points.push_back(poly.pts[m][d]);
+                        }
+                    }
+                }
+                const int nconn = weld ? poly_keys.size() : surf.connectivity.size();
+                surf.offsets.push_back(nconn);
+            }
+        });
+
+        if (weld)
+        {
+            for (auto const& e : edges)
+            {
+                int dir;
+                IntVect node;
+                ei.decode(e.first, dir, node);
+                const Box& ebx = amrex::convert(vbx, IntVect::TheUnitVector()
+                                                - IntVect::TheDimensionVector(dir));
+                if (!ebx.contains(node)) continue;
+
+                bool interior = true;
+                for (int d = 0; d < 3; ++d) {
+                    if (d != dir && (node[d] == ebx.smallEnd(d) || node[d] == ebx.bigEnd(d))) {
+                        interior = false;
+                    }
+                }
+                const int owner = interior ? mfi.index() : edgeOwner(ba, dir, node);
+
+                const std::array<Real,3> pos {{e.second.x[0]/e.second.n,
+                                               e.second.x[1]/e.second.n,
+                                               e.second.x[2]/e.second.n}};
+                if (owner == mfi.index()) {
+                    vertex_id[e.first] = surf.points.size()/3;
+                    surf.points.insert(surf.points.end(), pos.begin(), pos.end());
+                } else {
+                    remote[e.first] = pos;
+                }
+            }
+        }
+    }
+
+    const int nowned = surf.points.size()/3;
+    surf.num_owned_points = nowned;
+    const Long first_id = ParallelDescriptor::ExclusiveScanSum(static_cast<Long>(nowned));
+
+    if (!weld)
+    {
+        surf.global_ids.resize(nowned);
+        for (int i = 0; i < nowned; ++i) {
+            surf.global_ids[i] = first_id + i;
+        }
+        return surf;
+    }
+
+    // Copies of the vertices of other ranks
+    for (Long key : poly_keys)
+    {
+        if (vertex_id.count(key) == 0) {
+            AMREX_ASSERT(remote.count(key) > 0);
+            vertex_id[key] = surf.points.size()/3;
+            const auto& pos = remote[key];
+            surf.points.insert(surf.points.end(), pos.begin(), pos.end());
+        }
+    }
+
+    surf.connectivity.resize(poly_keys.size());
+    for (int m = 0, N = poly_keys.size(); m < N; ++m) {
+        surf.connectivity[m] = vertex_id[poly_keys[m]];
+    }
+
+    const int npts = surf.points.size()/3;
+    surf.global_ids.resize(npts);
+    Vector<Long> keys(npts);
+    for (auto const& kv : vertex_id) {
+        keys[kv.second] = kv.first;
+    }
+    for (int i = 0; i < nowned; ++i) {
+        surf.global_ids[i] = first_id + i;
+    }
+
+#ifdef BL_USE_MPI
+    // Ask the owners for the indices of the copies.
+    const int nprocs = ParallelDescriptor::NProcs();
+    const MPI_Comm comm = ParallelDescriptor::Communicator();
+    const auto long_type = ParallelDescriptor::Mpi_typemap<Long>::type();
+
+    Vector<Vector<int> > copies(nprocs);
+    for (int i = nowned; i < npts; ++i) {
+        int dir;
+        IntVect node;
+        ei.decode(keys[i], dir, node);
+        copies[dm[edgeOwner(ba, dir, node)]].push_back(i);
+    }
+
+    Vector<int> scnt(nprocs), rcnt(nprocs), sdsp(nprocs,0), rdsp(nprocs,0);
+    for (int p = 0; p < nprocs; ++p) {
+        scnt[p] = copies[p].size();
+    }
+    BL_MPI_REQUIRE( MPI_Alltoall(scnt.data(), 1, MPI_INT, rcnt.data(), 1, MPI_INT, comm) );
+    for (int p = 1; p < nprocs; ++p) {
+        sdsp[p] = sdsp[p-1] + scnt[p-1];
+        rdsp[p] = rdsp[p-1] + rcnt[p-1];
+    }
+
+    Vector<Long> sendbuf(npts-nowned);
+    for (int p = 0; p < nprocs; ++p) {
+        for (int m = 0; m < scnt[p]; ++m) {
+            sendbuf[sdsp[p]+m] = keys[copies[p][m]];
+        }
+    }
+    Vector<Long> recvbuf(rdsp[nprocs-1]+rcnt[nprocs-1]);
+    BL_MPI_REQUIRE( MPI_Alltoallv(sendbuf.data(), scnt.data(), sdsp.data(), long_type,
+                                  recvbuf.data(), rcnt.data(), rdsp.data(), long_type, comm) );
+
+    for (auto& key : recvbuf) {
+        auto it = vertex_id.find(key);
+        if (it == vertex_id.end() || it->second >= nowned) {
+            amrex::Abort("makeEBSurface: vertex not found on its owner");
+        }
+        key = first_id + it->second;
+    }
+
+    BL_MPI_REQUIRE( MPI_Alltoallv(recvbuf.data(), rcnt.data(), rdsp.data(), long_type,
+                                  sendbuf.data(), scnt.data(), sdsp.data(), long_type, comm) );
+    for (int p = 0; p < nprocs; ++p) {
+        for (int m = 0; m < scnt[p]; ++m) {
+            surf.global_ids[copies[p][m]] = sendbuf[sdsp[p]+m];
+        }
+    }
+#else
+    amrex::ignore_unused(dm);
+    AMREX_ALWAYS_ASSERT(npts == nowned);
+#endif
+#endif
+
+    return surf;
+}
+
+void
+WriteEBSurfaceVTP (const EBSurface& surf, const std::string& name)
+{
+    BL_PROFILE("amrex::WriteEBSurfaceVTP()");
+
+    static_assert(sizeof(int) == 4 && sizeof(float) == 4, "WriteEBSurfaceVTP: Int32 and Float32");
+
+    const int myproc = ParallelDescriptor::MyProc();
+    const int nprocs = ParallelDescriptor::NProcs();
+    const std::string byte_order = isLittleEndian() ? "LittleEndian" : "BigEndian";
+
+    const std::size_t pos = name.find_last_of('/');
+    const std::string base = (pos == std::string::npos) ? name : name.substr(pos+1);
+
+    const int np = surf.numPoints();
+    Vector<float> pts(surf.points.begin(), surf.points.end());
+
+    // In the appended data, each array is preceded by its size in bytes.
+    const std::uint64_t pts_bytes = pts.size()*sizeof(float);
+    const std::uint64_t con_bytes = surf.connectivity.size()*sizeof(int);
+    const std::uint64_t off_bytes = surf.offsets.size()*sizeof(int);
+    const std::uint64_t con_offset = sizeof(std::uint64_t) + pts_bytes;
+    const std::uint64_t off_offset = con_offset + sizeof(std::uint64_t) + con_bytes;
+
+    std::ostringstream os;
+    os << "<?xml version=\"1.0\"?>\n"
+       << "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"" << byte_order
+       << "\" header_type=\"UInt64\">\n"
+       << "  <PolyData>\n"
+       << "    <Piece NumberOfPoints=\"" << np << "\" NumberOfVerts=\"0\" NumberOfLines=\"0\""
+       << " NumberOfStrips=\"0\" NumberOfPolys=\"" << surf.numPolygons() << "\">\n"
+       << "      <Points>\n"
+       << "        <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"appended\" offset=\"0\"/>\n"
+       << "      </Points>\n"
+       << "      <Polys>\n"
+       << "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\""
+       << con_offset << "\"/>\n"
+       << "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\""
+       << off_offset << "\"/>\n"
+       << "      </Polys>\n"
+       << "    </Piece>\n"
+       << "  </PolyData>\n"
+       << "  <AppendedData encoding=\"raw\">\n_";
+
+    const std::string filename = amrex::Concatenate(name+"_", myproc, 5) + ".vtp";
+    std::ofstream ofs(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!ofs.good()) amrex::FileOpenFailed(filename);
+    ofs << os.str();
+    ofs.write(reinterpret_cast<const char*>(&pts_bytes), sizeof(std::uint64_t));
+    ofs.write(reinterpret_cast<const char*>(pts.data()), pts_bytes);
+    ofs.write(reinterpret_cast<const char*>(&con_bytes), sizeof(std::uint64_t));
+    ofs.write(reinterpret_cast<const char*>(surf.connectivity.data()), con_bytes);
+    ofs.write(reinterpret_cast<const char*>(&off_bytes), sizeof(std::uint64_t));
+    ofs.write(reinterpret_cast<const char*>(surf.offsets.data()), off_bytes);
+    ofs << "\n  </AppendedData>\n</VTKFile>\n";
+    if (!ofs.good()) amrex::Abort("WriteEBSurfaceVTP: failed to write " + filename);
+    ofs.close();
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const std::string pfilename = name + ".pvtp";
+        std::ofstream pfs(pfilename, std::ios::out | std::ios::trunc);
+        if (!pfs.good()) amrex::FileOpenFailed(pfilename);
+        pfs << "<?xml version=\"1.0\"?>\n"
+            << "<VTKFile type=\"PPolyData\" version=\"1.0\" byte_order=\"" << byte_order
+            << "\" header_type=\"UInt64\">\n"
+            << "  <PPolyData GhostLevel=\"0\">\n"
+            << "    <PPoints>\n"
+            << "      <PDataArray type=\"Float32\" NumberOfComponents=\"3\"/>\n"
+            << "    </PPoints>\n";
+        for (int iproc = 0; iproc < nprocs; ++iproc) {
+            pfs << "    <Piece Source=\"" << amrex::Concatenate(base+"_", iproc, 5) << ".vtp\"/>\n";
+        }
+        pfs << "  </PPolyData>\n"
+            << "</VTKFile>\n";
+    }
+}
+
+void
+WriteEBSurfacePLY (const EBSurface& surf, const std::string& name)
+{
+    BL_PROFILE("amrex::WriteEBSurfacePLY()");
+
+    static_assert(sizeof(int) == 4 && sizeof(float) == 4, "WriteEBSurfacePLY: int and float");
+
+    const Long nverts = surf.numOwnedPoints();
+    const Long nfaces = surf.numPolygons();
+    const Long face_bytes = nfaces + static_cast<Long>(sizeof(int))*surf.connectivity.size();
+
+    Long total_verts = nverts;
+    Long total_faces = nfaces;
+    ParallelDescriptor::ReduceLongSum(total_verts);
+    ParallelDescriptor::ReduceLongSum(total_faces);
+    if (total_verts > static_cast<Long>(INT_MAX)) {
+        amrex::Abort("WriteEBSurfacePLY: too many vertices for int indices");
+    }
+    const Long first_vert = ParallelDescriptor::ExclusiveScanSum(nverts);
+    const Long first_face_byte = ParallelDescriptor::ExclusiveScanSum(face_bytes);
+
+    // All the ranks make the same header.
+    std::ostringstream os;
+    os << "ply\n"
+       << "format " << (isLittleEndian() ? "binary_little_endian" : "binary_big_endian") << " 1.0\n"
+       << "comment AMReX EB surface\n"
+       << "element vertex " << total_verts << "\n"
+       << "property float x\n"
+       << "property float y\n"
+       << "property float z\n"
+       << "element face " << total_faces << "\n"
+       << "property list uchar int vertex_indices\n"
+       << "end_header\n";
+    const std::string header = os.str();
+
+    const std::string filename = name + ".ply";
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream ofs(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!ofs.good()) amrex::FileOpenFailed(filename);
+        ofs << header;
+    }
+    ParallelDescriptor::Barrier();
+
+    Vector<float> verts(surf.points.begin(), surf.points.begin() + 3*nverts);
+
+    Vector<char> faces(face_bytes);
+    {
+        char* p = faces.data();
+        int begin = 0;
+        for (int ipoly = 0; ipoly < nfaces; ++ipoly) {
+            const int end = surf.offsets[ipoly];
+            *p++ = static_cast<unsigned char>(end-begin);
+            for (int m = begin; m < end; ++m) {
+                const int id = surf.global_ids[surf.connectivity[m]];
+                std::memcpy(p, &id, sizeof(int));
+                p += sizeof(int);
+            }
+            begin = end;
+        }
+    }
+
+    if (nverts > 0 || nfaces > 0)
+    {
+        std::fstream fs(filename, std::ios::in | std::ios::out | std::ios::binary);
+        if (!fs.good()) amrex::FileOpenFailed(filename);
+        const Long vert_offset = header.size() + first_vert*3*sizeof(float);
+        const Long face_offset = header.size() + total_verts*3*sizeof(float) + first_face_byte;
+        fs.seekp(vert_offset);
+        fs.write(reinterpret_cast<const char*>(verts.data()), verts.size()*sizeof(float));
+        fs.seekp(face_offset);
+        fs.write(faces.data(), faces.size());
+        if (!fs.good()) amrex::Abort("WriteEBSurfacePLY: failed to write " + filename);
+    }
+    ParallelDescriptor::Barrier();
+}
+
+}
@@ -16,6 +16,10 @@
 
 #include <AMReX_EB2.H>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace amrex {
 
 LSFactory::LSFactory(int lev, int ls_ref, int eb_ref, int ls_pad, int eb_pad,
@@ -816,6 +820,289 @@ void LSFactory::fill_data (MultiFab & data, iMultiFab & valid,
 
 
 
+namespace {
+
+    //! Godunov upwind solution of |grad(phi)| = 1 at a node, given the
+    //! smallest distance `a` of the neighbours in each direction, and the cell
+    //! sizes `h`. Both are sorted in place.
+    Real eikonal_update (Real * a, Real * h) {
+
+        for (int m = 1; m < AMREX_SPACEDIM; ++m) {
+            for (int n = m; n > 0 && a[n] < a[n-1]; --n) {
+                std::swap(a[n], a[n-1]);
+                std::swap(h[n], h[n-1]);
+            }
+        }
+
+        // Add directions (in increasing order of `a`) as long as the solution
+        // is larger than the upwind value of the next direction
+        Real s0 = 0., s1 = 0., s2 = 0., u = 0.;
+        for (int m = 0; m < AMREX_SPACEDIM; ++m) {
+            const Real w = 1./(h[m]*h[m]);
+            s0 += w;
+            s1 += w*a[m];
+            s2 += w*a[m]*a[m];
+            u = (s1 + std::sqrt(std::max(s1*s1 - s0*(s2 - 1.), 0.)))/s0;
+            if (m == AMREX_SPACEDIM - 1 || u <= a[m+1]) break;
+        }
+
+        return u;
+    }
+
+
+    //! Performs one Gauss-Seidel sweep over `bx` in each of the 2^D
+    //! directions. The magnitude of non-frozen nodes can only decrease, and is
+    //! capped at `phi_max`. Returns the largest decrease in `valid_bx`.
+    Real sweep_levelset (Array4<Real> const & phi, Array4<int const> const & frozen,
+                         const Box & bx, const Box & valid_bx,
+                         const RealVect & dx, Real phi_max) {
+
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+
+        Real change = 0.;
+
+        for (int dir = 0; dir < (1 << AMREX_SPACEDIM); ++dir) {
+            const bool fi = (dir & 1) == 0;
+            const bool fj = (dir & 2) == 0;
+            const bool fk = (dir & 4) == 0;
+
+            for (int kk = 0; kk <= hi.z - lo.z; ++kk) {
+            for (int jj = 0; jj <= hi.y - lo.y; ++jj) {
+            for (int ii = 0; ii <= hi.x - lo.x; ++ii) {
+                const int i = fi ? lo.x + ii : hi.x - ii;
+                const int j = fj ? lo.y + jj : hi.y - jj;
+                const int k = fk ? lo.z + kk : hi.z - kk;
+
+                if (frozen(i, j, k) == 1) continue;
+
+                Real a[AMREX_SPACEDIM], h[AMREX_SPACEDIM];
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    a[d] = phi_max;
+                    h[d] = dx[d];
+                }
+                if (i > lo.x) a[0] = std::min(a[0], std::abs(phi(i-1, j, k)));
+                if (i < hi.x) a[0] = std::min(a[0], std::abs(phi(i+1, j, k)));
+#if (AMREX_SPACEDIM >= 2)
+                if (j > lo.y) a[1] = std::min(a[1], std::abs(phi(i, j-1, k)));
+                if (j < hi.y) a[1] = std::min(a[1], std::abs(phi(i, j+1, k)));
+#endif
+#if (AMREX_SPACEDIM == 3)
+                if (k > lo.z) a[2] = std::min(a[2], std::abs(phi(i, j, k-1)));
+                if (k < hi.z) a[2] = std::min(a[2], std::abs(phi(i, j, k+1)));
+#endif
+
+                const Real u   = std::min(eikonal_update(a, h), phi_max);
+                const Real old = std::abs(phi(i, j, k));
+                if (u < old) {
+                    phi(i, j, k) = (phi(i, j, k) < 0) ? -u : u;
+                    if (valid_bx.contains(IntVect(AMREX_D_DECL(i, j, k))))
+                        change = std::max(change, old - u);
+                }
+            }
+            }
+            }
+        }
+
+        return change;
+    }
+}
+
+
+
+void LSFactory::fill_data_sweep (MultiFab & data, iMultiFab & valid,
+                                 const EBFArrayBoxFactory & eb_factory,
+                                 const MultiFab & eb_impfunc,
+                                 int ebt_size, int ls_ref, int eb_ref,
+                                 const Geometry & geom, const Geometry & geom_eb,
+                                 const MultiFab * ls_guess, int band_pad) {
+
+    BL_PROFILE("LSFactory::fill_data_sweep()");
+
+    RealVect dx(AMREX_D_DECL(geom.CellSize(0),
+                             geom.CellSize(1),
+                             geom.CellSize(2)));
+
+    RealVect dx_eb(AMREX_D_DECL(geom_eb.CellSize(0),
+                                geom_eb.CellSize(1),
+                                geom_eb.CellSize(2)));
+
+    const BoxArray & ls_ba            = data.boxArray();
+    const BoxArray & eb_ba            = eb_factory.boxArray();
+    const DistributionMapping & ls_dm = data.DistributionMap();
+    const int ls_pad                  = data.nGrow();
+
+    const MultiCutFab & bndrycent = eb_factory.getBndryCent();
+    const auto & flags = eb_factory.getMultiEBCellFlagFab();
+
+    // make sure to use the EB-factory's ngrow for the eb-padding;
+    const int eb_pad = flags.nGrow();
+
+    // The search box of a tile must fit in the EB-factory's ghost cells
+    band_pad = std::min(band_pad, eb_pad);
+
+    const Real min_dx       = LSUtility::min_dx(geom_eb);
+    const Real ls_threshold = min_dx * (eb_pad + 1);
+    // A facet closer than this to a node of the tile box is always found by
+    // the search over the tile box grown by `band_pad` EB cells
+    const Real band_dist    = min_dx * std::max(band_pad - 1, 0);
+    // Edge length (in level-set nodes) of the blocks searched for facets
+    const int band_block    = 4;
+
+    MultiFab normal(eb_ba, ls_dm, 3, eb_pad); //deliberately use levelset DM
+    amrex::FillEBNormals(normal, eb_factory, geom_eb);
+
+    iMultiFab frozen(ls_ba, ls_dm, 1, ls_pad);
+    frozen.setVal(0);
+
+
+    /****************************************************************************
+     *                                                                          *
+     * Initialize the level-set to the threshold (or the guess, if smaller)     *
+     * with the sign of the implicit function, and fill the narrow band around  *
+     * EB facets with the exact distance                                        *
+     *                                                                          *
+     ***************************************************************************/
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        FArrayBox ls_band;
+        IArrayBox v_band;
+        for (MFIter mfi(data, IntVect{AMREX_D_DECL(ebt_size, ebt_size, ebt_size)}
+                              * std::max(1, ls_ref/eb_ref)); mfi.isValid(); ++mfi)
+        {
+            const Box & grown_box = mfi.growntilebox();
+            const Box & tile_box  = mfi.tilebox();
+
+            auto & ls_tile = data[mfi];
+            const auto & if_tile = eb_impfunc[mfi];
+
+            for (BoxIterator bit(grown_box); bit.ok(); ++bit) {
+                const IntVect & iv = bit();
+                Real phi = ls_threshold;
+                if (ls_guess != nullptr)
+                    phi = std::min(phi, std::abs((* ls_guess)[mfi](iv)));
+                ls_tile(iv) = (if_tile(iv) <= 0) ? phi : -phi;
+            }
+
+            if (! bndrycent.ok(mfi)) continue;
+
+            // Search for facets block by block, so that each node is only
+            // compared with the facets near its block
+            auto & frozen_tile = frozen[mfi];
+            const IntVect & tile_lo = tile_box.smallEnd();
+            const IntVect & tile_hi = tile_box.bigEnd();
+            const Box blocks(IntVect::TheZeroVector(), (tile_hi - tile_lo)/band_block);
+
+            for (BoxIterator bit(blocks); bit.ok(); ++bit) {
+                const IntVect block_lo = tile_lo + bit()*band_block;
+                const IntVect block_hi = amrex::min(block_lo + (band_block - 1), tile_hi);
+                const Box block(block_lo, block_hi, tile_box.ixType());
+
+                Box eb_search = block;
+                eb_search.coarsen(ls_ref);
+                eb_search.refine(eb_ref);
+                eb_search.enclosedCells(); // search box must be cell-centered
+                eb_search.grow(band_pad);
+
+                std::unique_ptr<Vector<Real>> facets = eb_facets(normal[mfi], bndrycent[mfi],
+                                                                 flags[mfi], dx_eb, eb_search);
+                int len_facets = facets->size();
+                if (len_facets == 0) continue;
+
+                ls_band.resize(block, 1);
+                v_band.resize(block, 1);
+
+                amrex_eb_fill_levelset(BL_TO_FORTRAN_BOX(block),
+                                       facets->dataPtr(), & len_facets,
+                                       BL_TO_FORTRAN_3D(v_band),
+                                       BL_TO_FORTRAN_3D(ls_band),
+                                       dx.dataPtr(), dx_eb.dataPtr() );
+
+                amrex_eb_validate_levelset(BL_TO_FORTRAN_BOX(block), & ls_ref,
+                                           BL_TO_FORTRAN_3D(if_tile),
+                                           BL_TO_FORTRAN_3D(v_band),
+                                           BL_TO_FORTRAN_3D(ls_band)   );
+
+                for (BoxIterator nit(block); nit.ok(); ++nit) {
+                    const IntVect & iv = nit();
+                    const Real dist = std::abs(ls_band(iv));
+                    if (dist <= band_dist) {
+                        ls_tile(iv)     = ls_band(iv);
+                        frozen_tile(iv) = 1;
+                    } else if (dist < std::abs(ls_tile(iv))) {
+                        // The distance to any facet is an upper bound
+                        ls_tile(iv) = (ls_tile(iv) < 0) ? -dist : dist;
+                    }
+                }
+            }
+        }
+    }
+
+    frozen.FillBoundary(geom.periodicity());
+
+
+    /****************************************************************************
+     *                                                                          *
+     * Sweep until no valid node changes. Each round propagates the distances  *
+     * through (at least) one box, and FillBoundary passes them on to the next  *
+     *                                                                          *
+     ***************************************************************************/
+
+    const Real tolerance = 1.e-6 * min_dx;
+    const int  max_rounds = 100;
+
+    int round = 0;
+    for (; round < max_rounds; ++round) {
+
+        data.FillBoundary(geom.periodicity());
+
+        Real change = 0.;
+#ifdef _OPENMP
+#pragma omp parallel reduction(max:change)
+#endif
+        for (MFIter mfi(data); mfi.isValid(); ++mfi) {
+            change = std::max(change,
+                              sweep_levelset(data.array(mfi), frozen.const_array(mfi),
+                                             mfi.fabbox(), mfi.validbox(), dx, ls_threshold));
+        }
+
+        ParallelDescriptor::ReduceRealMax(change);
+        if (change <= tolerance) break;
+    }
+
+    if (round == max_rounds) {
+        amrex::Warning("LSFactory::fill_data_sweep: sweeps did not converge");
+    }
+
+    data.FillBoundary(geom.periodicity());
+
+
+    /****************************************************************************
+     *                                                                          *
+     * Flag the region below the threshold                                      *
+     *                                                                          *
+     ***************************************************************************/
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(data, true); mfi.isValid(); ++mfi) {
+        const Box & grown_box = mfi.growntilebox();
+        const auto & ls_tile  = data[mfi];
+        auto & region_tile    = valid[mfi];
+
+        for (BoxIterator bit(grown_box); bit.ok(); ++bit) {
+            const IntVect & iv = bit();
+            region_tile(iv) = (std::abs(ls_tile(iv)) < ls_threshold) ? 1 : 0;
+        }
+    }
+}
+
+
+
 void LSFactory::intersect_data (MultiFab & data, iMultiFab & valid,
                                 const MultiFab & data_in, const iMultiFab & valid_in,
                                 const Geometry & /*geom_ls*/) {
@@ -945,6 +1232,114 @@ std::unique_ptr<iMultiFab> LSFactory::Fill(const MultiFab & mf_impfunc,
 
 
 
+std::unique_ptr<iMultiFab> LSFactory::FillSweep(const EBFArrayBoxFactory & eb_factory,
+                                                const MultiFab & mf_impfunc) {
+
+    std::unique_ptr<iMultiFab> region_valid = std::unique_ptr<iMultiFab>(new iMultiFab);
+    region_valid->define(ls_ba, ls_dm, 1, ls_grid_pad);
+    region_valid->setVal(0);
+
+    LSFactory::fill_data_sweep(* ls_grid, * region_valid, eb_factory, mf_impfunc,
+                               eb_tile_size, ls_grid_ref, eb_grid_ref, geom_ls, geom_eb);
+
+    fill_valid();
+
+    return region_valid;
+}
+
+
+
+std::unique_ptr<iMultiFab> LSFactory::FillSweep(const EBFArrayBoxFactory & eb_factory,
+                                                const MultiFab & mf_impfunc,
+                                                const LSFactory & ls_crse) {
+
+    BL_PROFILE("LSFactory::FillSweep(ls_crse)");
+
+    const Geometry & geom_crse = ls_crse.get_ls_geom();
+    const int ratio = static_cast<int>(std::round(geom_crse.CellSize(0)/geom_ls.CellSize(0)));
+
+    if (ratio < 1 || amrex::refine(geom_crse.Domain(), ratio) != geom_ls.Domain())
+        amrex::Abort("LSFactory::FillSweep: ls_crse must be coarser by an integer ratio");
+
+
+    /****************************************************************************
+     *                                                                          *
+     * Copy the coarse level-set over the (coarsened) level-set BoxArray.       *
+     * Coarse nodes that are not covered, or are at the coarse threshold, don't *
+     * say anything about the distance                                          *
+     *                                                                          *
+     ***************************************************************************/
+
+    const Real crse_threshold = LSUtility::min_dx(ls_crse.get_eb_geom())
+                                * (ls_crse.get_eb_pad() + 1);
+
+    BoxArray crse_ba = ls_ba;
+    crse_ba.coarsen(ratio);
+    const int crse_pad = ls_grid_pad/ratio + 1;
+
+    MultiFab ls_c(crse_ba, ls_dm, 1, crse_pad);
+    ls_c.setVal(crse_threshold);
+    ls_c.ParallelCopy(* ls_crse.get_data(), 0, 0, 1, ls_crse.get_ls_pad(), crse_pad,
+                      geom_crse.periodicity());
+
+
+    /****************************************************************************
+     *                                                                          *
+     * The distance function is 1-Lipschitz => the distance at a node is at     *
+     * most the coarse distance at any node of the enclosing coarse cell plus   *
+     * the distance to that node                                                *
+     *                                                                          *
+     ***************************************************************************/
+
+    MultiFab ls_guess(ls_ba, ls_dm, 1, ls_grid_pad);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(ls_guess, true); mfi.isValid(); ++mfi) {
+        const Box & grown_box = mfi.growntilebox();
+        const auto & c_tile   = ls_c[mfi];
+        auto & g_tile         = ls_guess[mfi];
+
+        for (BoxIterator bit(grown_box); bit.ok(); ++bit) {
+            const IntVect & iv = bit();
+            const IntVect ivc  = amrex::coarsen(iv, ratio);
+
+            Real bound = std::numeric_limits<Real>::max();
+            for (int n = 0; n < (1 << AMREX_SPACEDIM); ++n) {
+                IntVect jv = ivc;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) jv[d] += (n >> d) & 1;
+                if (! c_tile.box().contains(jv)) continue;
+
+                const Real phi_c = std::abs(c_tile(jv));
+                if (phi_c >= crse_threshold) continue;
+
+                Real dist = 0.;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    const Real h = (iv[d] - jv[d]*ratio) * dx_vect[d];
+                    dist += h*h;
+                }
+                bound = std::min(bound, phi_c + std::sqrt(dist));
+            }
+            g_tile(iv) = bound;
+        }
+    }
+
+    std::unique_ptr<iMultiFab> region_valid = std::unique_ptr<iMultiFab>(new iMultiFab);
+    region_valid->define(ls_ba, ls_dm, 1, ls_grid_pad);
+    region_valid->setVal(0);
+
+    LSFactory::fill_data_sweep(* ls_grid, * region_valid, eb_factory, mf_impfunc,
+                               eb_tile_size, ls_grid_ref, eb_grid_ref, geom_ls, geom_eb,
+                               & ls_guess);
+
+    fill_valid();
+
+    return region_valid;
+}
+
+
+
 std::unique_ptr<iMultiFab> LSFactory::Intersect(const EBFArrayBoxFactory & eb_factory,
                                                 const MultiFab & mf_impfunc) {
 
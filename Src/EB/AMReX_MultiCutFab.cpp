@@ -45,6 +45,21 @@ MultiCutFab::remove ()
     }
 }
 
+void
+MultiCutFab::remake (const MFIter& mfi)
+{
+    CutFab* p = &(m_data[mfi]);
+    if (ok(mfi) != p->isAllocated())
+    {
+        delete p;
+        if (ok(mfi)) {
+            m_data.setFab(mfi, new CutFab(m_data.fabbox(mfi.index()), m_data.nComp()), false);
+        } else {
+            m_data.setFab(mfi, new CutFab(), false);
+        }
+    }
+}
+
 const CutFab&
 MultiCutFab::operator[] (const MFIter& mfi) const noexcept
 {
@@ -80,6 +95,15 @@ MultiCutFab::array (const MFIter& mfi) noexcept
     return m_data.array(mfi);
 }
 
+CutArray4<Real>
+MultiCutFab::cut_array (const MFIter& mfi) const noexcept
+{
+    CutArray4<Real> r;
+    r.dense = const_array(mfi);
+    r.ncomp = nComp();
+    return r;
+}
+
 bool
 MultiCutFab::ok (const MFIter& mfi) const noexcept
 {
@@ -141,4 +165,172 @@ MultiCutFab::ToMultiFab (Real regular_value, Real covered_value) const
     return mf;
 }
 
+CutCellIndex::CutCellIndex (const FabArray<EBCellFlagFab>& cellflags)
+    : m_cellflags(&cellflags),
+      m_index(cellflags.boxArray(), cellflags.DistributionMap(), 1, cellflags.nGrow(),
+              MFInfo(), DefaultFabFactory<BaseFab<int> >()),
+      m_cells(cellflags.boxArray(), cellflags.DistributionMap())
+{
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_index); mfi.isValid(); ++mfi)
+    {
+        if (!ok(mfi))
+        {
+            BaseFab<int>* p = &(m_index[mfi]);
+            delete p;
+            m_index.setFab(mfi, new BaseFab<int>(), false);
+            continue;
+        }
+
+        // The flags are classified on the host once.
+        const EBCellFlagFab& flagfab = cellflags[mfi];
+        const Box& bx = flagfab.box();
+        const Long npts = bx.numPts();
+        Vector<EBCellFlag> hflags(npts);
+        Gpu::copy(Gpu::deviceToHost, flagfab.dataPtr(), flagfab.dataPtr()+npts, hflags.begin());
+
+        Vector<int> hindex(npts);
+        Vector<IntVect> hcells;
+        for (Long i = 0; i < npts; ++i) {
+            if (hflags[i].isSingleValued()) {
+                hindex[i] = hcells.size();
+                hcells.push_back(bx.atOffset(i));
+            } else {
+                hindex[i] = -1;
+            }
+        }
+
+        Gpu::copy(Gpu::hostToDevice, hindex.begin(), hindex.end(), m_index[mfi].dataPtr());
+        Gpu::DeviceVector<IntVect>& cells = m_cells[mfi];
+        cells.resize(hcells.size());
+        Gpu::copy(Gpu::hostToDevice, hcells.begin(), hcells.end(), cells.begin());
+    }
+}
+
+bool
+CutCellIndex::ok (const MFIter& mfi) const noexcept
+{
+    return (*m_cellflags)[mfi].getType() == FabType::singlevalued;
+}
+
+Array4<int const>
+CutCellIndex::const_array (const MFIter& mfi) const noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    return m_index.const_array(mfi);
+}
+
+int
+CutCellIndex::numCutCells (const MFIter& mfi) const noexcept
+{
+    return m_cells[mfi].size();
+}
+
+IntVect const*
+CutCellIndex::cutCells (const MFIter& mfi) const noexcept
+{
+    return m_cells[mfi].dataPtr();
+}
+
+Long
+CutCellIndex::nBytes () const noexcept
+{
+    Long r = 0;
+    for (MFIter mfi(m_index); mfi.isValid(); ++mfi) {
+        if (ok(mfi)) {
+            r += m_index[mfi].nBytes() + m_cells[mfi].size()*sizeof(IntVect);
+        }
+    }
+    return r;
+}
+
+MultiSparseCutFab::MultiSparseCutFab (std::shared_ptr<CutCellIndex const> const& a_index,
+                                      const MultiCutFab& src, Real a_fill)
+    : m_index(a_index),
+      m_ba(src.boxArray()),
+      m_dm(src.DistributionMap()),
+      m_ncomp(src.nComp()),
+      m_ngrow(src.nGrow()),
+      m_fill(a_fill),
+      m_data(src.boxArray(), src.DistributionMap())
+{
+    AMREX_ASSERT(m_index->cellFlags().boxArray() == m_ba &&
+                 m_index->cellFlags().DistributionMap() == m_dm &&
+                 m_index->cellFlags().nGrow() >= m_ngrow);
+
+    const int ncomp = m_ncomp;
+    const Real fill = m_fill;
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi)
+    {
+        if (!ok(mfi)) continue;
+
+        const int ncut = m_index->numCutCells(mfi);
+        Gpu::DeviceVector<Real>& v = m_data[mfi];
+        v.resize(static_cast<Long>(ncut)*ncomp);
+
+        Real* AMREX_RESTRICT packed = v.dataPtr();
+        IntVect const* cells = m_index->cutCells(mfi);
+        Array4<Real const> const& s = src.const_array(mfi);
+        const Box& sbox = amrex::grow(mfi.validbox(), m_ngrow);
+        amrex::ParallelFor(ncut, [=] AMREX_GPU_DEVICE (int m) noexcept
+        {
+            const IntVect& iv = cells[m];
+            const bool inside = sbox.contains(iv);
+            for (int n = 0; n < ncomp; ++n) {
+                packed[static_cast<Long>(m)*ncomp+n] = inside ? s(iv,n) : fill;
+            }
+        });
+    }
+}
+
+CutArray4<Real>
+MultiSparseCutFab::const_array (const MFIter& mfi) const noexcept
+{
+    AMREX_ASSERT(ok(mfi));
+    CutArray4<Real> r;
+    r.index = m_index->const_array(mfi);
+    r.packed = m_data[mfi].dataPtr();
+    r.ncomp = m_ncomp;
+    r.fill = m_fill;
+    return r;
+}
+
+void
+MultiSparseCutFab::copyTo (MultiCutFab& dst) const
+{
+    AMREX_ASSERT(dst.boxArray() == m_ba && dst.DistributionMap() == m_dm &&
+                 dst.nComp() == m_ncomp && dst.nGrow() <= m_index->cellFlags().nGrow());
+
+    const int ncomp = m_ncomp;
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst.data()); mfi.isValid(); ++mfi)
+    {
+        if (ok(mfi)) {
+            Array4<Real> const& d = dst.array(mfi);
+            CutArray4<Real> const& s = const_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_4D(mfi.fabbox(), ncomp, i, j, k, n,
+            {
+                d(i,j,k,n) = s(i,j,k,n);
+            });
+        }
+    }
+}
+
+Long
+MultiSparseCutFab::nBytes () const noexcept
+{
+    Long r = 0;
+    for (MFIter mfi(m_data); mfi.isValid(); ++mfi) {
+        r += m_data[mfi].size()*sizeof(Real);
+    }
+    return r;
+}
+
 }
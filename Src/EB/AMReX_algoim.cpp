@@ -1,5 +1,6 @@
 #include <AMReX_algoim.H>
 #include <AMReX_EB2.H>
+#include <AMReX_MultiCutFab.H>
 #include <AMReX_Print.H>
 #include <AMReX_algoim_K.H>
 
@@ -25,8 +26,8 @@ compute_integrals (MultiFab& intgmf, IntVect nghost)
     const auto& my_factory = dynamic_cast<EBFArrayBoxFactory const&>(intgmf.Factory());
 
     // const MultiFab&    vfrac = my_factory.getVolFrac();
-    const MultiCutFab& bcent = my_factory.getBndryCent();
-    const MultiCutFab& bnorm = my_factory.getBndryNormal();
+    const EBCutData bcent = my_factory.getBndryCentData();
+    const EBCutData bnorm = my_factory.getBndryNormalData();
     const auto&        flags = my_factory.getMultiEBCellFlagFab();
 
     MFItInfo mfi_info;
@@ -60,8 +61,8 @@ compute_integrals (MultiFab& intgmf, IntVect nghost)
         else
         {
             // auto const& vf = vfrac.array(mfi);
-            auto const& bc = bcent.array(mfi);
-            auto const& bn = bnorm.array(mfi);
+            auto const& bc = bcent.const_array(mfi);
+            auto const& bn = bnorm.const_array(mfi);
             auto const& fg = flagfab.array();
 
             if (Gpu::inLaunchRegion())
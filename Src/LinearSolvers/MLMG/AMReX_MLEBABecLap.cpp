@@ -61,6 +61,8 @@ MLEBABecLap::define (const Vector<Geometry>& a_geom,
     m_cc_mask.resize(m_num_amr_levels);
     m_eb_phi.resize(m_num_amr_levels);
     m_eb_b_coeffs.resize(m_num_amr_levels);
+    m_cut_stencils.clear();
+    m_cut_stencils_dirty = true;
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_a_coeffs[amrlev].resize(m_num_mg_levels[amrlev]);
@@ -115,6 +117,7 @@ MLEBABecLap::setScalars (Real a, Real b)
             m_a_coeffs[amrlev][0].setVal(0.0);
         }
     }
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -122,6 +125,7 @@ MLEBABecLap::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
     m_needs_update = true;
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -129,6 +133,7 @@ MLEBABecLap::setACoeffs (int amrlev, Real alpha)
 {
     m_a_coeffs[amrlev][0].setVal(alpha);
     m_needs_update = true;
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -155,6 +160,7 @@ MLEBABecLap::setBCoeffs (int amrlev, const Array<MultiFab const*,AMREX_SPACEDIM>
         }
     }
     m_needs_update = true;
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -165,6 +171,7 @@ MLEBABecLap::setBCoeffs (int amrlev, Real beta)
     }
     m_needs_update = true;
     m_beta_loc     = Location::FaceCenter;
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -178,6 +185,7 @@ MLEBABecLap::setBCoeffs (int amrlev, Vector<Real> const& beta)
     }
     m_needs_update = true;
     m_beta_loc     = Location::FaceCenter;
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -250,6 +258,7 @@ MLEBABecLap::setEBDirichlet (int amrlev, const MultiFab& phi, const MultiFab& be
             }
         }
     }
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -305,6 +314,7 @@ MLEBABecLap::setEBDirichlet (int amrlev, const MultiFab& phi, Real beta)
             });
         }
     }
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -364,6 +374,7 @@ MLEBABecLap::setEBDirichlet (int amrlev, const MultiFab& phi, Vector<Real> const
             });
         }
     }
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -433,6 +444,7 @@ MLEBABecLap::setEBHomogDirichlet (int amrlev, const MultiFab& beta)
             }
         }
     }
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -488,6 +500,7 @@ MLEBABecLap::setEBHomogDirichlet (int amrlev, Real beta)
             });
         }
     }
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -547,6 +560,7 @@ MLEBABecLap::setEBHomogDirichlet (int amrlev, Vector<Real> const& hv_beta)
             });
         }
     }
+    m_cut_stencils_dirty = true;
 }
 
 void
@@ -644,6 +658,11 @@ MLEBABecLap::prepareForSolve ()
         }
     }
 
+    if (m_use_cut_stencils && m_cut_stencils_dirty) {
+        buildCutCellStencils();
+        m_cut_stencils_dirty = false;
+    }
+
     m_is_singular.clear();
     m_is_singular.resize(m_num_amr_levels, false);
     auto itlo = std::find(m_lobc[0].begin(), m_lobc[0].end(), BCType::Dirichlet);
@@ -671,6 +690,152 @@ MLEBABecLap::prepareForSolve ()
     m_needs_update = false;
 }
 
+void
+MLEBABecLap::buildCutCellStencils ()
+{
+    BL_PROFILE("MLEBABecLap::buildCutCellStencils()");
+
+    // The coefficients are obtained by applying the operator to 3^D
+    // periodic patterns of impulses, so that they are the same as those in
+    // mlebabeclap_adotx.  Each pattern has one impulse in the stencil of
+    // every cell.
+
+    constexpr int nst = mlebabeclap_stencil_size;
+    const int ncomp = getNComp();
+    const bool is_eb_dirichlet = isEBDirichlet();
+    const bool beta_on_centroid = (m_beta_loc == Location::FaceCentroid);
+    const bool  phi_on_centroid = (m_phi_loc  == Location::CellCentroid);
+    const Real ascalar = m_a_scalar;
+    const Real bscalar = m_b_scalar;
+
+    Array4<Real const> foo;
+
+    m_cut_stencils.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_cut_stencils[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            auto& stencils = m_cut_stencils[amrlev][mglev];
+            auto factory = dynamic_cast<EBFArrayBoxFactory const*>(m_factory[amrlev][mglev].get());
+            if (factory == nullptr) {
+                stencils.reset();
+                continue;
+            }
+            stencils.reset(new LayoutData<CutCellStencil>(m_grids[amrlev][mglev],
+                                                          m_dmap[amrlev][mglev]));
+
+            const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+            AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
+                         const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
+                         const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
+            const iMultiFab& ccmask = m_cc_mask[amrlev][mglev];
+            const auto dxinvarr = m_geom[amrlev][mglev].InvCellSizeArray();
+
+            const auto& flags = factory->getMultiEBCellFlagFab();
+            const MultiFab& vfrac = factory->getVolFrac();
+            const auto& area = factory->getAreaFrac();
+            const auto& fcent = factory->getFaceCent();
+            const MultiCutFab& barea = factory->getBndryArea();
+            const MultiCutFab& bcent = factory->getBndryCent();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            {
+                FArrayBox xfab, yfab;
+                for (MFIter mfi(acoef, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+                {
+                    const Box& vbx = mfi.validbox();
+                    if (flags[mfi].getType(vbx) != FabType::singlevalued) continue;
+
+                    CutCellStencil& st = (*stencils)[mfi];
+
+                    Vector<IntVect> hcells;
+                    const auto& hflag = flags[mfi].const_array();
+                    amrex::LoopOnCpu(vbx, [&] (int i, int j, int k) noexcept
+                    {
+                        if (hflag(i,j,k).isSingleValued()) {
+                            hcells.push_back(IntVect(AMREX_D_DECL(i,j,k)));
+                        }
+                    });
+                    const int ncells = hcells.size();
+                    st.cells.resize(ncells);
+                    Gpu::copy(Gpu::hostToDevice, hcells.begin(), hcells.end(), st.cells.begin());
+                    st.coefs.resize(ncells*ncomp*nst);
+                    IntVect const* cells = st.cells.data();
+                    Real* coefs = st.coefs.data();
+
+                    const Box& gbx = amrex::grow(vbx,1);
+                    xfab.resize(gbx, ncomp);
+                    yfab.resize(vbx, ncomp);
+                    Elixir xeli = xfab.elixir();
+                    Elixir yeli = yfab.elixir();
+                    Array4<Real> const& x = xfab.array();
+                    Array4<Real const> const& xc = xfab.const_array();
+                    Array4<Real> const& y = yfab.array();
+
+                    Array4<Real const> const& afab = acoef.const_array(mfi);
+                    AMREX_D_TERM(Array4<Real const> const& bxfab = bxcoef.const_array(mfi);,
+                                 Array4<Real const> const& byfab = bycoef.const_array(mfi);,
+                                 Array4<Real const> const& bzfab = bzcoef.const_array(mfi););
+                    Array4<int const> const& ccmfab = ccmask.const_array(mfi);
+                    Array4<EBCellFlag const> const& flagfab = flags.const_array(mfi);
+                    Array4<Real const> const& vfracfab = vfrac.const_array(mfi);
+                    AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
+                                 Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
+                                 Array4<Real const> const& apzfab = area[2]->const_array(mfi););
+                    AMREX_D_TERM(Array4<Real const> const& fcxfab = fcent[0]->const_array(mfi);,
+                                 Array4<Real const> const& fcyfab = fcent[1]->const_array(mfi);,
+                                 Array4<Real const> const& fczfab = fcent[2]->const_array(mfi););
+                    Array4<Real const> const& bafab = barea.const_array(mfi);
+                    Array4<Real const> const& bcfab = bcent.const_array(mfi);
+                    Array4<Real const> const& bebfab = (is_eb_dirichlet)
+                        ? m_eb_b_coeffs[amrlev][mglev]->const_array(mfi) : foo;
+
+                    for (int color = 0; color < nst; ++color)
+                    {
+                        const IntVect c(AMREX_D_DECL(color%3, (color/3)%3, color/9));
+
+                        AMREX_HOST_DEVICE_PARALLEL_FOR_4D ( gbx, ncomp, i, j, k, n,
+                        {
+                            x(i,j,k,n) = (AMREX_D_TERM(   (i%3+3)%3 == c[0],
+                                                      and (j%3+3)%3 == c[1],
+                                                      and (k%3+3)%3 == c[2])) ? 1.0 : 0.0;
+                        });
+
+                        AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( vbx, tbx,
+                        {
+                            mlebabeclap_adotx(tbx, y, xc, afab, AMREX_D_DECL(bxfab,byfab,bzfab),
+                                              ccmfab, flagfab, vfracfab,
+                                              AMREX_D_DECL(apxfab,apyfab,apzfab),
+                                              AMREX_D_DECL(fcxfab,fcyfab,fczfab),
+                                              bafab, bcfab, bebfab,
+                                              is_eb_dirichlet, foo, false, dxinvarr,
+                                              ascalar, bscalar, ncomp,
+                                              beta_on_centroid, phi_on_centroid);
+                        });
+
+                        AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( ncells, ic,
+                        {
+                            const IntVect& iv = cells[ic];
+                            // The offset of the impulse seen by this cell
+                            int m = 0;
+                            for (int idim = AMREX_SPACEDIM-1; idim >= 0; --idim) {
+                                const int o = ((c[idim]-iv[idim])%3+3)%3;
+                                m = 3*m + ((o == 2) ? 0 : o+1);
+                            }
+                            for (int n = 0; n < ncomp; ++n) {
+                                coefs[(ic*ncomp+n)*nst+m] = y(iv,n);
+                            }
+                        });
+                    }
+                }
+            }
+        }
+    }
+}
+
 void
 MLEBABecLap::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) const
 {
@@ -704,8 +869,15 @@ MLEBABecLap::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) c
     const Real ascalar = m_a_scalar;
     const Real bscalar = m_b_scalar;
 
+    // The stencils do not have the inhomogeneous EB term.
+    auto stencils = (is_eb_dirichlet && is_eb_inhomog) ? nullptr
+        : cutCellStencils(amrlev, mglev);
+
     MFItInfo mfi_info;
-    if (Gpu::notInLaunchRegion()) mfi_info.EnableTiling().SetDynamic(true);
+    if (Gpu::notInLaunchRegion()) {
+        mfi_info.SetDynamic(true);
+        if (stencils == nullptr) mfi_info.EnableTiling();
+    }
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
@@ -733,6 +905,26 @@ MLEBABecLap::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) c
                                 AMREX_D_DECL(bxfab,byfab,bzfab),
                                 dxinvarr, ascalar, bscalar, ncomp);
             });
+        } else if (stencils) {
+            Array4<EBCellFlag const> const& flagfab = flags->const_array(mfi);
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+            {
+                mlebabeclap_adotx_regular(tbx, yfab, xfab, afab,
+                                          AMREX_D_DECL(bxfab,byfab,bzfab),
+                                          flagfab, dxinvarr, ascalar, bscalar, ncomp);
+            });
+
+            const CutCellStencil& st = (*stencils)[mfi];
+            const int ncells = st.cells.size();
+            IntVect const* cells = st.cells.data();
+            Real const* coefs = st.coefs.data();
+            AMREX_HOST_DEVICE_PARALLEL_FOR_1D ( ncells, ic,
+            {
+                for (int n = 0; n < ncomp; ++n) {
+                    Real const* s = coefs + (ic*ncomp+n)*mlebabeclap_stencil_size;
+                    yfab(cells[ic],n) = mlebabeclap_stencil_dot(cells[ic], n, xfab, s);
+                }
+            });
         } else {
             Array4<int const> const& ccmfab = ccmask.const_array(mfi);
             Array4<EBCellFlag const> const& flagfab = flags->const_array(mfi);
@@ -852,6 +1044,8 @@ MLEBABecLap::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
 
     bool is_eb_dirichlet =  isEBDirichlet();
 
+    auto stencils = cutCellStencils(amrlev, mglev);
+
     Array4<Real const> foo;
 
     MFItInfo mfi_info;
@@ -935,6 +1129,44 @@ MLEBABecLap::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                           vbx, redblack, nc);
             });
         }
+        else if (stencils)
+        {
+            Array4<EBCellFlag const> const& flagfab = flags->const_array(mfi);
+            Array4<Real const> const& vfracfab = vfrac->const_array(mfi);
+            AMREX_D_TERM(Array4<Real const> const& apxfab = area[0]->const_array(mfi);,
+                         Array4<Real const> const& apyfab = area[1]->const_array(mfi);,
+                         Array4<Real const> const& apzfab = area[2]->const_array(mfi););
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( vbx, thread_box,
+            {
+                mlebabeclap_gsrb_regular(thread_box, solnfab, rhsfab, alpha, afab,
+                                         AMREX_D_DECL(dhx, dhy, dhz),
+                                         AMREX_D_DECL(bxfab,byfab,bzfab),
+                                         AMREX_D_DECL(m0,m2,m4),
+                                         AMREX_D_DECL(m1,m3,m5),
+                                         AMREX_D_DECL(f0fab,f2fab,f4fab),
+                                         AMREX_D_DECL(f1fab,f3fab,f5fab),
+                                         flagfab, vbx, redblack, nc);
+            });
+
+            // The cut cells of this color, after the regular cells
+            const CutCellStencil& st = (*stencils)[mfi];
+            const int ncells = st.cells.size();
+            IntVect const* cells = st.cells.data();
+            Real const* coefs = st.coefs.data();
+            AMREX_HOST_DEVICE_FOR_1D ( ncells, ic,
+            {
+                mlebabeclap_gsrb_stencil(ic, cells, coefs, solnfab, rhsfab,
+                                         AMREX_D_DECL(dhx, dhy, dhz),
+                                         AMREX_D_DECL(bxfab,byfab,bzfab),
+                                         AMREX_D_DECL(m0,m2,m4),
+                                         AMREX_D_DECL(m1,m3,m5),
+                                         AMREX_D_DECL(f0fab,f2fab,f4fab),
+                                         AMREX_D_DECL(f1fab,f3fab,f5fab),
+                                         vfracfab, AMREX_D_DECL(apxfab,apyfab,apzfab),
+                                         vbx, redblack, nc);
+            });
+        }
         else
         {
             Array4<int const> const& ccmfab = ccmask.const_array(mfi);
@@ -1642,6 +1874,11 @@ MLEBABecLap::update ()
 
     averageDownCoeffs();
 
+    if (m_use_cut_stencils && m_cut_stencils_dirty) {
+        buildCutCellStencils();
+        m_cut_stencils_dirty = false;
+    }
+
     m_is_singular.clear();
     m_is_singular.resize(m_num_amr_levels, false);
     auto itlo = std::find(m_lobc[0].begin(), m_lobc[0].end(), BCType::Dirichlet);
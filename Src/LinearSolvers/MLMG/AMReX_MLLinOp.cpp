@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <unordered_map>
 #include <set>
+#include <limits>
+#include <sstream>
 #include <AMReX_Utility.H>
 #include <AMReX_MLLinOp.H>
 #include <AMReX_MLCellLinOp.H>
@@ -154,12 +156,24 @@ MLLinOp::define (const Vector<Geometry>& a_geom,
         if (info.con_grid_size <= 0) info.con_grid_size = LPInfo::getDefaultConsolidationGridSize();
     }
 
+    if (info.eb_bottom_grid_size <= 0) info.eb_bottom_grid_size = LPInfo::getDefaultEBBottomGridSize();
+
+    m_eb_limits_coarsening = false;
+    m_eb_coarsening_stop.clear();
 #ifdef AMREX_USE_EB
     if (!a_factory.empty() and eb_limit_coarsening) {
         auto f = dynamic_cast<EBFArrayBoxFactory const*>(a_factory[0]);
         if (f) {
-            info.max_coarsening_level = std::min(info.max_coarsening_level,
-                                                 f->maxCoarseningLevel());
+            const int eb_max_coarsening_level = f->maxCoarseningLevel();
+            if (eb_max_coarsening_level < info.max_coarsening_level) {
+                info.max_coarsening_level = eb_max_coarsening_level;
+                m_eb_limits_coarsening = true;
+                const EB2::IndexSpace* ebis = f->getEBIndexSpace();
+                if (ebis == nullptr) ebis = EB2::TopIndexSpaceIfPresent();
+                if (ebis) {
+                    m_eb_coarsening_stop = EB2::coarseningStopReason(ebis->coarseningStop());
+                }
+            }
         }
     }
 #endif
@@ -559,6 +573,60 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         }
     }
 
+    {
+        const int nlevs = m_num_mg_levels[0];
+        const Box& bottom_domain = m_geom[0].back().Domain();
+        const BoxArray& bottom_grids = m_grids[0].back();
+        const bool grids_coarsenable = (info.do_agglomeration && aggable)
+            ? bottom_grids.minimalBox().coarsenable(mg_coarsen_ratio, mg_box_min_width)
+            : bottom_grids.coarsenable(mg_coarsen_ratio, mg_box_min_width);
+        if (nlevs == info.max_coarsening_level + 1) {
+            if (m_eb_limits_coarsening) {
+                m_coarsening_stop = "the EB index space has no coarser level";
+                if (!m_eb_coarsening_stop.empty()) {
+                    m_coarsening_stop += ": " + m_eb_coarsening_stop;
+                }
+            } else {
+                m_coarsening_stop = "max_coarsening_level was reached";
+            }
+        } else if (!bottom_domain.coarsenable(mg_coarsen_ratio, mg_domain_min_width)) {
+            m_coarsening_stop = "the domain is not coarsenable";
+        } else if (!grids_coarsenable) {
+            m_coarsening_stop = "the boxes are not coarsenable";
+        } else if (info.do_semicoarsening) {
+            m_coarsening_stop = "max_semicoarsening_level was reached";
+        } else {
+            m_coarsening_stop = "unknown";
+        }
+    }
+
+    // The bottom level of an EB problem may have many small boxes
+    // because the EB index space cannot be coarsened further.  Unless
+    // it is agglomerated or consolidated already, merge its boxes and
+    // distribute them on as few ranks as they need.
+    bool merged = false;
+    if (m_eb_limits_coarsening && info.do_eb_bottom_merging && m_num_mg_levels[0] > 1
+        && !m_dmap[0].back().empty())
+    {
+        const BoxArray& bottom_grids = m_grids[0].back();
+        const Box& bbx = bottom_grids.minimalBox();
+        BoxArray ba;
+        if (bbx.numPts() == bottom_grids.numPts()) {
+            ba = BoxArray(bbx);
+        } else {
+            BoxList bl(bottom_grids);
+            bl.simplify();
+            ba = BoxArray(std::move(bl));
+        }
+        ba.maxSize(info.eb_bottom_grid_size);
+        if (ba.size() < bottom_grids.size())
+        {
+            m_dmap[0].back() = DistributionMapping(ba);
+            m_grids[0].back() = std::move(ba);
+            merged = true;
+        }
+    }
+
     for (int mglev = 0; mglev < m_num_mg_levels[0] - 1; mglev++){
         const Box& fine_domain = m_geom[0][mglev].Domain();
         const Box& crse_domain = m_geom[0][mglev+1].Domain();
@@ -579,7 +647,7 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         remapNeighborhoods(m_dmap[0]);
     }
 
-    if (agged || coned)
+    if (agged || coned || merged)
     {
         m_bottom_comm = makeSubCommunicator(m_dmap[0].back());
     }
@@ -602,6 +670,10 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
         } else {
             Print() << "MLLinOp::defineGrids(): no agglomeration or consolidation of AMR level 0" << std::endl;
         }
+        if (merged) {
+            Print() << "MLLinOp::defineGrids(): merged the boxes of the EB limited bottom level" << std::endl;
+        }
+        Print() << coarseningReport();
     }
 
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
@@ -619,6 +691,31 @@ MLLinOp::defineGrids (const Vector<Geometry>& a_geom,
     }
 }
 
+std::string
+MLLinOp::coarseningReport () const
+{
+    std::ostringstream os;
+    os << "MLLinOp: " << m_num_mg_levels[0] << " MG levels on AMR level 0\n";
+    for (int mglev = 0; mglev < m_num_mg_levels[0]; ++mglev)
+    {
+        const BoxArray& ba = m_grids[0][mglev];
+        int min_width = std::numeric_limits<int>::max();
+        for (int i = 0, N = ba.size(); i < N; ++i) {
+            min_width = std::min(min_width, ba[i].shortside());
+        }
+        os << "  MG level " << mglev << ": domain " << m_geom[0][mglev].Domain()
+           << ", " << ba.size() << " boxes, smallest width " << min_width;
+        if (ba.size() != m_grids[0][0].size()) {
+            os << (m_do_agglomeration ? ", agglomerated" : ", merged");
+        } else if (m_dmap[0][mglev] != m_dmap[0][0]) {
+            os << ", consolidated";
+        }
+        os << "\n";
+    }
+    os << "  Coarsening stopped because " << m_coarsening_stop << "\n";
+    return os.str();
+}
+
 void
 MLLinOp::defineAuxData ()
 {
@@ -0,0 +1,488 @@
+#include <AMReX_ParticleCompression.H>
+#include <AMReX.H>
+#include <AMReX_SPACE.H>
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+namespace amrex {
+
+bool
+ParticleIOCompression::isActive () const noexcept
+{
+    if (block_compress) return true;
+    for (const auto& c : pos_codecs) {
+        if (c.type != ParticleRealCodec::Native) return true;
+    }
+    for (const auto& c : real_codecs) {
+        if (c.type != ParticleRealCodec::Native) return true;
+    }
+    return false;
+}
+
+Vector<ParticleRealCodec>
+ParticleIOCompression::fileCodecs (const Vector<int>& write_real_comp) const
+{
+    Vector<ParticleRealCodec> codecs;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        codecs.push_back(d < pos_codecs.size() ? pos_codecs[d] : ParticleRealCodec());
+    }
+    for (int i = 0; i < write_real_comp.size(); ++i) {
+        if (write_real_comp[i]) {
+            codecs.push_back(i < real_codecs.size() ? real_codecs[i] : ParticleRealCodec());
+        }
+    }
+    for (const auto& c : codecs) {
+        if (c.type == ParticleRealCodec::Quantized && !(c.tolerance > 0.0)) {
+            amrex::Abort("ParticleIOCompression: Quantized codec needs a positive tolerance");
+        }
+    }
+    return codecs;
+}
+
+const std::string&
+ParticleIOCompression::Version ()
+{
+    static const std::string version("Version_Two_Dot_One");
+    return version;
+}
+
+namespace ParticleCompression {
+
+namespace {
+
+using Bytes = Vector<unsigned char>;
+
+std::uint64_t zigzag (std::int64_t v) noexcept
+{
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag (std::uint64_t u) noexcept
+{
+    return static_cast<std::int64_t>(u >> 1) ^ -static_cast<std::int64_t>(u & 1);
+}
+
+void putVarint (Bytes& buf, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        buf.push_back(static_cast<unsigned char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    buf.push_back(static_cast<unsigned char>(v));
+}
+
+struct ByteReader
+{
+    const unsigned char* p;
+    const unsigned char* end;
+
+    unsigned char byte ()
+    {
+        if (p == end) amrex::Abort("ParticleCompression: truncated grid record");
+        return *p++;
+    }
+
+    std::uint64_t varint ()
+    {
+        std::uint64_t v = 0;
+        int shift = 0;
+        unsigned char b;
+        do {
+            b = byte();
+            v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        return v;
+    }
+};
+
+void putFixed (Bytes& buf, std::uint64_t v, int nbytes)
+{
+    for (int b = 0; b < nbytes; ++b) {
+        buf.push_back(static_cast<unsigned char>(v >> (8*b)));
+    }
+}
+
+std::uint64_t getFixed (ByteReader& rd, int nbytes)
+{
+    std::uint64_t v = 0;
+    for (int b = 0; b < nbytes; ++b) {
+        v |= static_cast<std::uint64_t>(rd.byte()) << (8*b);
+    }
+    return v;
+}
+
+template <typename RTYPE>
+int codecWidth (const ParticleRealCodec& c) noexcept
+{
+    switch (c.type) {
+    case ParticleRealCodec::Float32: return 4;
+    case ParticleRealCodec::Float16: return 2;
+    case ParticleRealCodec::Quantized: return 0;
+    default: return sizeof(RTYPE);
+    }
+}
+
+template <typename RTYPE>
+std::uint64_t toBits (RTYPE v, const ParticleRealCodec& c) noexcept
+{
+    if (c.type == ParticleRealCodec::Float16) {
+        return floatToHalf(static_cast<float>(v));
+    } else if (c.type == ParticleRealCodec::Float32 || sizeof(RTYPE) == 4) {
+        const float f = static_cast<float>(v);
+        std::uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        return u;
+    } else {
+        const double d = static_cast<double>(v);
+        std::uint64_t u;
+        std::memcpy(&u, &d, sizeof(u));
+        return u;
+    }
+}
+
+template <typename RTYPE>
+RTYPE fromBits (std::uint64_t u, const ParticleRealCodec& c) noexcept
+{
+    if (c.type == ParticleRealCodec::Float16) {
+        return static_cast<RTYPE>(halfToFloat(static_cast<std::uint16_t>(u)));
+    } else if (c.type == ParticleRealCodec::Float32 || sizeof(RTYPE) == 4) {
+        const std::uint32_t u32 = static_cast<std::uint32_t>(u);
+        float f;
+        std::memcpy(&f, &u32, sizeof(f));
+        return static_cast<RTYPE>(f);
+    } else {
+        double d;
+        std::memcpy(&d, &u, sizeof(d));
+        return static_cast<RTYPE>(d);
+    }
+}
+
+// Runs of two or more zero bytes become a single control byte in [128,255];
+// everything else is copied as literal runs led by a control byte in [0,127].
+Bytes rleEncode (const Bytes& in)
+{
+    Bytes out;
+    out.reserve(in.size()/2 + 16);
+    const std::size_t n = in.size();
+    std::size_t i = 0;
+    while (i < n) {
+        if (in[i] == 0) {
+            std::size_t j = i;
+            while (j < n && in[j] == 0 && j-i < 128) ++j;
+            if (j-i >= 2) {
+                out.push_back(static_cast<unsigned char>(127 + (j-i)));
+                i = j;
+                continue;
+            }
+        }
+        const std::size_t start = i;
+        std::size_t j = i;
+        while (j < n && j-start < 128) {
+            if (in[j] == 0 && j+1 < n && in[j+1] == 0) break;
+            ++j;
+        }
+        out.push_back(static_cast<unsigned char>(j-start-1));
+        out.insert(out.end(), in.begin()+start, in.begin()+j);
+        i = j;
+    }
+    return out;
+}
+
+Bytes rleDecode (const Bytes& in, std::size_t raw_size)
+{
+    Bytes out;
+    out.reserve(raw_size);
+    const std::size_t n = in.size();
+    std::size_t i = 0;
+    while (i < n) {
+        const unsigned char c = in[i++];
+        if (c < 128) {
+            const std::size_t len = c + 1;
+            if (i + len > n) amrex::Abort("ParticleCompression: corrupt grid record");
+            out.insert(out.end(), in.begin()+i, in.begin()+i+len);
+            i += len;
+        } else {
+            out.insert(out.end(), static_cast<std::size_t>(c - 127), 0);
+        }
+    }
+    if (static_cast<std::size_t>(out.size()) != raw_size) amrex::Abort("ParticleCompression: corrupt grid record");
+    return out;
+}
+
+// A grid record is the decoded size and the stored size, both as 8 byte
+// little endian integers, followed by the stored bytes.
+void writeRecord (std::ostream& os, std::uint64_t raw_size, const Bytes& stored)
+{
+    unsigned char sizes[16];
+    for (int b = 0; b < 8; ++b) {
+        sizes[b]   = static_cast<unsigned char>(raw_size >> (8*b));
+        sizes[8+b] = static_cast<unsigned char>(static_cast<std::uint64_t>(stored.size()) >> (8*b));
+    }
+    os.write(reinterpret_cast<const char*>(sizes), 16);
+    os.write(reinterpret_cast<const char*>(stored.data()), stored.size());
+}
+
+template <typename RTYPE>
+void encodeGrid (std::ostream& os, Long np, const int* istuff, int ni,
+                 const RTYPE* rstuff, const Vector<ParticleRealCodec>& codecs,
+                 bool block_compress)
+{
+    const int nr = codecs.size();
+    Bytes raw;
+    raw.reserve(np*(ni + nr*sizeof(RTYPE)));
+
+    // Ids, cpus and the other int components are delta encoded column by column.
+    for (int c = 0; c < ni; ++c) {
+        std::int64_t prev = 0;
+        for (Long i = 0; i < np; ++i) {
+            const std::int64_t v = istuff[i*ni+c];
+            putVarint(raw, zigzag(v - prev));
+            prev = v;
+        }
+    }
+
+    Vector<std::uint64_t> column(np);
+    for (int c = 0; c < nr; ++c) {
+        const ParticleRealCodec& codec = codecs[c];
+        if (codec.type == ParticleRealCodec::Quantized) {
+            const double scale = 0.5/codec.tolerance;
+            std::int64_t prev = 0;
+            for (Long i = 0; i < np; ++i) {
+                const double x = static_cast<double>(rstuff[i*nr+c])*scale;
+                if (!(std::abs(x) < 4.e18)) {
+                    amrex::Abort("ParticleCompression: value out of range for Quantized codec");
+                }
+                const std::int64_t q = std::llround(x);
+                putVarint(raw, zigzag(q - prev));
+                prev = q;
+            }
+        } else {
+            const int w = codecWidth<RTYPE>(codec);
+            if (block_compress) {
+                // XOR with the previous value, then shuffle into byte planes so that
+                // the bytes that do not change become runs of zeros.
+                std::uint64_t prev = 0;
+                for (Long i = 0; i < np; ++i) {
+                    const std::uint64_t u = toBits(rstuff[i*nr+c], codec);
+                    column[i] = u ^ prev;
+                    prev = u;
+                }
+                for (int b = 0; b < w; ++b) {
+                    for (Long i = 0; i < np; ++i) {
+                        raw.push_back(static_cast<unsigned char>(column[i] >> (8*b)));
+                    }
+                }
+            } else {
+                for (Long i = 0; i < np; ++i) {
+                    putFixed(raw, toBits(rstuff[i*nr+c], codec), w);
+                }
+            }
+        }
+    }
+
+    if (block_compress) {
+        writeRecord(os, raw.size(), rleEncode(raw));
+    } else {
+        writeRecord(os, raw.size(), raw);
+    }
+}
+
+template <typename RTYPE>
+void decodeGrid (std::istream& is, Long np, int* istuff, int ni,
+                 RTYPE* rstuff, const Vector<ParticleRealCodec>& codecs,
+                 bool block_compress)
+{
+    const int nr = codecs.size();
+
+    unsigned char sizes[16];
+    is.read(reinterpret_cast<char*>(sizes), 16);
+    std::uint64_t raw_size = 0, stored_size = 0;
+    for (int b = 0; b < 8; ++b) {
+        raw_size    |= static_cast<std::uint64_t>(sizes[b])   << (8*b);
+        stored_size |= static_cast<std::uint64_t>(sizes[8+b]) << (8*b);
+    }
+
+    Bytes stored(stored_size);
+    is.read(reinterpret_cast<char*>(stored.data()), stored_size);
+    if (!is.good()) amrex::Abort("ParticleCompression: problem reading grid record");
+
+    Bytes raw = block_compress ? rleDecode(stored, raw_size) : std::move(stored);
+    ByteReader rd{raw.data(), raw.data() + raw.size()};
+
+    for (int c = 0; c < ni; ++c) {
+        std::int64_t prev = 0;
+        for (Long i = 0; i < np; ++i) {
+            prev += unzigzag(rd.varint());
+            istuff[i*ni+c] = static_cast<int>(prev);
+        }
+    }
+
+    Vector<std::uint64_t> column(np);
+    for (int c = 0; c < nr; ++c) {
+        const ParticleRealCodec& codec = codecs[c];
+        if (codec.type == ParticleRealCodec::Quantized) {
+            const double step = 2.0*codec.tolerance;
+            std::int64_t q = 0;
+            for (Long i = 0; i < np; ++i) {
+                q += unzigzag(rd.varint());
+                rstuff[i*nr+c] = static_cast<RTYPE>(q*step);
+            }
+        } else {
+            const int w = codecWidth<RTYPE>(codec);
+            if (block_compress) {
+                for (Long i = 0; i < np; ++i) column[i] = 0;
+                for (int b = 0; b < w; ++b) {
+                    for (Long i = 0; i < np; ++i) {
+                        column[i] |= static_cast<std::uint64_t>(rd.byte()) << (8*b);
+                    }
+                }
+                std::uint64_t prev = 0;
+                for (Long i = 0; i < np; ++i) {
+                    prev ^= column[i];
+                    rstuff[i*nr+c] = fromBits<RTYPE>(prev, codec);
+                }
+            } else {
+                for (Long i = 0; i < np; ++i) {
+                    rstuff[i*nr+c] = fromBits<RTYPE>(getFixed(rd, w), codec);
+                }
+            }
+        }
+    }
+}
+
+}
+
+void
+writeCodecs (std::ostream& os, bool block_compress, const Vector<ParticleRealCodec>& codecs)
+{
+    os << block_compress << '\n';
+    os << codecs.size() << '\n';
+    const auto old_prec = os.precision(17);
+    for (const auto& c : codecs) {
+        os << static_cast<int>(c.type) << ' ' << c.tolerance << '\n';
+    }
+    os.precision(old_prec);
+}
+
+void
+readCodecs (std::istream& is, bool& block_compress, Vector<ParticleRealCodec>& codecs)
+{
+    is >> block_compress;
+    int n;
+    is >> n;
+    codecs.resize(n);
+    for (auto& c : codecs) {
+        int type;
+        is >> type >> c.tolerance;
+        if (type < ParticleRealCodec::Native || type > ParticleRealCodec::Quantized) {
+            amrex::Abort("ParticleCompression::readCodecs: unknown codec");
+        }
+        c.type = static_cast<ParticleRealCodec::Type>(type);
+    }
+}
+
+void
+writeGrid (std::ostream& os, Long np, const int* istuff, int ni,
+           const float* rstuff, const Vector<ParticleRealCodec>& codecs, bool block_compress)
+{
+    encodeGrid(os, np, istuff, ni, rstuff, codecs, block_compress);
+}
+
+void
+writeGrid (std::ostream& os, Long np, const int* istuff, int ni,
+           const double* rstuff, const Vector<ParticleRealCodec>& codecs, bool block_compress)
+{
+    encodeGrid(os, np, istuff, ni, rstuff, codecs, block_compress);
+}
+
+void
+readGrid (std::istream& is, Long np, int* istuff, int ni,
+          float* rstuff, const Vector<ParticleRealCodec>& codecs, bool block_compress)
+{
+    decodeGrid(is, np, istuff, ni, rstuff, codecs, block_compress);
+}
+
+void
+readGrid (std::istream& is, Long np, int* istuff, int ni,
+          double* rstuff, const Vector<ParticleRealCodec>& codecs, bool block_compress)
+{
+    decodeGrid(is, np, istuff, ni, rstuff, codecs, block_compress);
+}
+
+std::uint16_t
+floatToHalf (float f) noexcept
+{
+    std::uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+
+    const std::uint32_t sign = (x >> 16) & 0x8000u;
+    std::uint32_t mant = x & 0x007fffffu;
+    const int exp = static_cast<int>((x >> 23) & 0xffu);
+
+    if (exp == 255) { // inf or nan
+        return static_cast<std::uint16_t>(sign | 0x7c00u | (mant ? 0x0200u : 0u));
+    }
+
+    const int e = exp - 127 + 15;
+    if (e >= 31) { // overflow
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+
+    if (e <= 0) { // subnormal half
+        if (e < -10) return static_cast<std::uint16_t>(sign);
+        mant |= 0x00800000u;
+        const int shift = 14 - e;
+        std::uint32_t h = mant >> shift;
+        const std::uint32_t rem = mant & ((1u << shift) - 1u);
+        const std::uint32_t half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1u))) ++h;
+        return static_cast<std::uint16_t>(sign | h);
+    }
+
+    // Round to nearest even; a carry out of the mantissa correctly bumps the exponent.
+    std::uint32_t h = (static_cast<std::uint32_t>(e) << 10) | (mant >> 13);
+    const std::uint32_t rem = mant & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) ++h;
+    return static_cast<std::uint16_t>(sign | h);
+}
+
+float
+halfToFloat (std::uint16_t h) noexcept
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+    int exp = (h >> 10) & 0x1f;
+    std::uint32_t mant = h & 0x03ffu;
+
+    std::uint32_t x;
+    if (exp == 0) {
+        if (mant == 0) {
+            x = sign;
+        } else {
+            exp = 1;
+            while (!(mant & 0x0400u)) {
+                mant <<= 1;
+                --exp;
+            }
+            mant &= 0x03ffu;
+            x = sign | (static_cast<std::uint32_t>(exp - 15 + 127) << 23) | (mant << 13);
+        }
+    } else if (exp == 31) {
+        x = sign | 0x7f800000u | (mant << 13);
+    } else {
+        x = sign | (static_cast<std::uint32_t>(exp - 15 + 127) << 23) | (mant << 13);
+    }
+
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+}
+
+}
@@ -0,0 +1,162 @@
+#include <AMReX_SharedParticleFile.H>
+#include <AMReX.H>
+#include <AMReX_FPC.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VectorIO.H>
+
+#include <fstream>
+
+namespace amrex {
+
+SharedParticleFile::SharedParticleFile (const std::string& dir)
+{
+    read(dir);
+}
+
+void
+SharedParticleFile::read (const std::string& dir)
+{
+    m_dir = dir;
+    if (!m_dir.empty() && m_dir[m_dir.size()-1] != '/') m_dir += '/';
+
+    const std::string HdrFileName = m_dir + "Header";
+    std::ifstream HdrFile(HdrFileName.c_str());
+    if (!HdrFile.good()) amrex::FileOpenFailed(HdrFileName);
+
+    std::string version;
+    HdrFile >> version;
+    if (version == Version() + "_single") {
+        m_real_size = 4;
+    } else if (version == Version() + "_double") {
+        m_real_size = 8;
+    } else {
+        amrex::Abort("SharedParticleFile: unknown version " + version);
+    }
+
+    int dm;
+    HdrFile >> dm;
+    if (dm != AMREX_SPACEDIM) {
+        amrex::Abort("SharedParticleFile: AMREX_SPACEDIM does not match the file");
+    }
+
+    int nr;
+    HdrFile >> nr;
+    m_real_comp_names.resize(nr);
+    for (auto& name : m_real_comp_names) HdrFile >> name;
+
+    int ni;
+    HdrFile >> ni;
+    m_int_comp_names.resize(ni);
+    for (auto& name : m_int_comp_names) HdrFile >> name;
+
+    int nchunks;
+    HdrFile >> m_nparticles >> nchunks;
+
+    m_chunks.resize(nchunks);
+    for (auto& c : m_chunks)
+    {
+        Real lo[AMREX_SPACEDIM], hi[AMREX_SPACEDIM];
+        HdrFile >> c.level >> c.grid >> c.count >> c.offset;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) HdrFile >> lo[d];
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) HdrFile >> hi[d];
+        c.box = RealBox(lo, hi);
+    }
+
+    if (!HdrFile.good()) {
+        amrex::Abort("SharedParticleFile: problem reading " + HdrFileName);
+    }
+}
+
+Vector<int>
+SharedParticleFile::chunksIntersecting (const RealBox& region) const
+{
+    Vector<int> r;
+    for (int i = 0; i < m_chunks.size(); ++i) {
+        if (m_chunks[i].box.intersects(region)) r.push_back(i);
+    }
+    return r;
+}
+
+void
+SharedParticleFile::readChunk (int i, Vector<double>& rdata, Vector<int>& idata) const
+{
+    const auto& c = m_chunks[i];
+
+    const std::string DataFile = m_dir + DataFileName();
+    std::ifstream is(DataFile.c_str(), std::ios::in | std::ios::binary);
+    if (!is.good()) amrex::FileOpenFailed(DataFile);
+    is.seekg(c.offset, std::ios::beg);
+
+    const std::size_t nint = c.count*numInt();
+    const std::size_t ioff = idata.size();
+    idata.resize(ioff + nint);
+    readIntData(idata.dataPtr() + ioff, nint, is, FPC::NativeIntDescriptor());
+
+    const std::size_t nreal = c.count*numReal();
+    const std::size_t roff = rdata.size();
+    rdata.resize(roff + nreal);
+    if (m_real_size == 4) {
+        Vector<float> tmp(nreal);
+        readFloatData(tmp.dataPtr(), nreal, is, FPC::Native32RealDescriptor());
+        for (std::size_t k = 0; k < nreal; ++k) rdata[roff+k] = tmp[k];
+    } else {
+        readDoubleData(rdata.dataPtr() + roff, nreal, is, FPC::Native64RealDescriptor());
+    }
+
+    if (!is.good()) {
+        amrex::Abort("SharedParticleFile: problem reading " + DataFile);
+    }
+}
+
+Long
+SharedParticleFile::readRegion (const RealBox& region, Vector<double>& rdata,
+                                Vector<int>& idata) const
+{
+    rdata.clear();
+    idata.clear();
+
+    const int nr = numReal();
+    const int ni = numInt();
+
+    Vector<double> rchunk;
+    Vector<int> ichunk;
+    Long np = 0;
+    for (int i : chunksIntersecting(region))
+    {
+        rchunk.clear();
+        ichunk.clear();
+        readChunk(i, rchunk, ichunk);
+
+        for (Long k = 0; k < m_chunks[i].count; ++k)
+        {
+            const double* pr = rchunk.dataPtr() + k*nr;
+            bool inside = true;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                inside = inside && region.lo(d) <= pr[d] && pr[d] < region.hi(d);
+            }
+            if (inside) {
+                rdata.insert(rdata.end(), pr, pr + nr);
+                const int* pi = ichunk.dataPtr() + k*ni;
+                idata.insert(idata.end(), pi, pi + ni);
+                ++np;
+            }
+        }
+    }
+    return np;
+}
+
+const std::string&
+SharedParticleFile::Version ()
+{
+    static const std::string version("Shared_Version_One");
+    return version;
+}
+
+const std::string&
+SharedParticleFile::DataFileName ()
+{
+    static const std::string name("DATA");
+    return name;
+}
+
+}
@@ -0,0 +1,224 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Derive.H>
+#include <AMReX_Print.H>
+
+#include <AmrTestLevel.H>
+
+using namespace amrex;
+
+namespace {
+    // A gas with density, x- and y-momentum and energy, and a temperature
+    // in another state type with another interpolater.
+    const Vector<int> ncomps{4, 1};
+}
+
+void derPressure (const Box& bx, FArrayBox& derfab, int dcomp, int /*ncomp*/,
+                  const FArrayBox& datafab, const Geometry& /*geomdata*/,
+                  Real /*time*/, const int* /*bcrec*/, int /*level*/)
+{
+    auto const& p = derfab.array();
+    auto const& s = datafab.const_array();
+    amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+    {
+        p(i,j,k,dcomp) = 0.4*(s(i,j,k,3) - 0.5*(s(i,j,k,1)*s(i,j,k,1)
+                                                + s(i,j,k,2)*s(i,j,k,2))/s(i,j,k,0));
+    });
+}
+
+// Velocity in direction dir, from the density and the momentum.
+DeriveFuncFabLambda makeVelocity (int dir)
+{
+    return [dir] (const Box& bx, FArrayBox& derfab, int dcomp, int /*ncomp*/,
+                  const FArrayBox& datafab, const Geometry& /*geomdata*/,
+                  Real /*time*/, const int* /*bcrec*/, int /*level*/)
+    {
+        auto const& u = derfab.array();
+        auto const& s = datafab.const_array();
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            u(i,j,k,dcomp) = s(i,j,k,1)/s(i,j,k,0) + 0.01*dir;
+        });
+    };
+}
+
+void derDrhodx (const Box& bx, FArrayBox& derfab, int dcomp, int /*ncomp*/,
+                const FArrayBox& datafab, const Geometry& geomdata,
+                Real /*time*/, const int* /*bcrec*/, int /*level*/)
+{
+    const Real dxinv = geomdata.InvCellSize(0);
+    auto const& d = derfab.array();
+    auto const& s = datafab.const_array();
+    amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+    {
+        d(i,j,k,dcomp) = 0.5*dxinv*(s(i+1,j,k) - s(i-1,j,k));
+    });
+}
+
+// Two components: the temperature times the density, and the time.
+void derTwo (const Box& bx, FArrayBox& derfab, int dcomp, int /*ncomp*/,
+             const FArrayBox& datafab, const Geometry& /*geomdata*/,
+             Real time, const int* /*bcrec*/, int level)
+{
+    auto const& d = derfab.array();
+    auto const& s = datafab.const_array();
+    amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+    {
+        d(i,j,k,dcomp) = s(i,j,k,0)*s(i,j,k,1);
+        d(i,j,k,dcomp+1) = time + level;
+    });
+}
+
+class DeriveLevel
+    : public TestLevel
+{
+public:
+    using TestLevel::TestLevel;
+
+    static void variableSetUp ()
+    {
+        int lo_bc[AMREX_SPACEDIM];
+        int hi_bc[AMREX_SPACEDIM];
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            lo_bc[i] = hi_bc[i] = BCType::int_dir;
+        }
+        lo_bc[0] = hi_bc[0] = BCType::foextrap;
+        BCRec bc(lo_bc, hi_bc);
+
+        const Vector<std::string> names{"rho", "xmom", "ymom", "E"};
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               ncomps[0], &cell_cons_interp);
+        for (int n = 0; n < ncomps[0]; ++n) {
+            desc_lst.setComponent(0, n, names[n], bc, StateDescriptor::BndryFunc(constFill));
+        }
+        desc_lst.addDescriptor(1, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               ncomps[1], &lincc_interp);
+        desc_lst.setComponent(1, 0, "T", bc, StateDescriptor::BndryFunc(constFill));
+
+        derive_lst.add("pressure", IndexType::TheCellType(), 1, derPressure,
+                       DeriveRec::TheSameBox);
+        derive_lst.addComponent("pressure", desc_lst, 0, 0, 4);
+
+        derive_lst.add("x_velocity", IndexType::TheCellType(), 1, makeVelocity(0),
+                       DeriveRec::TheSameBox);
+        derive_lst.addComponent("x_velocity", desc_lst, 0, 0, 1);
+        derive_lst.addComponent("x_velocity", desc_lst, 0, 1, 1);
+
+        derive_lst.add("y_velocity", IndexType::TheCellType(), 1, makeVelocity(1),
+                       DeriveRec::TheSameBox);
+        derive_lst.addComponent("y_velocity", desc_lst, 0, 0, 1);
+        derive_lst.addComponent("y_velocity", desc_lst, 0, 2, 1);
+
+        derive_lst.add("drhodx", IndexType::TheCellType(), 1, derDrhodx,
+                       DeriveRec::GrowBoxByOne);
+        derive_lst.addComponent("drhodx", desc_lst, 0, 0, 1);
+
+        derive_lst.add("two", IndexType::TheCellType(), 2, derTwo,
+                       DeriveRec::TheSameBox);
+        derive_lst.addComponent("two", desc_lst, 1, 0, 1);
+        derive_lst.addComponent("two", desc_lst, 0, 0, 1);
+    }
+};
+
+TestLevelBld<DeriveLevel> test_bld;
+
+LevelBld* getLevelBld ()
+{
+    return &test_bld;
+}
+
+// Derive the names at time, one by one and all at once, and return the
+// number of differences.
+int compareDerive (AmrLevel& amrlevel, const Vector<std::string>& names, Real time, int ngrow)
+{
+    int ncomp = 0;
+    for (const auto& name : names) {
+        const DeriveRec* rec = AmrLevel::get_derive_lst().get(name);
+        ncomp += (rec == nullptr) ? 1 : rec->numDerive();
+    }
+
+    const BoxArray& ba = amrlevel.boxArray();
+    const DistributionMapping& dm = amrlevel.DistributionMap();
+    MultiFab separate(ba, dm, ncomp+1, ngrow);
+    MultiFab batched(ba, dm, ncomp+1, ngrow);
+    separate.setVal(-1.0);
+    batched.setVal(-1.0);
+
+    for (int i = 0, dcomp = 1; i < names.size(); ++i)
+    {
+        amrlevel.derive(names[i], time, separate, dcomp);
+        const DeriveRec* rec = AmrLevel::get_derive_lst().get(names[i]);
+        dcomp += (rec == nullptr) ? 1 : rec->numDerive();
+    }
+    amrlevel.derive(names, time, batched, 1);
+
+    int nerrors = 0;
+    Long ndiff = 0, nunset = 0;
+    for (MFIter mfi(separate); mfi.isValid(); ++mfi)
+    {
+        auto const& a = separate.const_array(mfi);
+        auto const& b = batched.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp+1, [&] (int i, int j, int k, int n) noexcept
+        {
+            if (a(i,j,k,n) != b(i,j,k,n)) ++ndiff;
+            if (n > 0 && a(i,j,k,n) == -1.0) ++nunset;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    ParallelDescriptor::ReduceLongSum(nunset);
+    if (ndiff > 0) {
+        amrex::Print() << "  level " << amrlevel.Level() << ": " << ndiff << " values differ\n";
+        ++nerrors;
+    }
+    if (nunset > 0) {
+        amrex::Print() << "  level " << amrlevel.Level() << ": " << nunset << " values not derived\n";
+        ++nerrors;
+    }
+    return nerrors;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        Amr amr;
+        amr.init(0.0, 1.0);
+
+        // New data at time 1, and old data at time 0.
+        for (int lev = 0; lev <= amr.finestLevel(); ++lev)
+        {
+            auto& amrlevel = static_cast<TestLevel&>(amr.getLevel(lev));
+            for (int idx = 0; idx < ncomps.size(); ++idx) {
+                amrlevel.get_state_data(idx).allocOldData();
+                amrlevel.get_state_data(idx).swapTimeLevels(1.0);
+            }
+            amrlevel.setData(2.0);
+        }
+
+        // Derived quantities that share their state data, whose ranges
+        // are or are not next to each other in the shared data, that need
+        // more ghost cells, with more than one component, in two state
+        // types, and a state variable.
+        const Vector<std::string> names{"pressure", "rho", "x_velocity", "drhodx",
+                                        "two", "y_velocity"};
+
+        int nerrors = 0;
+        for (int lev = 0; lev <= amr.finestLevel(); ++lev)
+        {
+            AmrLevel& amrlevel = amr.getLevel(lev);
+            amrex::Print() << "Level " << lev << ": " << amrlevel.boxArray().size() << " grids\n";
+            for (Real time : {0.25, 1.0}) {
+                for (int ngrow : {0, 1}) {
+                    nerrors += compareDerive(amrlevel, names, time, ngrow);
+                }
+            }
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("BatchedDerive: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "BatchedDerive: the data are the same as with separate derive\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,146 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <AmrTestLevel.H>
+
+using namespace amrex;
+
+namespace {
+    // Three state types with different numbers of components, the second
+    // one with two different interpolaters.
+    const Vector<int> ncomps{2, 3, 1};
+}
+
+class FillPatchLevel
+    : public TestLevel
+{
+public:
+    using TestLevel::TestLevel;
+
+    static void variableSetUp ()
+    {
+        int lo_bc[AMREX_SPACEDIM];
+        int hi_bc[AMREX_SPACEDIM];
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            lo_bc[i] = hi_bc[i] = BCType::int_dir;
+        }
+        lo_bc[0] = hi_bc[0] = BCType::foextrap;
+        BCRec bc(lo_bc, hi_bc);
+
+        for (int idx = 0; idx < ncomps.size(); ++idx)
+        {
+            desc_lst.addDescriptor(idx, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                                   ncomps[idx], &cell_cons_interp);
+            for (int n = 0; n < ncomps[idx]; ++n) {
+                const std::string name = "s" + std::to_string(idx) + "_" + std::to_string(n);
+                if (idx == 1 && n == 2) {
+                    desc_lst.setComponent(idx, n, name, bc, StateDescriptor::BndryFunc(constFill),
+                                          &pc_interp);
+                } else {
+                    desc_lst.setComponent(idx, n, name, bc, StateDescriptor::BndryFunc(constFill));
+                }
+            }
+        }
+    }
+};
+
+TestLevelBld<FillPatchLevel> test_bld;
+
+LevelBld* getLevelBld ()
+{
+    return &test_bld;
+}
+
+// Fill the state types at time on ba, one by one and all at once, and
+// return the number of differences.
+int compareFillPatch (AmrLevel& amrlevel, const BoxArray& ba, const DistributionMapping& dm,
+                      Real time, const Vector<int>& scomp, const Vector<int>& ncomp)
+{
+    const int ngrow = 2;
+    const int nstates = ncomps.size();
+    Vector<std::unique_ptr<MultiFab> > separate, batched;
+    Vector<int> index, dcomp;
+    for (int idx = 0; idx < nstates; ++idx)
+    {
+        separate.emplace_back(new MultiFab(ba, dm, ncomp[idx]+1, ngrow+1));
+        batched.emplace_back(new MultiFab(ba, dm, ncomp[idx]+1, ngrow+1));
+        separate.back()->setVal(-1.0);
+        batched.back()->setVal(-1.0);
+        index.push_back(idx);
+        dcomp.push_back(1);
+    }
+
+    for (int idx = 0; idx < nstates; ++idx) {
+        AmrLevel::FillPatch(amrlevel, *separate[idx], ngrow, time, idx, scomp[idx], ncomp[idx], 1);
+    }
+    AmrLevel::FillPatch(amrlevel, GetVecOfPtrs(batched), ngrow, time, index, scomp, ncomp, dcomp);
+
+    int nerrors = 0;
+    for (int idx = 0; idx < nstates; ++idx)
+    {
+        Long ndiff = 0;
+        for (MFIter mfi(*separate[idx]); mfi.isValid(); ++mfi)
+        {
+            auto const& a = separate[idx]->const_array(mfi);
+            auto const& b = batched[idx]->const_array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), separate[idx]->nComp(), [&] (int i, int j, int k, int n) noexcept
+            {
+                if (a(i,j,k,n) != b(i,j,k,n)) ++ndiff;
+            });
+        }
+        ParallelDescriptor::ReduceLongSum(ndiff);
+        if (ndiff > 0) {
+            amrex::Print() << "  level " << amrlevel.Level() << " state " << idx << ": "
+                           << ndiff << " values differ\n";
+            ++nerrors;
+        }
+    }
+    return nerrors;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        Amr amr;
+        amr.init(0.0, 1.0);
+
+        // New data at time 1, and old data at time 0.
+        for (int lev = 0; lev <= amr.finestLevel(); ++lev)
+        {
+            auto& amrlevel = static_cast<TestLevel&>(amr.getLevel(lev));
+            for (int idx = 0; idx < ncomps.size(); ++idx) {
+                amrlevel.get_state_data(idx).allocOldData();
+                amrlevel.get_state_data(idx).swapTimeLevels(1.0);
+            }
+            amrlevel.setData(2.0);
+        }
+
+        int nerrors = 0;
+        for (int lev = 0; lev <= amr.finestLevel(); ++lev)
+        {
+            AmrLevel& amrlevel = amr.getLevel(lev);
+            amrex::Print() << "Level " << lev << ": " << amrlevel.boxArray().size() << " grids\n";
+
+            BoxArray ba = amrlevel.boxArray();
+            ba.maxSize(8);
+            DistributionMapping dm(ba);
+            for (Real time : {0.0, 0.25, 1.0})
+            {
+                // All the components, and a part of them
+                nerrors += compareFillPatch(amrlevel, amrlevel.boxArray(),
+                                            amrlevel.DistributionMap(), time,
+                                            {0,0,0}, ncomps);
+                nerrors += compareFillPatch(amrlevel, ba, dm, time, {1,1,0}, {1,2,1});
+            }
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("BatchedFillPatch: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "BatchedFillPatch: the data are the same as with separate FillPatch\n";
+    }
+    amrex::Finalize();
+}
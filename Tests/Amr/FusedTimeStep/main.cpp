@@ -0,0 +1,118 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <AmrTestLevel.H>
+
+using namespace amrex;
+
+// Advection with the same dt on all the levels, stable on the finest one.
+class FusedLevel
+    : public AdvectionLevel
+{
+public:
+    using AdvectionLevel::AdvectionLevel;
+
+    virtual void setDt (Vector<Real>& dt_level) const override
+    {
+        const Real dt = 0.4 * parent->Geom(parent->maxLevel()).CellSize(0);
+        for (auto& dt_lev : dt_level) dt_lev = dt;
+    }
+};
+
+TestLevelBld<FusedLevel> test_bld;
+
+LevelBld* getLevelBld ()
+{
+    return &test_bld;
+}
+
+// Run nsteps coarse steps, and return the data of all the levels.
+Vector<std::unique_ptr<MultiFab> > run (const std::string& mode, int nsteps)
+{
+    {
+        ParmParse pp("amr");
+        pp.add("subcycling_mode", mode);
+    }
+    auto& stats = AdvectionLevel::stats();
+    stats = AdvectionLevel::Stats();
+
+    Amr amr;
+    amr.init(0.0, 1.0);
+
+    for (int step = 1; step <= nsteps; ++step) {
+        amr.coarseTimeStep(1.0);
+    }
+
+    amrex::Print() << mode << ": " << amr.finestLevel()+1 << " levels, "
+                   << stats.n_prefilled << " advances with and " << stats.n_not_prefilled
+                   << " without prefilled ghost cells, "
+                   << stats.n_async_reflux << " split-phase and " << stats.n_blocking_reflux
+                   << " blocking refluxes\n";
+
+    Vector<std::unique_ptr<MultiFab> > r;
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        const MultiFab& S = amr.getLevel(lev).get_new_data(0);
+        r.emplace_back(new MultiFab(S.boxArray(), S.DistributionMap(), 1, 0));
+        MultiFab::Copy(*r.back(), S, 0, 0, 1, 0);
+    }
+    return r;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nsteps = 6;
+        {
+            ParmParse pp("fused");
+            pp.query("nsteps", nsteps);
+        }
+
+        int nerrors = 0;
+        auto none = run("None", nsteps);
+        auto fused = run("Fused", nsteps);
+
+        const auto& stats = AdvectionLevel::stats();
+
+        if (stats.n_not_prefilled != 0 || stats.n_prefilled == 0) {
+            amrex::Print() << "  the fused step did not prefill the ghost cells\n";
+            ++nerrors;
+        }
+        if (stats.n_blocking_reflux != 0 || stats.n_async_reflux == 0) {
+            amrex::Print() << "  the fused step did not start the refluxes\n";
+            ++nerrors;
+        }
+
+        if (none.size() != fused.size() || none.size() < 2) {
+            amrex::Print() << "The numbers of levels differ\n";
+            ++nerrors;
+        }
+        else
+        {
+            for (int lev = 0, N = none.size(); lev < N; ++lev)
+            {
+                if (none[lev]->boxArray() != fused[lev]->boxArray()) {
+                    amrex::Print() << "Level " << lev << ": the grids differ\n";
+                    ++nerrors;
+                    continue;
+                }
+                MultiFab tmp(none[lev]->boxArray(), none[lev]->DistributionMap(), 1, 0);
+                tmp.ParallelCopy(*fused[lev], 0, 0, 1);
+                MultiFab::Subtract(tmp, *none[lev], 0, 0, 1, 0);
+                const Real diff = tmp.norm0(0);
+                if (diff != 0.0) {
+                    amrex::Print() << "Level " << lev << ": the data differ by " << diff << "\n";
+                    ++nerrors;
+                }
+            }
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("FusedTimeStep: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "FusedTimeStep: the data are the same as without the fused step\n";
+    }
+    amrex::Finalize();
+}
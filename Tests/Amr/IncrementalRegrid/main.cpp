@@ -0,0 +1,181 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <AmrTestLevel.H>
+
+#include <map>
+
+using namespace amrex;
+
+namespace {
+    constexpr int NUM_STATE = 2;
+}
+
+class RegridLevel
+    : public TestLevel
+{
+public:
+    using TestLevel::TestLevel;
+
+    static void variableSetUp ()
+    {
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               NUM_STATE, &cell_cons_interp);
+        int lo_bc[AMREX_SPACEDIM];
+        int hi_bc[AMREX_SPACEDIM];
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            lo_bc[i] = hi_bc[i] = BCType::int_dir;
+        }
+        BCRec bc(lo_bc, hi_bc);
+        desc_lst.setComponent(0, 0, "phi", bc, StateDescriptor::BndryFunc(nullFill));
+        desc_lst.setComponent(0, 1, "psi", bc, StateDescriptor::BndryFunc(nullFill));
+    }
+
+    virtual void initData () override
+    {
+        MultiFab& S_new = get_new_data(0);
+        const auto dx = geom.CellSizeArray();
+        const int lev = level;
+        for (MFIter mfi(S_new); mfi.isValid(); ++mfi)
+        {
+            auto const& s = S_new.array(mfi);
+            amrex::ParallelFor(mfi.validbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                const Real x = (i+0.5)*dx[0];
+                s(i,j,k,0) = std::sin(6.0*x) + 0.001*lev;
+                s(i,j,k,1) = std::cos(4.0*x) + i + 2*j + 3*k;
+            });
+        }
+    }
+};
+
+TestLevelBld<RegridLevel> test_bld;
+
+LevelBld* getLevelBld ()
+{
+    return &test_bld;
+}
+
+class TestAmr
+    : public Amr
+{
+public:
+    explicit TestAmr (bool incremental)
+    {
+        SetIncrementalRegrid(incremental);
+    }
+
+    void regridAll () { regrid(0, cumTime()); }
+};
+
+// Run the regrids, and return the data of all the levels on their last grids.
+Vector<std::unique_ptr<MultiFab> > run (bool incremental, int nsteps, int& nerrors)
+{
+    // The center of the refined region, moved between the regrids.
+    Real& xcenter = TestLevel::tagCenter();
+    xcenter = 0.3;
+    TestAmr amr(incremental);
+    amr.init(0.0, 1.0);
+
+    for (int step = 1; step <= nsteps; ++step)
+    {
+        // The data pointers of the grids of the finer levels.
+        Vector<std::map<Box,const Real*> > ptrs(amr.finestLevel()+1);
+        for (int lev = 1; lev <= amr.finestLevel(); ++lev) {
+            const MultiFab& S = amr.getLevel(lev).get_new_data(0);
+            for (MFIter mfi(S); mfi.isValid(); ++mfi) {
+                ptrs[lev][mfi.validbox()] = S[mfi].dataPtr();
+            }
+        }
+
+        xcenter += 0.04;
+        amr.regridAll();
+
+        for (int lev = 1; lev <= std::min(amr.finestLevel(), static_cast<int>(ptrs.size())-1); ++lev)
+        {
+            const MultiFab& S = amr.getLevel(lev).get_new_data(0);
+            Long nkept = 0, nmoved = 0;
+            for (MFIter mfi(S); mfi.isValid(); ++mfi) {
+                auto it = ptrs[lev].find(mfi.validbox());
+                if (it != ptrs[lev].end()) {
+                    ++nkept;
+                    if (it->second == S[mfi].dataPtr()) ++nmoved;
+                }
+            }
+            ParallelDescriptor::ReduceLongSum(nkept);
+            ParallelDescriptor::ReduceLongSum(nmoved);
+            if (incremental) {
+                amrex::Print() << "Step " << step << " level " << lev << ": " << nkept
+                               << " of " << S.boxArray().size() << " grids kept\n";
+                if (nkept == 0 || nmoved != nkept) {
+                    amrex::Print() << "  " << nmoved << " of the kept grids were moved\n";
+                    ++nerrors;
+                }
+            } else if (nmoved != 0) {
+                amrex::Print() << "  " << nmoved << " grids were moved without incremental regrid\n";
+                ++nerrors;
+            }
+        }
+    }
+
+    Vector<std::unique_ptr<MultiFab> > r;
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        const MultiFab& S = amr.getLevel(lev).get_new_data(0);
+        r.emplace_back(new MultiFab(S.boxArray(), S.DistributionMap(), NUM_STATE, 0));
+        MultiFab::Copy(*r.back(), S, 0, 0, NUM_STATE, 0);
+    }
+    return r;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nsteps = 4;
+        {
+            ParmParse pp("regrid");
+            pp.query("nsteps", nsteps);
+        }
+
+        int nerrors = 0;
+        auto full = run(false, nsteps, nerrors);
+        auto incr = run(true, nsteps, nerrors);
+
+        if (full.size() != incr.size()) {
+            amrex::Print() << "The numbers of levels differ\n";
+            ++nerrors;
+        }
+        else
+        {
+            // The grids cover the same region, and the data must be the same.
+            for (int lev = 0, N = full.size(); lev < N; ++lev)
+            {
+                const BoxArray& fba = full[lev]->boxArray();
+                const BoxArray& iba = incr[lev]->boxArray();
+                if (fba.numPts() != iba.numPts() || !fba.contains(iba) || !iba.contains(fba)) {
+                    amrex::Print() << "Level " << lev << ": the grids cover different regions\n";
+                    ++nerrors;
+                    continue;
+                }
+                MultiFab tmp(fba, full[lev]->DistributionMap(), NUM_STATE, 0);
+                tmp.ParallelCopy(*incr[lev], 0, 0, NUM_STATE);
+                MultiFab::Subtract(tmp, *full[lev], 0, 0, NUM_STATE, 0);
+                const Real diff = tmp.norm0(0);
+                const Real diff1 = tmp.norm0(1);
+                if (std::max(diff,diff1) != 0.0) {
+                    amrex::Print() << "Level " << lev << ": the data differ by "
+                                   << std::max(diff,diff1) << "\n";
+                    ++nerrors;
+                }
+            }
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("IncrementalRegrid: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "IncrementalRegrid: the data are the same as with a full regrid\n";
+    }
+    amrex::Finalize();
+}
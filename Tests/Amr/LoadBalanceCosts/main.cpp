@@ -0,0 +1,265 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_LayoutData.H>
+#include <AMReX_Print.H>
+
+#include <AmrTestLevel.H>
+
+using namespace amrex;
+
+namespace {
+    // Seconds of extra work per step for each cell with x < 0.25
+    const Real work_per_cell = 2.e-7;
+    // Seconds of extra work per step for each box with HeavyLevel::unbalancedLevel0
+    const Real work_per_box = 1.e-4;
+}
+
+// Wait for seconds.
+void work (Real seconds)
+{
+    const double t0 = ParallelDescriptor::second();
+    while (ParallelDescriptor::second() - t0 < seconds) {}
+}
+
+// The number of cells of bx with x < 0.25.
+Long heavyCells (const Box& bx, const Geometry& geom)
+{
+    Box heavy = geom.Domain();
+    heavy.setBig(0, geom.Domain().smallEnd(0) + geom.Domain().length(0)/4 - 1);
+    heavy &= bx;
+    return heavy.ok() ? heavy.numPts() : 0;
+}
+
+// The cost of the heavy cells on each rank over the cost on the busiest one.
+Real heavyEfficiency (const BoxArray& ba, const DistributionMapping& dm, const Geometry& geom)
+{
+    Vector<Real> cost(ba.size());
+    for (int i = 0; i < ba.size(); ++i) {
+        cost[i] = static_cast<Real>(heavyCells(ba[i], geom)) + 1.0;
+    }
+    Real eff;
+    DistributionMapping::ComputeDistributionMappingEfficiency(dm, cost, &eff);
+    return eff;
+}
+
+// Advection where the cells with x < 0.25 take more time.
+class HeavyLevel
+    : public AdvectionLevel
+{
+public:
+    HeavyLevel () noexcept {}
+
+    HeavyLevel (Amr& papa, int lev, const Geometry& level_geom,
+                const BoxArray& ba, const DistributionMapping& dm, Real time)
+        : AdvectionLevel(papa, lev, level_geom, ba, dm, time)
+    {
+        if (lev > 0) {
+            crse_dmap = papa.DistributionMap(lev-1);
+        }
+    }
+
+    virtual void extraWork (const Box& bx) override
+    {
+        if (!unbalancedLevel0()) {
+            work(work_per_cell * heavyCells(bx, geom));
+        } else if (level > 0 || ParallelDescriptor::MyProc() == 0) {
+            work(work_per_box);
+        }
+    }
+
+    /**
+    * \brief Make the boxes of level 0 heavy on the first process only, and
+    * give all the boxes of the finer levels the same cost.  All the boxes
+    * have the same size, so the finer levels are already balanced.
+    */
+    static bool& unbalancedLevel0 () { static bool b = false; return b; }
+
+    //! The distribution of the coarser level when this level was built,
+    //! which a YAFluxRegister or an EBFluxRegister would be defined on.
+    DistributionMapping crse_dmap;
+};
+
+TestLevelBld<HeavyLevel> test_bld;
+
+LevelBld* getLevelBld ()
+{
+    return &test_bld;
+}
+
+// Check that the finer levels were built on the current distribution of
+// the level below.
+int checkFinerLevels (Amr& amr, int step)
+{
+    int nerrors = 0;
+    for (int lev = 1; lev <= amr.finestLevel(); ++lev) {
+        if (static_cast<HeavyLevel&>(amr.getLevel(lev)).crse_dmap != amr.DistributionMap(lev-1)) {
+            amrex::Print() << "  step " << step << ": level " << lev
+                           << " was not built again on the distribution of level " << lev-1 << "\n";
+            ++nerrors;
+        }
+    }
+    return nerrors;
+}
+
+// Run nsteps coarse steps, and return the data of all the levels.
+Vector<std::unique_ptr<MultiFab> > run (int with_costs, int nsteps, int& nerrors)
+{
+    {
+        ParmParse pp("amr");
+        pp.add("loadbalance_with_costs", with_costs);
+    }
+
+    Amr amr;
+    amr.init(0.0, 1.0);
+
+    const DistributionMapping dm0 = amr.DistributionMap(0);
+    const Real eff0 = heavyEfficiency(amr.boxArray(0), dm0, amr.Geom(0));
+
+    for (int step = 1; step <= nsteps; ++step) {
+        amr.coarseTimeStep(1.0);
+        nerrors += checkFinerLevels(amr, step);
+    }
+
+    // Level 0 is not regridded, so its distribution only changes if it is
+    // load balanced.
+    const Real eff = heavyEfficiency(amr.boxArray(0), amr.DistributionMap(0), amr.Geom(0));
+    amrex::Print() << "loadbalance_with_costs = " << with_costs << ": " << amr.finestLevel()+1
+                   << " levels, efficiency of level 0 by the extra work " << eff0
+                   << " -> " << eff << "\n";
+    if (with_costs && ParallelDescriptor::NProcs() > 1 && amr.DistributionMap(0) == dm0) {
+        amrex::Print() << "  level 0 was not redistributed\n";
+        ++nerrors;
+    }
+
+    Vector<std::unique_ptr<MultiFab> > r;
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev) {
+        const MultiFab& S = amr.getLevel(lev).get_new_data(0);
+        r.emplace_back(new MultiFab(S.boxArray(), S.DistributionMap(), 1, 0));
+        MultiFab::Copy(*r.back(), S, 0, 0, 1, 0);
+    }
+    return r;
+}
+
+// Only level 0 is redistributed.  The finer levels must still be built
+// again on its new distribution.
+int testFinerLevels (int nsteps)
+{
+    {
+        ParmParse pp("amr");
+        pp.add("loadbalance_with_costs", 1);
+        pp.add("loadbalance_efficiency_threshold", 1.5);
+    }
+    HeavyLevel::unbalancedLevel0() = true;
+
+    Amr amr;
+    amr.init(0.0, 1.0);
+    const DistributionMapping dm0 = amr.DistributionMap(0);
+
+    int nerrors = 0;
+    for (int step = 1; step <= nsteps; ++step) {
+        amr.coarseTimeStep(1.0);
+        nerrors += checkFinerLevels(amr, step);
+    }
+    if (ParallelDescriptor::NProcs() > 1 && amr.DistributionMap(0) == dm0) {
+        amrex::Print() << "  level 0 was not redistributed when unbalanced\n";
+        ++nerrors;
+    }
+
+    HeavyLevel::unbalancedLevel0() = false;
+    return nerrors;
+}
+
+// Time some work on half of the boxes, and check that the costs show it.
+int testCostTimer ()
+{
+    BoxArray ba(Box(IntVect(0), IntVect(15)));
+    ba.maxSize(8);
+    DistributionMapping dm(ba);
+    MultiFab mf(ba, dm, 1, 0);
+    BoxArray ba2 = ba;
+    ba2.maxSize(4);
+    MultiFab other(ba2, DistributionMapping(ba2), 1, 0);
+    MultiFab copied(ba, DistributionMapping(dm.ProcessorMap()), 1, 0);
+    LayoutData<Real> costs(ba, dm);
+    for (MFIter mfi(costs); mfi.isValid(); ++mfi) {
+        costs[mfi] = 0.0;
+    }
+
+    MFIter::startCostTimer(costs);
+    for (MFIter mfi(mf, true); mfi.isValid(); ++mfi) {
+        if (mfi.index() % 2 == 0) work(1.e-3);
+    }
+    // Not timed since the distribution is not that of costs
+    for (MFIter mfi(other); mfi.isValid(); ++mfi) {
+        work(1.e-2);
+    }
+    // Not timed since the distribution is another one, with the same owners
+    for (MFIter mfi(copied); mfi.isValid(); ++mfi) {
+        work(1.e-2);
+    }
+    MFIter::stopCostTimer();
+    // Not timed since the timer is stopped
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        work(1.e-2);
+    }
+
+    int nerrors = 0;
+    for (MFIter mfi(costs); mfi.isValid(); ++mfi) {
+        const bool busy = mfi.index() % 2 == 0;
+        if ((busy && costs[mfi] < 0.9e-3) || (!busy && costs[mfi] > 0.5e-3)) {
+            amrex::AllPrint() << "  box " << mfi.index() << " has cost " << costs[mfi] << "\n";
+            ++nerrors;
+        }
+    }
+    return nerrors;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nsteps = 6;
+        {
+            ParmParse pp("lb");
+            pp.query("nsteps", nsteps);
+        }
+
+        int nerrors = testCostTimer();
+
+        auto without = run(0, nsteps, nerrors);
+        auto with = run(1, nsteps, nerrors);
+
+        if (without.size() != with.size()) {
+            amrex::Print() << "The numbers of levels differ\n";
+            ++nerrors;
+        }
+        else
+        {
+            for (int lev = 0, N = without.size(); lev < N; ++lev)
+            {
+                if (without[lev]->boxArray() != with[lev]->boxArray()) {
+                    amrex::Print() << "Level " << lev << ": the grids differ\n";
+                    ++nerrors;
+                    continue;
+                }
+                MultiFab tmp(without[lev]->boxArray(), without[lev]->DistributionMap(), 1, 0);
+                tmp.ParallelCopy(*with[lev], 0, 0, 1);
+                MultiFab::Subtract(tmp, *without[lev], 0, 0, 1, 0);
+                const Real diff = tmp.norm0(0);
+                if (diff != 0.0) {
+                    amrex::Print() << "Level " << lev << ": the data differ by " << diff << "\n";
+                    ++nerrors;
+                }
+            }
+        }
+
+        nerrors += testFinerLevels(nsteps);
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("LoadBalanceCosts: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "LoadBalanceCosts: the data are the same as without load balancing\n";
+    }
+    amrex::Finalize();
+}
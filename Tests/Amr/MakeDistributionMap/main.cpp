@@ -0,0 +1,135 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <AmrTestLevel.H>
+
+using namespace amrex;
+
+class PhiLevel
+    : public TestLevel
+{
+public:
+    using TestLevel::TestLevel;
+
+    static void variableSetUp ()
+    {
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point, 0,
+                               1, &cell_cons_interp);
+        int lo_bc[AMREX_SPACEDIM];
+        int hi_bc[AMREX_SPACEDIM];
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+            lo_bc[i] = hi_bc[i] = BCType::int_dir;
+        }
+        BCRec bc(lo_bc, hi_bc);
+        desc_lst.setComponent(0, 0, "phi", bc, StateDescriptor::BndryFunc(nullFill));
+    }
+};
+
+TestLevelBld<PhiLevel> test_bld;
+
+LevelBld* getLevelBld ()
+{
+    return &test_bld;
+}
+
+// All the boxes on the last rank, which the default strategy never does
+// with more than one rank.
+DistributionMapping lastRankMap (const BoxArray& ba)
+{
+    Vector<int> pmap(ba.size(), ParallelDescriptor::NProcs()-1);
+    return DistributionMapping(std::move(pmap));
+}
+
+class TestAmr
+    : public Amr
+{
+public:
+    virtual DistributionMapping MakeDistributionMap (int /*lev*/, BoxArray const& ba) override
+    {
+        ++ncalls;
+        return lastRankMap(ba);
+    }
+
+    void regridAll () { regrid(0, cumTime()); }
+    void regridLevel0 () { regrid_level_0_on_restart(); }
+
+    int ncalls = 0;
+};
+
+// Check that the levels and their data are on the mappings of MakeDistributionMap.
+int check (TestAmr& amr, const std::string& what)
+{
+    int nerrors = 0;
+    for (int lev = 0; lev <= amr.finestLevel(); ++lev)
+    {
+        const DistributionMapping& expected = lastRankMap(amr.boxArray(lev));
+        if (amr.DistributionMap(lev) != expected ||
+            amr.getLevel(lev).get_new_data(0).DistributionMap() != expected)
+        {
+            amrex::Print() << what << ": level " << lev
+                           << " is not on the mapping of MakeDistributionMap\n";
+            ++nerrors;
+        }
+    }
+    amrex::Print() << what << ": " << amr.finestLevel()+1 << " levels, "
+                   << amr.ncalls << " calls of MakeDistributionMap\n";
+    if (amr.ncalls == 0) ++nerrors;
+    return nerrors;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nsteps = 3;
+        {
+            ParmParse pp("regrid");
+            pp.query("nsteps", nsteps);
+        }
+        std::string check_file("chk");
+        {
+            ParmParse pp("amr");
+            pp.query("check_file", check_file);
+        }
+
+        int nerrors = 0;
+        {
+            TestAmr amr;
+            amr.init(0.0, 1.0);
+            nerrors += check(amr, "Init");
+
+            for (int step = 1; step <= nsteps; ++step)
+            {
+                TestLevel::tagCenter() += 0.05;
+                amr.ncalls = 0;
+                amr.regridAll();
+                nerrors += check(amr, "Regrid " + std::to_string(step));
+            }
+
+            amr.checkPoint();
+        }
+
+        {
+            ParmParse pp("amr");
+            pp.add("restart", amrex::Concatenate(check_file, 0, 5));
+        }
+        {
+            TestAmr amr;
+            amr.init(0.0, 1.0);
+            nerrors += check(amr, "Restart");
+
+            amr.ncalls = 0;
+            amr.regridLevel0();
+            nerrors += check(amr, "Level 0 regrid on restart");
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("MakeDistributionMap: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "MakeDistributionMap: Amr made every mapping with MakeDistributionMap\n";
+    }
+    amrex::Finalize();
+}
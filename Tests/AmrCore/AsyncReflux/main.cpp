@@ -0,0 +1,209 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FluxRegister.H>
+#include <AMReX_YAFluxRegister.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+// Set the data of mf, including ghost cells, to a smooth function of the
+// index and of a.
+void setData (MultiFab& mf, Real a)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        auto const& d = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            d(i,j,k,n) = a + std::sin(AMREX_D_TERM(0.3*i, +0.7*j*(n+1), +1.1*k));
+        });
+    }
+}
+
+// 1 if a and b differ anywhere, 0 otherwise.
+int countDiffs (MultiFab const& a, MultiFab const& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrow());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrow());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrow());
+    return (d.norm0(0, a.nGrow()) != 0.0) ? 1 : 0;
+}
+
+// YAFluxRegister::Reflux is built on Reflux_nowait and Reflux_finish.
+// RefluxBlocking is the Reflux from before them, with the blocking
+// ParallelCopy, to check them against.
+class TestYAFluxRegister
+    : public YAFluxRegister
+{
+public:
+    using YAFluxRegister::YAFluxRegister;
+
+    void RefluxBlocking (MultiFab& state, int dc = 0)
+    {
+        if (!m_cfp_mask.empty())
+        {
+            for (MFIter mfi(m_cfpatch); mfi.isValid(); ++mfi)
+            {
+                auto const maskfab = m_cfp_mask.array(mfi);
+                auto       cfptfab = m_cfpatch.array(mfi);
+                amrex::LoopOnCpu(m_cfpatch[mfi].box(), m_ncomp, [&] (int i, int j, int k, int n) noexcept
+                {
+                    cfptfab(i,j,k,n) *= maskfab(i,j,k);
+                });
+            }
+        }
+
+        m_crse_data.ParallelCopy(m_cfpatch, m_crse_geom.periodicity(), FabArrayBase::ADD);
+
+        MultiFab::Add(state, m_crse_data, 0, dc, m_ncomp, 0);
+    }
+};
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        {
+            ParmParse pp("reflux");
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        const int ncomp = 3;
+        const IntVect ratio(2);
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        Geometry cgeom(Box(IntVect(0), IntVect(n_cell-1)), rb, 0, is_periodic);
+        Geometry fgeom(amrex::refine(cgeom.Domain(), ratio), rb, 0, is_periodic);
+
+        BoxArray cba(cgeom.Domain());
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        // Fine grids in the middle and at the periodic boundary
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(n_cell/2), IntVect(n_cell+n_cell/2-1)));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(0,n_cell/2,n_cell/2)),
+                          IntVect(AMREX_D_DECL(n_cell/4-1,n_cell-1,n_cell-1))));
+        BoxArray fba(std::move(fbl));
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+
+        Array<MultiFab,AMREX_SPACEDIM> cflux, fflux;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const IntVect ix = IntVect::TheDimensionVector(idim);
+            cflux[idim].define(amrex::convert(cba,ix), cdm, ncomp, 0);
+            fflux[idim].define(amrex::convert(fba,ix), fdm, ncomp, 0);
+            setData(cflux[idim], 1.0+idim);
+            setData(fflux[idim], 2.0-idim);
+        }
+
+        MultiFab state0(cba, cdm, ncomp, 0);
+        setData(state0, 0.0);
+
+        int nerrors = 0;
+
+        // ParallelCopy_nowait between different BoxArrays, with ghost
+        // cells and periodicity.  The source is changed before the copy
+        // is finished.
+        {
+            BoxArray ba2(cgeom.Domain());
+            ba2.maxSize(max_grid_size/2);
+            DistributionMapping dm2(ba2);
+            MultiFab src(cba, cdm, ncomp, 1);
+            MultiFab dst(ba2, dm2, ncomp, 1), dst_nowait(ba2, dm2, ncomp, 1);
+            for (auto op : {FabArrayBase::COPY, FabArrayBase::ADD})
+            {
+                setData(src, 0.0);
+                setData(dst, 1.0);
+                setData(dst_nowait, 1.0);
+                dst.ParallelCopy(src, 0, 0, ncomp, IntVect(1), IntVect(1), cgeom.periodicity(), op);
+                dst_nowait.ParallelCopy_nowait(src, 0, 0, ncomp, IntVect(1), IntVect(1),
+                                               cgeom.periodicity(), op);
+                src.setVal(-1.0);
+                dst_nowait.ParallelCopy_finish();
+                nerrors += countDiffs(dst, dst_nowait);
+            }
+            if (nerrors > 0) {
+                amrex::Print() << "  ParallelCopy_nowait differs from ParallelCopy\n";
+            }
+        }
+
+        // FluxRegister
+        {
+            FluxRegister fr(fba, fdm, ratio, 1, ncomp);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                fr.CrseInit(cflux[idim], idim, 0, 0, ncomp, -1.0);
+                fr.FineAdd(fflux[idim], idim, 0, 0, ncomp, 1.0);
+            }
+
+            MultiFab state(cba, cdm, ncomp, 0), state_nowait(cba, cdm, ncomp, 0);
+            MultiFab::Copy(state, state0, 0, 0, ncomp, 0);
+            MultiFab::Copy(state_nowait, state0, 0, 0, ncomp, 0);
+
+            fr.Reflux(state, 0.5, 0, 0, ncomp, cgeom);
+            fr.Reflux_nowait(state_nowait, 0.5, 0, 0, ncomp, cgeom);
+            fr.Reflux_finish();
+
+            if (countDiffs(state, state0) == 0) {
+                amrex::Print() << "  FluxRegister::Reflux did nothing\n";
+                ++nerrors;
+            }
+            if (countDiffs(state, state_nowait) != 0) {
+                amrex::Print() << "  FluxRegister::Reflux_nowait differs from Reflux\n";
+                ++nerrors;
+            }
+        }
+
+        // YAFluxRegister.  Reflux changes the register, so two are needed.
+        {
+            Array<std::unique_ptr<TestYAFluxRegister>,2> yfr;
+            for (auto& r : yfr) {
+                r.reset(new TestYAFluxRegister(fba, cba, fdm, cdm, fgeom, cgeom, ratio, 1, ncomp));
+                r->reset();
+                for (MFIter mfi(state0); mfi.isValid(); ++mfi) {
+                    if (r->CrseHasWork(mfi)) {
+                        std::array<FArrayBox const*,AMREX_SPACEDIM> flux
+                            {AMREX_D_DECL(&cflux[0][mfi], &cflux[1][mfi], &cflux[2][mfi])};
+                        r->CrseAdd(mfi, flux, cgeom.CellSize(), 0.5, RunOn::Cpu);
+                    }
+                }
+                for (MFIter mfi(fflux[0]); mfi.isValid(); ++mfi) {
+                    if (r->FineHasWork(mfi)) {
+                        std::array<FArrayBox const*,AMREX_SPACEDIM> flux
+                            {AMREX_D_DECL(&fflux[0][mfi], &fflux[1][mfi], &fflux[2][mfi])};
+                        r->FineAdd(mfi, flux, fgeom.CellSize(), 0.5, RunOn::Cpu);
+                    }
+                }
+            }
+
+            MultiFab state(cba, cdm, ncomp, 0), state_nowait(cba, cdm, ncomp, 0);
+            MultiFab::Copy(state, state0, 0, 0, ncomp, 0);
+            MultiFab::Copy(state_nowait, state0, 0, 0, ncomp, 0);
+
+            yfr[0]->RefluxBlocking(state);
+            yfr[1]->Reflux_nowait(state_nowait);
+            yfr[1]->Reflux_finish();
+
+            if (countDiffs(state, state0) == 0) {
+                amrex::Print() << "  YAFluxRegister blocking reflux did nothing\n";
+                ++nerrors;
+            }
+            if (countDiffs(state, state_nowait) != 0) {
+                amrex::Print() << "  YAFluxRegister::Reflux_nowait differs from the blocking reflux\n";
+                ++nerrors;
+            }
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("AsyncReflux: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "AsyncReflux: the split-phase results are the same as the blocking ones\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,165 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_AmrCore.H>
+#include <AMReX_TagBox.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+// Is the cell (i,j,k) of the domain geom in the spherical shell that wraps
+// around the periodic x-boundary?
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+bool inShell (int i, int j, int k, GpuArray<Real,AMREX_SPACEDIM> const& dx) noexcept
+{
+    const Real r0 = 0.25;
+    const Real w = 0.03;
+    Real x = (i+0.5)*dx[0] - 0.1;
+    if (x > 0.5) x -= 1.0;
+    if (x < -0.5) x += 1.0;
+    Real r2 = x*x;
+#if (AMREX_SPACEDIM > 1)
+    const Real y = (j+0.5)*dx[1] - 0.5;
+    r2 += y*y;
+#endif
+#if (AMREX_SPACEDIM > 2)
+    const Real z = (k+0.5)*dx[2] - 0.5;
+    r2 += z*z;
+#endif
+    amrex::ignore_unused(j,k);
+    return std::abs(std::sqrt(r2) - r0) < w;
+}
+
+class ShellMesh
+    : public AmrCore
+{
+public:
+    explicit ShellMesh (bool distributed)
+    {
+        SetUseDistributedClustering(distributed);
+    }
+
+    Real gridEff () const noexcept { return grid_eff; }
+
+protected:
+    virtual void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        const auto dx = Geom(lev).CellSizeArray();
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<char> const& tag = tags.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                if (inShell(i,j,k,dx)) tag(i,j,k) = TagBox::SET;
+            });
+        }
+    }
+
+    virtual void MakeNewLevelFromScratch (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    virtual void MakeNewLevelFromCoarse (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    virtual void RemakeLevel (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    virtual void ClearLevel (int) override {}
+};
+
+// Check that the grids of mesh satisfy the constraints of grid generation.
+int checkGrids (const ShellMesh& mesh)
+{
+    int nerrors = 0;
+    for (int lev = 1; lev <= mesh.finestLevel(); ++lev)
+    {
+        const BoxArray& cba = mesh.boxArray(lev-1);
+        const BoxArray& fba = mesh.boxArray(lev);
+        const IntVect rr = mesh.refRatio(lev-1);
+
+        if (!fba.isDisjoint()) {
+            amrex::Print() << "  level " << lev << ": the grids overlap\n";
+            ++nerrors;
+        }
+        if (!fba.coarsenable(mesh.blockingFactor(lev))) {
+            amrex::Print() << "  level " << lev << ": the grids violate the blocking factor\n";
+            ++nerrors;
+        }
+
+        // Proper nesting
+        const BoxArray& cfba = amrex::coarsen(fba, rr);
+        const IntVect np = mesh.blockingFactor(lev) / rr;
+        const Box& cdomain = mesh.Geom(lev-1).Domain();
+        for (int i = 0, N = cfba.size(); i < N; ++i) {
+            const Box& b = amrex::grow(cfba[i],np) & cdomain;
+            if (!cba.contains(b,true)) {
+                amrex::Print() << "  level " << lev << ": " << fba[i] << " is not properly nested\n";
+                ++nerrors;
+            }
+        }
+
+        // All the tagged cells of the coarse level must be refined.
+        const auto dx = mesh.Geom(lev-1).CellSizeArray();
+        Long nuncovered = 0;
+        for (int i = 0, N = cba.size(); i < N; ++i) {
+            amrex::LoopOnCpu(cba[i], [&] (int ii, int jj, int kk) noexcept
+            {
+                if (inShell(ii,jj,kk,dx) &&
+                    !cfba.contains(IntVect(AMREX_D_DECL(ii,jj,kk)))) {
+                    ++nuncovered;
+                }
+            });
+        }
+        if (nuncovered > 0) {
+            amrex::Print() << "  level " << lev << ": " << nuncovered
+                           << " tagged cells are not refined\n";
+            ++nerrors;
+        }
+    }
+    return nerrors;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ShellMesh serial(false);
+        serial.InitFromScratch(0.0);
+
+        ShellMesh distributed(true);
+        distributed.InitFromScratch(0.0);
+
+        int nerrors = 0;
+        if (serial.finestLevel() != distributed.finestLevel()) {
+            amrex::Print() << "The finest levels differ: " << serial.finestLevel() << " "
+                           << distributed.finestLevel() << "\n";
+            ++nerrors;
+        }
+
+        nerrors += checkGrids(serial);
+        nerrors += checkGrids(distributed);
+
+        for (int lev = 1; lev <= std::min(serial.finestLevel(), distributed.finestLevel()); ++lev)
+        {
+            const BoxArray& sba = serial.boxArray(lev);
+            const BoxArray& dba = distributed.boxArray(lev);
+            amrex::Print() << "Level " << lev << ": " << sba.size() << " grids with "
+                           << sba.numPts() << " cells by gathering the tags, "
+                           << dba.size() << " grids with " << dba.numPts()
+                           << " cells by distributed clustering\n";
+
+            // On one process, nothing is merged and the results are the same.
+            if (ParallelDescriptor::NProcs() == 1 && sba != dba) {
+                amrex::Print() << "  level " << lev << ": the grids differ on one process\n";
+                ++nerrors;
+            }
+
+            // The distributed clusters are no less efficient than grid_eff
+            // as a whole, whereas the serial ones cover the tags at least.
+            if (dba.numPts() > sba.numPts() / distributed.gridEff()) {
+                amrex::Print() << "  level " << lev << ": the distributed clusters are inefficient\n";
+                ++nerrors;
+            }
+        }
+
+        if (nerrors > 0) {
+            amrex::Abort("DistributedClustering: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "DistributedClustering: the grids are valid\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,147 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+// Set the valid data of mf to a smooth function of the cell and of a.
+void setData (MultiFab& mf, const Geometry& geom, Real a)
+{
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        auto const& d = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), mf.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            AMREX_D_TERM(const Real x = (i+0.5)*dx[0];,
+                         const Real y = (j+0.5)*dx[1];,
+                         const Real z = (k+0.5)*dx[2];);
+            d(i,j,k,n) = a + std::sin(AMREX_D_TERM(6.2831853*x, +2.0*y*(n+1), +3.0*z));
+        });
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        int nsteps = 4;
+        {
+            ParmParse pp("plan");
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+        }
+
+        const int ncomp = 3;
+        const int ngrow = 2;
+        const IntVect ratio(2);
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        Geometry cgeom(Box(IntVect(0), IntVect(n_cell-1)), rb, 0, is_periodic);
+        Geometry fgeom(amrex::refine(cgeom.Domain(), ratio), rb, 0, is_periodic);
+
+        BoxArray cba(cgeom.Domain());
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        // Fine grids in the middle and across the periodic boundary
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(n_cell/2), IntVect(n_cell+n_cell/2-1)));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(0,n_cell/2,n_cell/2)),
+                          IntVect(AMREX_D_DECL(n_cell/4-1,n_cell-1,n_cell-1))));
+        BoxArray fba(std::move(fbl));
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+
+        MultiFab cold(cba, cdm, ncomp, 0), cnew(cba, cdm, ncomp, 0);
+        MultiFab fold(fba, fdm, ncomp, 0), fnew(fba, fdm, ncomp, 0);
+        setData(cold, cgeom, 0.0);
+        setData(cnew, cgeom, 1.0);
+        setData(fold, fgeom, 0.0);
+        setData(fnew, fgeom, 1.0);
+        const Vector<MultiFab*> cmf{&cold, &cnew};
+        const Vector<MultiFab*> fmf{&fold, &fnew};
+        const Vector<Real> times{0.0, 1.0};
+
+        PhysBCFunctNoOp physbc;
+        const Vector<BCRec> bcs(ncomp, BCRec(AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::int_dir),
+                                             AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::int_dir)));
+
+        MultiFab with_plan(fba, fdm, ncomp, ngrow);
+        MultiFab without_plan(fba, fdm, ncomp, ngrow);
+        FillPatchPlan<MultiFab> plan;
+
+        int nerrors = 0;
+        int ndefines = 0;
+        Long cpc_builds_with = 0, cpc_builds_without = 0;
+        for (int step = 0; step < nsteps; ++step)
+        {
+            // Substeps of a subcycled fine level
+            for (Real time : {0.25, 0.5, 0.75, 1.0})
+            {
+                Long nbuild = FabArrayBase::m_CPC_stats.nbuild;
+                FillPatchTwoLevels(with_plan, time, plan, cmf, times, fmf, times,
+                                   0, 0, ncomp, cgeom, fgeom, physbc, 0, physbc, 0,
+                                   ratio, &cell_cons_interp, bcs, 0);
+                if (step > 0) cpc_builds_with += FabArrayBase::m_CPC_stats.nbuild - nbuild;
+
+                FillPatchTwoLevels(without_plan, time, cmf, times, fmf, times,
+                                   0, 0, ncomp, cgeom, fgeom, physbc, 0, physbc, 0,
+                                   ratio, &cell_cons_interp, bcs, 0);
+
+                MultiFab::Subtract(without_plan, with_plan, 0, 0, ncomp, ngrow);
+                const Real diff = without_plan.norm0(0, ngrow);
+                if (diff != 0.0) {
+                    amrex::Print() << "  time " << time << ": the data differ by " << diff << "\n";
+                    ++nerrors;
+                }
+            }
+            if (step == 0) {
+                ndefines = plan.numDefines();
+            }
+        }
+
+        // Without a plan alive, the temporaries and their copy plans are
+        // rebuilt by every call.
+        const int ndefines_total = plan.numDefines();
+        plan.clear();
+        for (Real time : {0.25, 0.5, 0.75, 1.0})
+        {
+            const Long nbuild = FabArrayBase::m_CPC_stats.nbuild;
+            FillPatchTwoLevels(without_plan, time, cmf, times, fmf, times,
+                               0, 0, ncomp, cgeom, fgeom, physbc, 0, physbc, 0,
+                               ratio, &cell_cons_interp, bcs, 0);
+            cpc_builds_without += FabArrayBase::m_CPC_stats.nbuild - nbuild;
+        }
+
+        amrex::Print() << "The plan was defined " << ndefines_total << " times.  "
+                       << "After the first step, " << cpc_builds_with << " copy plans were built with it; "
+                       << cpc_builds_without << " in one step without it\n";
+        if (ndefines_total != ndefines) {
+            amrex::Print() << "  the plan was redefined\n";
+            ++nerrors;
+        }
+        if (cpc_builds_with != 0) {
+            amrex::Print() << "  the copy plans were rebuilt with the plan\n";
+            ++nerrors;
+        }
+        if (cpc_builds_without == 0) {
+            amrex::Print() << "  the copy plans were not rebuilt without the plan\n";
+            ++nerrors;
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("FillPatchPlan: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "FillPatchPlan: the data are the same as without a plan\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,329 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_Interp_C.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+    int n_cell = 16;
+    int ncomp = 4;
+}
+
+// Boundary conditions with one-sided slopes at the low end of the coarse
+// region for ext_dir.
+Vector<BCRec> makeBCs (int bctype)
+{
+    Vector<BCRec> bcr(ncomp);
+    for (int n = 0; n < ncomp; ++n) {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            bcr[n].setLo(d, (bctype == 0) ? BCType::int_dir : BCType::ext_dir);
+            bcr[n].setHi(d, (bctype == 0) ? BCType::int_dir : ((n%2) ? BCType::hoextrap : BCType::foextrap));
+        }
+    }
+    return bcr;
+}
+
+void setCrse (FArrayBox& crse, Real shift)
+{
+    auto const& c = crse.array();
+    amrex::LoopOnCpu(crse.box(), crse.nComp(), [&] (int i, int j, int k, int n) noexcept
+    {
+        const Real x = 0.37*i + 0.61*j + 0.23*k + 0.9*n;
+        c(i,j,k,n) = std::sin(x) + 0.3*std::cos(7.1*x*x) + shift;
+    });
+}
+
+// The separate-pass interpolation of CellConservativeLinear, with
+// temporary slope arrays.
+void separateInterp (const FArrayBox& crse, FArrayBox& fine, const Box& fine_region,
+                     const IntVect& ratio, const Geometry& cgeom, const Geometry& fgeom,
+                     const Vector<BCRec>& bcr, bool lin_lim)
+{
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
+    const Box& cslope_bx = amrex::coarsen(fine_region,ratio);
+    const Vector<Real>& voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, cgeom, fgeom);
+
+    const int ntmp = lin_lim ? (ncomp+1)*AMREX_SPACEDIM : ncomp*(AMREX_SPACEDIM+2);
+    FArrayBox ccfab(cslope_bx, ntmp);
+    Array4<Real> const& ccarr = ccfab.array();
+    if (lin_lim) {
+        amrex::cellconslin_slopes_linlim(cslope_bx, ccarr, crsearr, 0, ncomp, bcr.data());
+    } else {
+        FArrayBox fafab(amrex::refine(cslope_bx,ratio), ncomp);
+        amrex::cellconslin_slopes_mclim(cslope_bx, ccarr, crsearr, 0, ncomp, bcr.data());
+        amrex::cellconslin_fine_alpha(fafab.box(), fafab.array(), ccarr, ncomp, voff.data(), ratio);
+        amrex::cellconslin_slopes_mmlim(cslope_bx, ccarr, fafab.array(), ncomp, ratio);
+    }
+    amrex::cellconslin_interp(fine_region, finearr, 0, ncomp, ccarr, crsearr, 0, voff.data(), ratio);
+}
+
+// Return the number of coarse cells whose value is not the average of the
+// fine cells in them.
+Long countNotConserved (const FArrayBox& crse, const FArrayBox& fine, const Box& fine_region,
+                        const IntVect& ratio)
+{
+    const Box& cbx = amrex::coarsen(fine_region,ratio);
+    const Box& fbx = amrex::refine(cbx,ratio);
+    FArrayBox avg(cbx, ncomp);
+    avg.setVal(0.0);
+    auto const& a = avg.array();
+    auto const& f = fine.const_array();
+    const Real nfine = AMREX_D_TERM(ratio[0],*ratio[1],*ratio[2]);
+    amrex::LoopOnCpu(fbx & fine_region, ncomp, [&] (int i, int j, int k, int n) noexcept
+    {
+        const IntVect c = amrex::coarsen(IntVect(AMREX_D_DECL(i,j,k)),ratio);
+        a(c,n) += f(i,j,k,n) / nfine;
+    });
+
+    Long nbad = 0;
+    auto const& c = crse.const_array();
+    amrex::LoopOnCpu(cbx, ncomp, [&] (int i, int j, int k, int n) noexcept
+    {
+        // Only the coarse cells covered by fine_region
+        if (fine_region.contains(amrex::refine(Box(IntVect(AMREX_D_DECL(i,j,k)),
+                                                   IntVect(AMREX_D_DECL(i,j,k))),ratio))) {
+            if (std::abs(a(i,j,k,n)-c(i,j,k,n)) > 1.e-12) ++nbad;
+        }
+    });
+    return nbad;
+}
+
+#if (AMREX_SPACEDIM > 1)
+// CellConservativeProtected::protect keeps the volume weighted sum of the
+// correction in each coarse cell, and sets component 0 to the sum of the
+// others.
+int testProtect (const Box& cbx, const Box& fine_region, const IntVect& rr,
+                 const Geometry& cgeom, const Geometry& fgeom)
+{
+    FArrayBox crse_corr(cbx, ncomp);
+    setCrse(crse_corr, -0.2);
+    FArrayBox fine(fine_region, ncomp);
+    FArrayBox state(fine_region, ncomp);
+    auto const& s = state.array();
+    amrex::LoopOnCpu(fine_region, ncomp, [&] (int i, int j, int k, int n) noexcept
+    {
+        const Real x = 0.17*i + 0.41*j + 0.53*k + 0.3*n;
+        s(i,j,k,n) = 0.5*std::sin(3.*x);
+    });
+    Vector<BCRec> bcr = makeBCs(0);
+    protected_interp.interp(crse_corr, 0, fine, 0, ncomp, fine_region, rr, cgeom, fgeom,
+                            bcr, 0, 0, RunOn::Cpu);
+    FArrayBox before(fine_region, ncomp);
+    before.copy<RunOn::Host>(fine);
+    protected_interp.protect(crse_corr, 0, fine, 0, state, 0, ncomp, fine_region, rr,
+                             cgeom, fgeom, bcr, RunOn::Cpu);
+
+    FArrayBox vol;
+    static_cast<const CoordSys&>(fgeom).GetVolume(vol, fine_region);
+
+    const Box& csbx = amrex::coarsen(fine_region,rr);
+    FArrayBox sums(csbx, 2*ncomp);
+    sums.setVal(0.0);
+    auto const& sm = sums.array();
+    auto const& f = fine.const_array();
+    auto const& b = before.const_array();
+    auto const& v = vol.const_array();
+    Long nbad = 0;
+    amrex::LoopOnCpu(fine_region, ncomp, [&] (int i, int j, int k, int n) noexcept
+    {
+        const IntVect c = amrex::coarsen(IntVect(AMREX_D_DECL(i,j,k)),rr);
+        sm(c,n)       += v(i,j,k)*f(i,j,k,n);
+        sm(c,n+ncomp) += v(i,j,k)*b(i,j,k,n);
+        if (n == 0) {
+            Real sum = 0.0;
+            for (int m = 1; m < ncomp-1; ++m) sum += f(i,j,k,m);
+            if (std::abs(f(i,j,k,0)-sum) > 1.e-12) ++nbad;
+        }
+    });
+    amrex::LoopOnCpu(csbx, ncomp-2, [&] (int i, int j, int k, int m) noexcept
+    {
+        const int n = m+1;
+        const Real scale = std::max(std::abs(sm(i,j,k,n+ncomp)), 1.e-3);
+        if (std::abs(sm(i,j,k,n)-sm(i,j,k,n+ncomp)) > 1.e-10*scale) ++nbad;
+    });
+    if (nbad > 0) {
+        amrex::Print() << "  CellConservativeProtected ratio " << rr[0] << " coord "
+                       << cgeom.Coord() << ": " << nbad << " errors\n";
+        return 1;
+    }
+    return 0;
+}
+#endif
+
+#if (AMREX_SPACEDIM == 2)
+// CellQuadratic is exact for the point values of quadratic data, and
+// conserves data whose second derivatives in x and y are zero.
+int testCellQuadratic (const Box& fine_region, const IntVect& rr,
+                       const Geometry& cgeom, const Geometry& fgeom)
+{
+    const int ratio = rr[0];
+    const Box& cbx = amrex::grow(amrex::coarsen(fine_region,rr),1);
+    int nerrors = 0;
+    for (int quadratic = 0; quadratic < 2; ++quadratic)
+    {
+        auto q = [=] (Real x, Real y, int n) -> Real
+        {
+            Real r = n + 0.5*x - 0.25*y + 0.1*x*y;
+            if (quadratic) r += 0.03*x*x - 0.07*y*y;
+            return r;
+        };
+
+        FArrayBox crse(cbx, ncomp);
+        auto const& c = crse.array();
+        amrex::LoopOnCpu(cbx, ncomp, [&] (int i, int j, int k, int n) noexcept
+        {
+            c(i,j,k,n) = q(i+0.5, j+0.5, n);
+        });
+        FArrayBox fine(fine_region, ncomp);
+        quadratic_interp.interp(crse, 0, fine, 0, ncomp, fine_region, rr, cgeom, fgeom,
+                                makeBCs(0), 0, 0, RunOn::Cpu);
+
+        Long nbad = 0;
+        auto const& f = fine.const_array();
+        amrex::LoopOnCpu(fine_region, ncomp, [&] (int i, int j, int k, int n) noexcept
+        {
+            const Real exact = q((i+0.5)/ratio, (j+0.5)/ratio, n);
+            if (std::abs(f(i,j,k,n)-exact) > 1.e-12) ++nbad;
+        });
+        if (!quadratic) {
+            nbad += countNotConserved(crse, fine, fine_region, rr);
+        }
+        if (nbad > 0) {
+            amrex::Print() << "  CellQuadratic ratio " << ratio << " quadratic " << quadratic
+                           << ": " << nbad << " errors\n";
+            ++nerrors;
+        }
+    }
+    return nerrors;
+}
+#endif
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        {
+            ParmParse pp("interp");
+            pp.query("n_cell", n_cell);
+            pp.query("ncomp", ncomp);
+        }
+
+        int nerrors = 0;
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)},{AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        const Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+
+        for (int ratio : {2, 4, 3})
+        {
+            const IntVect rr(ratio);
+            const Geometry fgeom(amrex::refine(cdomain,rr), rb, CoordSys::cartesian, is_periodic);
+            // A fine region not aligned with the coarse cells
+            const Box fine_region(IntVect(AMREX_D_DECL(3,5,2)),
+                                  IntVect(AMREX_D_DECL(3*ratio+4,4*ratio+1,2*ratio+3)));
+            const Box& cbx = amrex::grow(amrex::coarsen(fine_region,rr),2);
+            FArrayBox crse(cbx, ncomp);
+            setCrse(crse, 0.0);
+
+            for (int bctype = 0; bctype < 2; ++bctype)
+            {
+                const Vector<BCRec> bcr = makeBCs(bctype);
+
+                // The fused kernels of ratios 2 and 4 give the same results
+                // as the separate passes.
+                for (int lin_lim = 0; lin_lim < 2; ++lin_lim)
+                {
+                    Interpolater* mapper = lin_lim ? &lincc_interp : &cell_cons_interp;
+                    FArrayBox fine(amrex::grow(fine_region,1), ncomp);
+                    FArrayBox fine_ref(fine.box(), ncomp);
+                    fine.setVal(-7.0);
+                    fine_ref.setVal(-7.0);
+                    mapper->interp(crse, 0, fine, 0, ncomp, fine_region, rr, cgeom, fgeom,
+                                   bcr, 0, 0, RunOn::Cpu);
+                    separateInterp(crse, fine_ref, fine_region, rr, cgeom, fgeom, bcr, lin_lim);
+
+                    Long ndiff = 0;
+                    auto const& a = fine.const_array();
+                    auto const& b = fine_ref.const_array();
+                    amrex::LoopOnCpu(fine.box(), ncomp, [&] (int i, int j, int k, int n) noexcept
+                    {
+                        if (a(i,j,k,n) != b(i,j,k,n)) ++ndiff;
+                    });
+                    const Long nbad = countNotConserved(crse, fine, fine_region, rr);
+                    if (ndiff > 0 || nbad > 0) {
+                        amrex::Print() << "  CellConservativeLinear(" << lin_lim << ") ratio " << ratio
+                                       << " bc " << bctype << ": " << ndiff << " values differ, "
+                                       << nbad << " coarse cells not conserved\n";
+                        ++nerrors;
+                    }
+                }
+
+                if (ratio == 2)
+                {
+                    FArrayBox fine(amrex::grow(fine_region,1), ncomp);
+                    fine.setVal(-7.0);
+                    quartic_interp.interp(crse, 0, fine, 0, ncomp, fine_region, rr, cgeom, fgeom,
+                                          bcr, 0, 0, RunOn::Cpu);
+                    const Long nbad = countNotConserved(crse, fine, fine_region, rr);
+                    if (nbad > 0) {
+                        amrex::Print() << "  CellConservativeQuartic bc " << bctype << ": "
+                                       << nbad << " coarse cells not conserved\n";
+                        ++nerrors;
+                    }
+                }
+            }
+
+            // CellBilinear is exact for linear data.
+            {
+                FArrayBox lin(cbx, ncomp);
+                auto const& c = lin.array();
+                amrex::LoopOnCpu(cbx, ncomp, [&] (int i, int j, int k, int n) noexcept
+                {
+                    c(i,j,k,n) = n + AMREX_D_TERM(0.5*(i+0.5), -0.25*(j+0.5), +0.125*(k+0.5));
+                });
+                FArrayBox fine(fine_region, ncomp);
+                cell_bilinear_interp.interp(lin, 0, fine, 0, ncomp, fine_region, rr, cgeom, fgeom,
+                                            makeBCs(0), 0, 0, RunOn::Cpu);
+                Long nbad = 0;
+                auto const& f = fine.const_array();
+                amrex::LoopOnCpu(fine_region, ncomp, [&] (int i, int j, int k, int n) noexcept
+                {
+                    const Real exact = n + AMREX_D_TERM(0.5*(i+0.5)/ratio, -0.25*(j+0.5)/ratio,
+                                                        +0.125*(k+0.5)/ratio);
+                    if (std::abs(f(i,j,k,n)-exact) > 1.e-12) ++nbad;
+                });
+                if (nbad > 0) {
+                    amrex::Print() << "  CellBilinear ratio " << ratio << ": " << nbad << " wrong values\n";
+                    ++nerrors;
+                }
+            }
+
+#if (AMREX_SPACEDIM > 1)
+            nerrors += testProtect(cbx, fine_region, rr, cgeom, fgeom);
+#endif
+
+#if (AMREX_SPACEDIM == 2)
+            nerrors += testCellQuadratic(fine_region, rr, cgeom, fgeom);
+
+            // The volume weighted sums of the protected correction in RZ.
+            {
+                const Geometry crz(cdomain, rb, CoordSys::RZ, is_periodic);
+                const Geometry frz(amrex::refine(cdomain,rr), rb, CoordSys::RZ, is_periodic);
+                nerrors += testProtect(cbx, fine_region, rr, crz, frz);
+            }
+#endif
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("Interpolaters: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "Interpolaters: the fused kernels give the same results as the separate passes\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,161 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_AmrCore.H>
+#include <AMReX_TagBox.H>
+#include <AMReX_SFC.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+// Is the cell (i,j,k) of the domain geom in a spherical shell?
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+bool inShell (int i, int j, int k, GpuArray<Real,AMREX_SPACEDIM> const& dx) noexcept
+{
+    const Real r0 = 0.3;
+    const Real w = 0.04;
+    const Real x = (i+0.5)*dx[0] - 0.5;
+    Real r2 = x*x;
+#if (AMREX_SPACEDIM > 1)
+    const Real y = (j+0.5)*dx[1] - 0.5;
+    r2 += y*y;
+#endif
+#if (AMREX_SPACEDIM > 2)
+    const Real z = (k+0.5)*dx[2] - 0.5;
+    r2 += z*z;
+#endif
+    amrex::ignore_unused(j,k);
+    return std::abs(std::sqrt(r2) - r0) < w;
+}
+
+class ShellMesh
+    : public AmrCore
+{
+public:
+    explicit ShellMesh (bool sfc)
+    {
+        SetSFCOrderGrids(sfc);
+    }
+
+protected:
+    virtual void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        const auto dx = Geom(lev).CellSizeArray();
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            Array4<char> const& tag = tags.array(mfi);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                if (inShell(i,j,k,dx)) tag(i,j,k) = TagBox::SET;
+            });
+        }
+    }
+
+    virtual void MakeNewLevelFromScratch (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    virtual void MakeNewLevelFromCoarse (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    virtual void RemakeLevel (int, Real, const BoxArray&, const DistributionMapping&) override {}
+    virtual void ClearLevel (int) override {}
+};
+
+// Are the boxes of ba in Morton order?
+bool inSFCOrder (const BoxArray& ba)
+{
+    for (int i = 1, N = ba.size(); i < N; ++i) {
+        const Box& prev = ba[i-1];
+        const Box& bx = ba[i];
+        if (SFCToken::Compare()(makeSFCToken(i, bx.smallEnd()),
+                                makeSFCToken(i-1, prev.smallEnd()))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The fraction of the boxes of ba that touch the next box.
+Real fractionTouching (const BoxArray& ba)
+{
+    if (ba.size() < 2) return 1.0;
+    int n = 0;
+    for (int i = 1, N = ba.size(); i < N; ++i) {
+        if (amrex::grow(ba[i-1],1).intersects(ba[i])) ++n;
+    }
+    return static_cast<Real>(n) / static_cast<Real>(ba.size()-1);
+}
+
+// Does the SFC distribution give each process a contiguous range of boxes?
+bool contiguousRanks (const BoxArray& ba)
+{
+    Vector<Real> cost(ba.size());
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        cost[i] = static_cast<Real>(ba[i].numPts());
+    }
+    const DistributionMapping dm = DistributionMapping::makeSFC(cost, ba);
+    Vector<int> nchanges(ParallelDescriptor::NProcs(), 0);
+    for (int i = 1, N = ba.size(); i < N; ++i) {
+        if (dm[i] != dm[i-1]) ++nchanges[dm[i-1]];
+    }
+    return *std::max_element(nchanges.begin(), nchanges.end()) <= 1;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ShellMesh plain(false);
+        plain.InitFromScratch(0.0);
+
+        ShellMesh sfc(true);
+        sfc.InitFromScratch(0.0);
+
+        int nerrors = 0;
+        if (plain.finestLevel() != sfc.finestLevel()) {
+            amrex::Print() << "The finest levels differ: " << plain.finestLevel() << " "
+                           << sfc.finestLevel() << "\n";
+            ++nerrors;
+        }
+
+        for (int lev = 0; lev <= std::min(plain.finestLevel(), sfc.finestLevel()); ++lev)
+        {
+            const BoxArray& pba = plain.boxArray(lev);
+            const BoxArray& sba = sfc.boxArray(lev);
+            amrex::Print() << "Level " << lev << ": " << sba.size() << " grids, "
+                           << fractionTouching(pba) << " -> " << fractionTouching(sba)
+                           << " of them touch the next one\n";
+
+            // The grids are the same, only numbered differently.
+            Vector<Box> pboxes = pba.boxList().data();
+            Vector<Box> sboxes = sba.boxList().data();
+            std::sort(pboxes.begin(), pboxes.end());
+            std::sort(sboxes.begin(), sboxes.end());
+            if (pboxes != sboxes) {
+                amrex::Print() << "  level " << lev << ": the grids differ\n";
+                ++nerrors;
+            }
+
+            if (!inSFCOrder(sba)) {
+                amrex::Print() << "  level " << lev << ": the grids are not in Morton order\n";
+                ++nerrors;
+            }
+            if (!contiguousRanks(sba)) {
+                amrex::Print() << "  level " << lev << ": a process owns grids far apart in the BoxArray\n";
+                ++nerrors;
+            }
+        }
+
+        // Ordering twice does not change the BoxArray.
+        BoxArray ba = sfc.boxArray(0);
+        ba.orderSFC();
+        if (!(ba == sfc.boxArray(0))) {
+            amrex::Print() << "orderSFC is not idempotent\n";
+            ++nerrors;
+        }
+
+        if (nerrors > 0) {
+            amrex::Abort("SFCOrderGrids: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "SFCOrderGrids: the grids are numbered along the space-filling curve\n";
+    }
+    amrex::Finalize();
+}
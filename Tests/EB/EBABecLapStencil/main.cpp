@@ -0,0 +1,141 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBMultiFabUtil.H>
+#include <AMReX_MLEBABecLap.H>
+#include <AMReX_MLMG.H>
+
+using namespace amrex;
+
+struct Result
+{
+    MultiFab sol;
+    MultiFab ax;  // operator applied to the same input
+    MultiFab ax2; // after the b coefficients have been changed
+    int niters;
+    Real time;
+};
+
+Result run (const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm,
+            const EBFArrayBoxFactory& factory, const Array<MultiFab,AMREX_SPACEDIM>& bcoef,
+            MultiFab& rhs, MultiFab& x, bool eb_dirichlet, bool use_stencils)
+{
+    MLEBABecLap op({geom}, {ba}, {dm}, LPInfo(), {&factory});
+    op.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,
+                                 LinOpBCType::Dirichlet)},
+                   {AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,
+                                 LinOpBCType::Dirichlet)});
+    op.setLevelBC(0, nullptr);
+    op.setScalars(1.0, 1.0);
+    op.setACoeffs(0, 1.0);
+    op.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+    if (eb_dirichlet) op.setEBHomogDirichlet(0, 1.0);
+    op.setCutCellStencils(use_stencils);
+
+    MLMG mlmg(op);
+
+    Result r;
+    r.sol.define(ba, dm, 1, 1, MFInfo(), factory);
+    r.ax.define(ba, dm, 1, 0, MFInfo(), factory);
+    r.ax2.define(ba, dm, 1, 0, MFInfo(), factory);
+    r.sol.setVal(0.0);
+
+    Real t0 = amrex::second();
+    mlmg.solve({&r.sol}, {&rhs}, 1.e-10, 0.0);
+    r.time = amrex::second() - t0;
+    ParallelDescriptor::ReduceRealMax(r.time);
+    r.niters = mlmg.getNumIters();
+
+    mlmg.apply({&r.ax}, {&x});
+
+    // The stencils are rebuilt for the new coefficients.
+    op.setBCoeffs(0, 2.0);
+    mlmg.apply({&r.ax2}, {&x});
+
+    return r;
+}
+
+Real relDiff (const MultiFab& a, const MultiFab& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), 1, 0);
+    MultiFab::LinComb(d, 1.0, a, 0, -1.0, b, 0, 0, 1, 0);
+    return d.norm0() / a.norm0();
+}
+
+void testStencil ()
+{
+    ParmParse pp("stencil");
+    int n_cell, max_grid_size;
+    pp.get("n_cell", n_cell);
+    pp.get("max_grid_size", max_grid_size);
+
+    RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    EB2::SphereIF sphere(0.27, {AMREX_D_DECL(0.51,0.48,0.5)}, false);
+    EB2::Build(EB2::makeShop(sphere), geom, 0, 30);
+    auto factory = makeEBFabFactory(geom, ba, dm, {2,2,2}, EBSupport::full);
+
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+
+    MultiFab rhs(ba, dm, 1, 0, MFInfo(), *factory);
+    MultiFab x(ba, dm, 1, 1, MFInfo(), *factory);
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bcoef[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0);
+    }
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        const auto& r = rhs.array(mfi);
+        const auto& xa = x.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) {
+            AMREX_D_TERM(Real px = problo[0] + (i+0.5)*dx[0];,
+                         Real py = problo[1] + (j+0.5)*dx[1];,
+                         Real pz = problo[2] + (k+0.5)*dx[2];);
+            r(i,j,k) = AMREX_D_TERM(std::sin(3.0*px), *std::cos(2.0*py), *std::sin(pz+0.3));
+            xa(i,j,k) = AMREX_D_TERM(px*(1.0-px), *py*(1.0-py), *(1.0+pz));
+        });
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const auto& b = bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(mfi.nodaltilebox(idim), [&] (int i, int j, int k) {
+                b(i,j,k) = 1.0 + 0.5*(problo[0] + i*dx[0]) + 0.25*(problo[1] + j*dx[1]);
+            });
+        }
+    }
+    amrex::EB_set_covered(rhs, 0.0);
+    amrex::EB_set_covered(x, 0.0);
+
+    for (int eb_dirichlet = 0; eb_dirichlet < 2; ++eb_dirichlet)
+    {
+        Result r0 = run(geom, ba, dm, *factory, bcoef, rhs, x, eb_dirichlet, false);
+        Result r1 = run(geom, ba, dm, *factory, bcoef, rhs, x, eb_dirichlet, true);
+
+        const Real dax = relDiff(r0.ax, r1.ax);
+        const Real dax2 = relDiff(r0.ax2, r1.ax2);
+        const Real dsol = relDiff(r0.sol, r1.sol);
+        amrex::Print() << "  " << (eb_dirichlet ? "EB Dirichlet" : "EB Neumann")
+                       << ": apply diff " << dax << " " << dax2 << ", solution diff " << dsol
+                       << ", iterations " << r0.niters << " " << r1.niters
+                       << ", solve time " << r0.time << " " << r1.time << "\n";
+        AMREX_ALWAYS_ASSERT(dax < 1.e-12);
+        AMREX_ALWAYS_ASSERT(dax2 < 1.e-12);
+        AMREX_ALWAYS_ASSERT(relDiff(r0.ax, r0.ax2) > 1.e-3);
+        AMREX_ALWAYS_ASSERT(dsol < 1.e-7);
+        AMREX_ALWAYS_ASSERT(r1.niters <= r0.niters+1);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    testStencil();
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
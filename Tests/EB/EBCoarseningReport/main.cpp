@@ -0,0 +1,121 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBMultiFabUtil.H>
+#include <AMReX_MLEBABecLap.H>
+#include <AMReX_MLMG.H>
+
+using namespace amrex;
+
+struct Result
+{
+    MultiFab sol;
+    int nmglevs;
+    int niters;
+    std::string report;
+};
+
+Result solve (const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm,
+              const EBFArrayBoxFactory& factory, const MultiFab& rhs, const LPInfo& info)
+{
+    MLEBABecLap op({geom}, {ba}, {dm}, info, {&factory});
+    op.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,
+                                 LinOpBCType::Dirichlet)},
+                   {AMREX_D_DECL(LinOpBCType::Dirichlet,LinOpBCType::Dirichlet,
+                                 LinOpBCType::Dirichlet)});
+    op.setLevelBC(0, nullptr);
+    op.setScalars(0.0, 1.0);
+    op.setBCoeffs(0, 1.0);
+
+    MLMG mlmg(op);
+
+    Result r;
+    r.sol.define(ba, dm, 1, 1, MFInfo(), factory);
+    r.sol.setVal(0.0);
+    mlmg.solve({&r.sol}, {&rhs}, 1.e-10, 0.0);
+    r.niters = mlmg.getNumIters();
+    r.report = op.coarseningReport();
+    r.nmglevs = std::atoi(r.report.c_str() + std::string("MLLinOp: ").size());
+    return r;
+}
+
+void test (const std::string& name, const Geometry& geom, const BoxArray& ba,
+           const DistributionMapping& dm, EB2::CoarseningStop expected)
+{
+    const EB2::IndexSpace& ebis = EB2::IndexSpace::top();
+    amrex::Print() << name << ": EB coarsening stopped because "
+                   << EB2::coarseningStopReason(ebis.coarseningStop()) << "\n";
+    AMREX_ALWAYS_ASSERT(ebis.coarseningStop() == expected);
+
+    auto factory = makeEBFabFactory(geom, ba, dm, {2,2,2}, EBSupport::full);
+
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    MultiFab rhs(ba, dm, 1, 0, MFInfo(), *factory);
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+        const auto& r = rhs.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) {
+            AMREX_D_TERM(Real px = problo[0] + (i+0.5)*dx[0];,
+                         Real py = problo[1] + (j+0.5)*dx[1];,
+                         Real pz = problo[2] + (k+0.5)*dx[2];);
+            r(i,j,k) = AMREX_D_TERM(std::sin(3.0*px), *std::cos(2.0*py), *std::sin(pz+0.3));
+        });
+    }
+    amrex::EB_set_covered(rhs, 0.0);
+
+    LPInfo info;
+    info.setAgglomeration(false);
+    Result r0 = solve(geom, ba, dm, *factory, rhs, info);
+    info.setEBBottomMerging(true);
+    Result r1 = solve(geom, ba, dm, *factory, rhs, info);
+
+    amrex::Print() << r1.report;
+
+    MultiFab d(ba, dm, 1, 0);
+    MultiFab::LinComb(d, 1.0, r0.sol, 0, -1.0, r1.sol, 0, 0, 1, 0);
+    const Real dsol = d.norm0() / r0.sol.norm0();
+    amrex::Print() << "  solution diff " << dsol << ", iterations "
+                   << r0.niters << " " << r1.niters << "\n";
+
+    const int eb_levels = EB2::maxCoarseningLevel(geom) + 1;
+    AMREX_ALWAYS_ASSERT(r0.nmglevs == eb_levels && r1.nmglevs == eb_levels);
+    AMREX_ALWAYS_ASSERT(r0.report.find("EB index space") != std::string::npos);
+    AMREX_ALWAYS_ASSERT(r0.report.find(EB2::coarseningStopReason(expected)) != std::string::npos);
+    AMREX_ALWAYS_ASSERT(r0.report.find("merged") == std::string::npos);
+    AMREX_ALWAYS_ASSERT(r1.report.find("merged") != std::string::npos);
+    AMREX_ALWAYS_ASSERT(dsol < 1.e-7);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp("report");
+        int n_cell, max_grid_size;
+        pp.get("n_cell", n_cell);
+        pp.get("max_grid_size", max_grid_size);
+
+        RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        // The sphere could be coarsened further, but the index space is built
+        // with only two coarse levels.
+        EB2::SphereIF sphere(0.27, {AMREX_D_DECL(0.51,0.48,0.5)}, false);
+        EB2::Build(EB2::makeShop(sphere), geom, 0, 2);
+        test("sphere", geom, ba, dm, EB2::CoarseningStop::MaxLevel);
+
+        // Coarse cells next to a thin wall would have fluid on both sides.
+        EB2::BoxIF wall({AMREX_D_DECL(0.45,-1.0,-1.0)}, {AMREX_D_DECL(0.48,2.0,2.0)}, false);
+        EB2::Build(EB2::makeShop(wall), geom, 0, 30);
+        test("wall", geom, ba, dm, EB2::CoarseningStop::MultiValued);
+    }
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
@@ -0,0 +1,250 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBMultiFabUtil.H>
+#include <AMReX_EBFluxRegister.H>
+#include <AMReX_EBRedistribution.H>
+#include <AMReX_EB_utils.H>
+
+#include <limits>
+
+using namespace amrex;
+
+void fillData (MultiFab& divc, MultiFab& weights, const Geometry& geom)
+{
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(divc); mfi.isValid(); ++mfi) {
+        const Box& bx = mfi.fabbox();
+        auto const& d = divc.array(mfi);
+        auto const& w = weights.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k) noexcept
+        {
+            AMREX_D_TERM(const Real x = (i+0.5)*dx[0];,
+                         const Real y = (j+0.5)*dx[1];,
+                         const Real z = (k+0.5)*dx[2];);
+            d(i,j,k,0) = std::sin(2.*M_PI*x) * std::cos(2.*M_PI*y) + AMREX_D_PICK(0.,0.,z);
+            d(i,j,k,1) = 1.0 + AMREX_D_TERM(x, + 2.*y*y, - std::cos(4.*M_PI*z));
+            w(i,j,k) = 1.0 + AMREX_D_TERM(x, + 0.5*y, + 0.25*z);
+        });
+    }
+    divc.FillBoundary(geom.periodicity());
+    weights.FillBoundary(geom.periodicity());
+}
+
+// The redistribution with the bookkeeping of the CNS tutorial, by scattering
+// the excess mass of each cut cell.
+void referenceReflux (const MultiFab& divc, const MultiFab& weights, Real dt,
+                      EBFluxRegister* fr_as_crse, EBFluxRegister* fr_as_fine)
+{
+    auto const& factory = dynamic_cast<EBFArrayBoxFactory const&>(divc.Factory());
+    auto const& flags = factory.getMultiEBCellFlagFab();
+    auto const& volfrac = factory.getVolFrac();
+    const Geometry& geom = factory.Geom();
+    const Box dbox = geom.growPeriodicDomain(2);
+    const int ncomp = divc.nComp();
+    const Real threshold = amrex_eb_get_reredistribution_threshold();
+
+    iMultiFab lmask(divc.boxArray(), divc.DistributionMap(), 1, 1);
+    lmask.BuildMask(geom.Domain(), geom.periodicity(), 1, 2, 3, 0);
+
+    for (MFIter mfi(divc); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        auto const& flag = flags.const_array(mfi);
+        auto const& vfrac = volfrac.const_array(mfi);
+        auto const& d = divc.const_array(mfi);
+        auto const& w = weights.const_array(mfi);
+        auto const& lm = lmask.const_array(mfi);
+
+        const bool as_crse = fr_as_crse && fr_as_crse->CrseHasWork(mfi);
+        const bool as_fine = fr_as_fine && fr_as_fine->FineHasWork(mfi);
+        if (!as_crse && !as_fine) continue;
+        Array4<Real> rr_drho;
+        Array4<int const> rr_flag;
+        if (as_crse) {
+            rr_drho = fr_as_crse->getCrseData(mfi)->array();
+            rr_flag = fr_as_crse->getCrseFlag(mfi)->const_array();
+        }
+        FArrayBox dm_as_fine(amrex::grow(bx,1), ncomp);
+        dm_as_fine.setVal<RunOn::Host>(0.0);
+        auto const& dmf = dm_as_fine.array();
+
+        amrex::LoopOnCpu(amrex::grow(bx,1), [&] (int i, int j, int k) noexcept
+        {
+            if (!flag(i,j,k).isSingleValued()) return;
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            Vector<IntVect> nbrs;
+            for (int kk = AMREX_D_PICK(0,0,-1); kk <= AMREX_D_PICK(0,0,1); ++kk) {
+            for (int jj = -1; jj <= 1; ++jj) {
+            for (int ii = -1; ii <= 1; ++ii) {
+                const IntVect nb = iv + IntVect(AMREX_D_DECL(ii,jj,kk));
+                if ((ii != 0 || jj != 0 || kk != 0) &&
+                    flag(i,j,k).isConnected(ii,jj,kk) && dbox.contains(nb)) {
+                    nbrs.push_back(nb);
+                }
+            }}}
+            Real vtot = 0.0;
+            for (auto const& nb : nbrs) vtot += vfrac(nb)*w(nb);
+            for (int n = 0; n < ncomp; ++n)
+            {
+                Real divnc = 0.0;
+                for (auto const& nb : nbrs) divnc += vfrac(nb)*w(nb)*d(nb,n);
+                divnc /= (vtot + 1.e-80);
+                const Real mask = dbox.contains(iv) ? 1.0 : 0.0;
+                const Real delm = -vfrac(iv)*(1.0-vfrac(iv))*(divnc - d(iv,n)*mask);
+                for (auto const& nb : nbrs)
+                {
+                    const Real drho = delm*w(nb)/(vtot + 1.e-80);
+                    if (as_crse && bx.contains(iv) &&
+                        rr_flag(iv) == YAFluxRegister::crse_fine_boundary_cell &&
+                        rr_flag(nb) == YAFluxRegister::fine_cell && vfrac(iv) > threshold) {
+                        rr_drho(iv,n) += dt*drho*(vfrac(nb)/vfrac(iv));
+                    }
+                    if (as_crse && rr_flag(iv) == YAFluxRegister::fine_cell && bx.contains(nb) &&
+                        rr_flag(nb) == YAFluxRegister::crse_fine_boundary_cell &&
+                        vfrac(nb) > threshold) {
+                        rr_drho(nb,n) -= dt*drho;
+                    }
+                    if (as_fine && bx.contains(iv) && !bx.contains(nb)) {
+                        dmf(nb,n) += dt*drho*vfrac(nb);
+                    }
+                    if (as_fine && lm(iv) == 2 && bx.contains(nb)) {
+                        dmf(iv,n) -= dt*drho*vfrac(nb);
+                    }
+                }
+            }
+        });
+
+        if (as_fine) {
+            fr_as_fine->FineAddDM(mfi, volfrac[mfi], dm_as_fine, RunOn::Cpu);
+        }
+    }
+}
+
+Real maxRelDiff (const MultiFab& a, const MultiFab& b, const MultiFab& vfrac)
+{
+    Real dmax = 0.0, amax = 0.0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& x = a.const_array(mfi);
+        auto const& y = b.const_array(mfi);
+        auto const& vf = vfrac.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), a.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            if (vf(i,j,k) > 0.0) {
+                dmax = std::max(dmax, std::abs(x(i,j,k,n)-y(i,j,k,n)));
+                amax = std::max(amax, std::abs(x(i,j,k,n)));
+            }
+        });
+    }
+    ParallelDescriptor::ReduceRealMax(dmax);
+    ParallelDescriptor::ReduceRealMax(amax);
+    return dmax / std::max(amax, std::numeric_limits<Real>::min());
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp("redist");
+        int n_cell, max_grid_size;
+        pp.get("n_cell", n_cell);
+        pp.get("max_grid_size", max_grid_size);
+
+        const int ncomp = 2;
+        const IntVect ratio(2);
+
+        RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+        Box cdomain(IntVect(0), IntVect(n_cell-1));
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, {AMREX_D_DECL(1,1,1)});
+        Geometry fgeom(amrex::refine(cdomain,ratio), rb, CoordSys::cartesian, {AMREX_D_DECL(1,1,1)});
+
+        EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+        EB2::Build(EB2::makeShop(sphere), fgeom, 1, 1);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+        BoxArray fba(amrex::refine(Box(IntVect(n_cell/4), IntVect(n_cell*5/8-1)), ratio));
+        fba.maxSize(max_grid_size);
+        DistributionMapping fdm(fba);
+
+        auto cfact = makeEBFabFactory(cgeom, cba, cdm, {2,2,2}, EBSupport::full);
+        auto ffact = makeEBFabFactory(fgeom, fba, fdm, {2,2,2}, EBSupport::full);
+
+        MultiFab cdivc(cba, cdm, ncomp, 2, MFInfo(), *cfact);
+        MultiFab cwt(cba, cdm, 1, 2);
+        fillData(cdivc, cwt, cgeom);
+        MultiFab fdivc(fba, fdm, ncomp, 2, MFInfo(), *ffact);
+        MultiFab fwt(fba, fdm, 1, 2);
+        fillData(fdivc, fwt, fgeom);
+
+        // Same as single_level_weighted_redistribute
+        EBRedistributor credist(*cfact, &cwt);
+        MultiFab cdiv(cba, cdm, ncomp, 0, MFInfo(), *cfact);
+        credist.apply(cdiv, 0, cdivc, 0, ncomp);
+
+        MultiFab ctmp(cba, cdm, ncomp, 2, MFInfo(), *cfact);
+        MultiFab::Copy(ctmp, cdivc, 0, 0, ncomp, 2);
+        MultiFab cref(cba, cdm, ncomp, 0, MFInfo(), *cfact);
+        single_level_weighted_redistribute(ctmp, cref, cwt, 0, ncomp, cgeom);
+
+        const Real rdiff = maxRelDiff(cdiv, cref, cfact->getVolFrac());
+        Long nsources = credist.numLocalSources();
+        ParallelDescriptor::ReduceLongSum(nsources);
+        amrex::Print() << "sources " << nsources
+                       << ", difference from single_level_weighted_redistribute " << rdiff << "\n";
+        AMREX_ALWAYS_ASSERT(nsources > 0);
+        AMREX_ALWAYS_ASSERT(rdiff < 1.e-12);
+
+        // The redistribution is conservative in the periodic domain.
+        for (int n = 0; n < ncomp; ++n) {
+            MultiFab diff(cba, cdm, 1, 0);
+            MultiFab::Copy(diff, cdiv, n, 0, 1, 0);
+            MultiFab::Subtract(diff, cdivc, n, 0, 1, 0);
+            const Real dmass = MultiFab::Dot(diff, 0, cfact->getVolFrac(), 0, 1, 0);
+            const Real mass = MultiFab::Dot(cdivc, n, cfact->getVolFrac(), 0, 1, 0);
+            amrex::Print() << "component " << n << ": mass change " << dmass << " of " << mass << "\n";
+            AMREX_ALWAYS_ASSERT(std::abs(dmass) < 1.e-12*(1.0+std::abs(mass)));
+        }
+
+        // The re-redistribution data agree with those of the scattering loops.
+        const Real dt = 0.1;
+        EBRedistributor fredist(*ffact, &fwt);
+        EBFluxRegister fr(fba, cba, fdm, cdm, fgeom, cgeom, ratio, 1, ncomp);
+        EBFluxRegister frref(fba, cba, fdm, cdm, fgeom, cgeom, ratio, 1, ncomp);
+        fr.reset();
+        frref.reset();
+
+        MultiFab fout(fba, fdm, ncomp, 0, MFInfo(), *ffact);
+        credist.apply(cdiv, 0, cdivc, 0, ncomp, dt, &fr, nullptr);
+        fredist.apply(fout, 0, fdivc, 0, ncomp, dt, nullptr, &fr);
+        referenceReflux(cdivc, cwt, dt, &frref, nullptr);
+        referenceReflux(fdivc, fwt, dt, nullptr, &frref);
+
+        MultiFab cs(cba, cdm, ncomp, 0, MFInfo(), *cfact);
+        MultiFab fs(fba, fdm, ncomp, 0, MFInfo(), *ffact);
+        MultiFab csref(cba, cdm, ncomp, 0, MFInfo(), *cfact);
+        MultiFab fsref(fba, fdm, ncomp, 0, MFInfo(), *ffact);
+        cs.setVal(0.0);
+        fs.setVal(0.0);
+        csref.setVal(0.0);
+        fsref.setVal(0.0);
+        fr.Reflux(cs, cfact->getVolFrac(), fs, ffact->getVolFrac());
+        frref.Reflux(csref, cfact->getVolFrac(), fsref, ffact->getVolFrac());
+
+        const Real cmax = csref.norm0(0);
+        const Real fmax = fsref.norm0(0);
+        const Real cdiff = maxRelDiff(cs, csref, cfact->getVolFrac());
+        const Real fdiff = maxRelDiff(fs, fsref, ffact->getVolFrac());
+        amrex::Print() << "reflux " << cmax << " " << fmax << ", difference "
+                       << cdiff << " " << fdiff << "\n";
+        AMREX_ALWAYS_ASSERT(cmax > 0.0 && fmax > 0.0);
+        AMREX_ALWAYS_ASSERT(cdiff < 1.e-12 && fdiff < 1.e-12);
+    }
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
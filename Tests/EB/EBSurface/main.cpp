@@ -0,0 +1,202 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBSurface.H>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+
+using namespace amrex;
+
+struct PLYMesh
+{
+    Vector<std::array<float,3> > verts;
+    Vector<Vector<int> > faces;
+};
+
+PLYMesh readPLY (const std::string& filename)
+{
+    std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+    AMREX_ALWAYS_ASSERT(ifs.good());
+    Long nverts = 0, nfaces = 0;
+    std::string line;
+    while (std::getline(ifs, line) && line != "end_header") {
+        std::istringstream is(line);
+        std::string word, element;
+        is >> word;
+        if (word == "element") {
+            is >> element;
+            if (element == "vertex") is >> nverts;
+            if (element == "face") is >> nfaces;
+        }
+    }
+
+    PLYMesh mesh;
+    mesh.verts.resize(nverts);
+    ifs.read(reinterpret_cast<char*>(mesh.verts.data()), nverts*3*sizeof(float));
+    mesh.faces.resize(nfaces);
+    for (auto& f : mesh.faces) {
+        unsigned char n;
+        ifs.read(reinterpret_cast<char*>(&n), 1);
+        f.resize(n);
+        ifs.read(reinterpret_cast<char*>(f.data()), n*sizeof(int));
+    }
+    AMREX_ALWAYS_ASSERT(ifs.good());
+    ifs.peek();
+    AMREX_ALWAYS_ASSERT(ifs.eof());
+    return mesh;
+}
+
+// Checks the mesh of the sphere, and returns the volume it encloses.
+Real checkMesh (const PLYMesh& mesh, Real radius, const RealArray& center, Real dx, bool welded)
+{
+    const int nverts = mesh.verts.size();
+    Vector<int> used(nverts, 0);
+    std::map<std::pair<int,int>,int> edges;
+    Real volume = 0.0;
+    for (auto const& f : mesh.faces) {
+        AMREX_ALWAYS_ASSERT(f.size() >= 3 && f.size() <= 6);
+        for (int m = 0, n = f.size(); m < n; ++m) {
+            AMREX_ALWAYS_ASSERT(f[m] >= 0 && f[m] < nverts);
+            ++used[f[m]];
+            const int a = f[m];
+            const int b = f[(m+1)%n];
+            ++edges[std::make_pair(std::min(a,b),std::max(a,b))];
+        }
+        // The volume by the divergence theorem
+        auto const& p0 = mesh.verts[f[0]];
+        for (int m = 1, n = f.size(); m < n-1; ++m) {
+            auto const& p1 = mesh.verts[f[m]];
+            auto const& p2 = mesh.verts[f[m+1]];
+            volume += (p0[0]*(p1[1]*p2[2]-p1[2]*p2[1])
+                      -p0[1]*(p1[0]*p2[2]-p1[2]*p2[0])
+                      +p0[2]*(p1[0]*p2[1]-p1[1]*p2[0])) / 6.0;
+        }
+    }
+
+    std::set<std::array<float,3> > positions;
+    for (int i = 0; i < nverts; ++i) {
+        AMREX_ALWAYS_ASSERT(used[i] > 0);
+        auto const& p = mesh.verts[i];
+        const Real r = std::sqrt((p[0]-center[0])*(p[0]-center[0]) +
+                                 (p[1]-center[1])*(p[1]-center[1]) +
+                                 (p[2]-center[2])*(p[2]-center[2]));
+        AMREX_ALWAYS_ASSERT(std::abs(r-radius) < dx);
+        positions.insert(p);
+    }
+
+    if (welded) {
+        // Every vertex is written once.  The planes of neighboring cells
+        // need not meet on the faces between them, so the surface has a
+        // few small cracks, but no edge is shared by more than 2 polygons.
+        AMREX_ALWAYS_ASSERT(static_cast<int>(positions.size()) == nverts);
+        Long nopen = 0;
+        for (auto const& e : edges) {
+            AMREX_ALWAYS_ASSERT(e.second <= 2);
+            if (e.second == 1) ++nopen;
+        }
+        amrex::Print() << "  " << nopen << " of " << edges.size() << " edges are open\n";
+        AMREX_ALWAYS_ASSERT(nopen < 0.05*edges.size());
+    }
+    return volume;
+}
+
+int countPolys (const std::string& pvtp)
+{
+    std::ifstream ifs(pvtp);
+    AMREX_ALWAYS_ASSERT(ifs.good());
+    const std::string dir = pvtp.substr(0, pvtp.find_last_of('/')+1);
+    int npieces = 0, npolys = 0;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        const auto pos = line.find("Source=\"");
+        if (pos == std::string::npos) continue;
+        ++npieces;
+        const std::string source = line.substr(pos+8, line.find('"', pos+8)-pos-8);
+        std::ifstream piece(dir+source, std::ios::in | std::ios::binary);
+        AMREX_ALWAYS_ASSERT(piece.good());
+        std::string pline;
+        while (std::getline(piece, pline)) {
+            const auto ppos = pline.find("NumberOfPolys=\"");
+            if (ppos != std::string::npos) {
+                npolys += std::stoi(pline.substr(ppos+15));
+                break;
+            }
+        }
+    }
+    AMREX_ALWAYS_ASSERT(npieces == ParallelDescriptor::NProcs());
+    return npolys;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp("surface");
+        int n_cell, max_grid_size;
+        pp.get("n_cell", n_cell);
+        pp.get("max_grid_size", max_grid_size);
+
+        RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const Real radius = 0.3;
+        const RealArray center{AMREX_D_DECL(0.51,0.48,0.5)};
+        EB2::SphereIF sphere(radius, center, false);
+        EB2::Build(EB2::makeShop(sphere), geom, 0, 0);
+        auto factory = makeEBFabFactory(geom, ba, dm, {2,2,2}, EBSupport::full);
+
+        EBSurface welded = makeEBSurface(*factory, true);
+        EBSurface unwelded = makeEBSurface(*factory, false);
+
+        WriteEBSurfacePLY(welded, "welded");
+        WriteEBSurfacePLY(unwelded, "unwelded");
+        WriteEBSurfaceVTP(welded, "welded");
+
+        Long npolys = welded.numPolygons();
+        Long nverts = welded.numOwnedPoints();
+        Long nconn = unwelded.connectivity.size();
+        ParallelDescriptor::ReduceLongSum(npolys);
+        ParallelDescriptor::ReduceLongSum(nverts);
+        ParallelDescriptor::ReduceLongSum(nconn);
+
+        if (ParallelDescriptor::IOProcessor())
+        {
+            const Real dx = geom.CellSize(0);
+            const Real exact = 4.0/3.0*M_PI*radius*radius*radius;
+
+            PLYMesh wmesh = readPLY("welded.ply");
+            amrex::Print() << "welded: " << wmesh.verts.size() << " vertices, "
+                           << wmesh.faces.size() << " polygons\n";
+            AMREX_ALWAYS_ASSERT(static_cast<Long>(wmesh.verts.size()) == nverts);
+            AMREX_ALWAYS_ASSERT(static_cast<Long>(wmesh.faces.size()) == npolys);
+            const Real wvol = checkMesh(wmesh, radius, center, dx, true);
+
+            PLYMesh umesh = readPLY("unwelded.ply");
+            amrex::Print() << "unwelded: " << umesh.verts.size() << " vertices, "
+                           << umesh.faces.size() << " polygons\n";
+            AMREX_ALWAYS_ASSERT(static_cast<Long>(umesh.verts.size()) == nconn);
+            AMREX_ALWAYS_ASSERT(umesh.faces.size() == wmesh.faces.size());
+            const Real uvol = checkMesh(umesh, radius, center, dx, false);
+
+            amrex::Print() << "volume " << wvol << " " << uvol << ", exact " << exact << "\n";
+            AMREX_ALWAYS_ASSERT(std::abs(wvol-exact) < 0.02*exact);
+            AMREX_ALWAYS_ASSERT(std::abs(uvol-exact) < 0.02*exact);
+
+            AMREX_ALWAYS_ASSERT(countPolys("welded.pvtp") == npolys);
+        }
+    }
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
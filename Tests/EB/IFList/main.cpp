@@ -0,0 +1,145 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+
+using namespace amrex;
+
+// Evaluates every sphere at every point.
+template <bool IsUnion>
+struct BruteForceIF
+{
+    Vector<EB2::SphereIF> fs;
+
+    Real operator() (const RealArray& p) const noexcept
+    {
+        Real r = fs[0](p);
+        for (int i = 1; i < fs.size(); ++i) {
+            r = IsUnion ? std::max(r, fs[i](p)) : std::min(r, fs[i](p));
+        }
+        return r;
+    }
+};
+
+struct Result
+{
+    Real volume;
+    Long ncut;
+    Real time;
+};
+
+template <class IF>
+Result build (IF const& f, const Geometry& geom, const BoxArray& ba, const DistributionMapping& dm)
+{
+    Real t0 = amrex::second();
+    EB2::Build(EB2::makeShop(f), geom, 0, 0);
+    Real t1 = amrex::second() - t0;
+    ParallelDescriptor::ReduceRealMax(t1);
+
+    auto factory = makeEBFabFactory(geom, ba, dm, {1,1,1}, EBSupport::volume);
+    const MultiFab& vfrac = factory->getVolFrac();
+    Long ncut = 0;
+    for (MFIter mfi(vfrac); mfi.isValid(); ++mfi) {
+        const auto& a = vfrac.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) {
+            if (a(i,j,k) > 0.0 && a(i,j,k) < 1.0) ++ncut;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ncut);
+    Result r{vfrac.sum(0), ncut, t1};
+    EB2::IndexSpace::pop();
+    return r;
+}
+
+void testList ()
+{
+    ParmParse pp("iflist");
+    int n_cell, max_grid_size, nspheres;
+    pp.get("n_cell", n_cell);
+    pp.get("max_grid_size", max_grid_size);
+    pp.get("nspheres", nspheres);
+
+    RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // A lattice of spheres with slightly varying radii.
+    const Real h = 1.0/nspheres;
+    Vector<EB2::SphereIF> bodies, holes;
+    Vector<RealBox> bounds;
+    for (int n = 0; n < AMREX_D_TERM(nspheres,*nspheres,*nspheres); ++n) {
+        const IntVect iv(AMREX_D_DECL(n%nspheres, (n/nspheres)%nspheres, n/(nspheres*nspheres)));
+        RealArray c, lo, hi;
+        const Real r = h*(0.3 + 0.01*(n%7));
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            c[d] = (iv[d]+0.5)*h;
+            lo[d] = c[d]-r;
+            hi[d] = c[d]+r;
+        }
+        bodies.push_back(EB2::SphereIF(r, c, false));
+        holes.push_back(EB2::SphereIF(r, c, true));
+        bounds.push_back(RealBox(lo, hi));
+    }
+
+    auto bodylist = EB2::makeUnionList(bodies, bounds);
+    auto holelist = EB2::makeIntersectionList(holes, bounds);
+    AMREX_ALWAYS_ASSERT(bodylist.numFunctions() == bodies.size());
+
+    // Values where the bounds say the function is not needed.
+    {
+        const RealArray gap{AMREX_D_DECL(h, h, h)};
+        AMREX_ALWAYS_ASSERT(bodylist(gap) < 0.0);
+        AMREX_ALWAYS_ASSERT(holelist(gap) > 0.0);
+        const RealArray center{AMREX_D_DECL(0.5*h, 0.5*h, 0.5*h)};
+        AMREX_ALWAYS_ASSERT(bodylist(center) == bodies[0](center));
+        AMREX_ALWAYS_ASSERT(holelist(center) == holes[0](center));
+    }
+
+    // Regions classified from the bounds alone.
+    {
+        const RealArray glo{AMREX_D_DECL(0.95*h, 0.95*h, 0.95*h)};
+        const RealArray ghi{AMREX_D_DECL(1.05*h, 1.05*h, 1.05*h)};
+        AMREX_ALWAYS_ASSERT(bodylist.regionType(glo, ghi) == -1);
+        AMREX_ALWAYS_ASSERT(holelist.regionType(glo, ghi) == 1);
+        const RealArray lo{AMREX_D_DECL(0.45*h, 0.45*h, 0.45*h)};
+        const RealArray hi{AMREX_D_DECL(0.55*h, 0.55*h, 0.55*h)};
+        AMREX_ALWAYS_ASSERT(bodylist.regionType(lo, hi) == 0);
+
+        // The combined functions have it if all their children have it.
+        auto both = EB2::makeUnion(bodylist, bodylist);
+        AMREX_ALWAYS_ASSERT(both.regionType(glo, ghi) == -1);
+        AMREX_ALWAYS_ASSERT(both.regionType(lo, hi) == 0);
+        static_assert(EB2::HasRegionType<decltype(both)>::value, "UnionIF of lists has regionType");
+        static_assert(!EB2::HasRegionType<EB2::UnionIF<EB2::SphereIF> >::value,
+                      "SphereIF does not have regionType");
+    }
+
+    const Result rl = build(bodylist, geom, ba, dm);
+    const Result rb1 = build(BruteForceIF<true>{bodies}, geom, ba, dm);
+    amrex::Print() << "  union of " << bodies.size() << " spheres: fluid volume "
+                   << rl.volume << " " << rb1.volume << ", cut cells " << rl.ncut << " "
+                   << rb1.ncut << ", build time " << rl.time << " " << rb1.time << "\n";
+    AMREX_ALWAYS_ASSERT(rl.ncut > 0 && rl.ncut == rb1.ncut);
+    AMREX_ALWAYS_ASSERT(std::abs(rl.volume - rb1.volume) < 1.e-10*rb1.volume);
+
+    const Result il = build(holelist, geom, ba, dm);
+    const Result ib1 = build(BruteForceIF<false>{holes}, geom, ba, dm);
+    amrex::Print() << "  intersection of " << holes.size() << " complements: fluid volume "
+                   << il.volume << " " << ib1.volume << ", cut cells " << il.ncut << " "
+                   << ib1.ncut << ", build time " << il.time << " " << ib1.time << "\n";
+    AMREX_ALWAYS_ASSERT(il.ncut > 0 && il.ncut == ib1.ncut);
+    AMREX_ALWAYS_ASSERT(std::abs(il.volume - ib1.volume) < 1.e-10*ib1.volume);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    testList();
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
@@ -0,0 +1,153 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Utility.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+
+using namespace amrex;
+
+const std::string cache_dir = "eb2_cache";
+
+struct LevelData
+{
+    FabArray<EBCellFlagFab> cellflag;
+    MultiFab volfrac;
+    MultiFab centroid;
+    MultiFab bndrynorm;
+    Array<MultiFab,AMREX_SPACEDIM> areafrac;
+    MultiFab levelset;
+
+    LevelData (const EB2::Level& lev, const Geometry& geom, const BoxArray& ba,
+               const DistributionMapping& dm)
+        : cellflag(ba, dm, 1, 1),
+          volfrac(ba, dm, 1, 1),
+          centroid(ba, dm, AMREX_SPACEDIM, 1),
+          bndrynorm(ba, dm, AMREX_SPACEDIM, 1),
+          levelset(amrex::convert(ba,IntVect::TheNodeVector()), dm, 1, 0)
+    {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            areafrac[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        lev.fillEBCellFlag(cellflag, geom);
+        lev.fillVolFrac(volfrac, geom);
+        lev.fillCentroid(centroid, geom);
+        lev.fillBndryNorm(bndrynorm, geom);
+        lev.fillAreaFrac(amrex::GetArrOfPtrs(areafrac), geom);
+        lev.fillLevelSet(levelset, geom);
+    }
+};
+
+Real maxDiff (const MultiFab& a, const MultiFab& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), a.nGrow());
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), a.nGrow());
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), a.nGrow());
+    Real r = 0.0;
+    for (int n = 0; n < a.nComp(); ++n) {
+        r = std::max(r, d.norm0(n, a.nGrow()));
+    }
+    return r;
+}
+
+Long countFlagDiff (const FabArray<EBCellFlagFab>& a, const FabArray<EBCellFlagFab>& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        const auto& fa = a.const_array(mfi);
+        const auto& fb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) {
+            if (fa(i,j,k).getValue() != fb(i,j,k).getValue()) ++ndiff;
+        });
+        if (a[mfi].getType() != b[mfi].getType()) ++ndiff;
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+void compare (const LevelData& a, const LevelData& b)
+{
+    AMREX_ALWAYS_ASSERT(countFlagDiff(a.cellflag, b.cellflag) == 0);
+    AMREX_ALWAYS_ASSERT(maxDiff(a.volfrac, b.volfrac) == 0.0);
+    AMREX_ALWAYS_ASSERT(maxDiff(a.centroid, b.centroid) == 0.0);
+    AMREX_ALWAYS_ASSERT(maxDiff(a.bndrynorm, b.bndrynorm) == 0.0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        AMREX_ALWAYS_ASSERT(maxDiff(a.areafrac[idim], b.areafrac[idim]) == 0.0);
+    }
+    AMREX_ALWAYS_ASSERT(maxDiff(a.levelset, b.levelset) == 0.0);
+}
+
+void testCache ()
+{
+    ParmParse pp("cache");
+    int n_cell, max_grid_size, max_coarsening_level;
+    pp.get("n_cell", n_cell);
+    pp.get("max_grid_size", max_grid_size);
+    pp.get("max_coarsening_level", max_coarsening_level);
+
+    RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    if (ParallelDescriptor::IOProcessor()) {
+        amrex::UtilCreateCleanDirectory(cache_dir, false);
+    }
+    ParallelDescriptor::Barrier();
+
+    EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.51,0.48,0.5)}, false);
+    auto gshop = EB2::makeShop(sphere);
+
+    const std::string key = EB2::IndexSpaceCacheKey(gshop, geom, 0, max_coarsening_level,
+                                                    4, true, EB2::ExtendDomainFace());
+    AMREX_ALWAYS_ASSERT(!EB2::IndexSpaceFileExists(cache_dir + "/" + key));
+
+    // The first call builds the index space and writes it.
+    EB2::BuildCached(cache_dir, gshop, geom, 0, max_coarsening_level);
+    AMREX_ALWAYS_ASSERT(EB2::IndexSpaceFileExists(cache_dir + "/" + key));
+    const EB2::IndexSpace* built = &EB2::IndexSpace::top();
+
+    // The second call reads it.
+    EB2::BuildCached(cache_dir, gshop, geom, 0, max_coarsening_level);
+    const EB2::IndexSpace* read = &EB2::IndexSpace::top();
+    AMREX_ALWAYS_ASSERT(dynamic_cast<const EB2::IndexSpaceFromFile*>(read) != nullptr);
+    AMREX_ALWAYS_ASSERT(built->coarsestDomain() == read->coarsestDomain());
+
+    int nlevels = 0;
+    for (Geometry g = geom; ; g = amrex::coarsen(g,2))
+    {
+        // A layout that differs from the one of the index space.
+        BoxArray ba(g.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        LevelData a(built->getLevel(g), g, ba, dm);
+        LevelData b(read->getLevel(g), g, ba, dm);
+        compare(a, b);
+        ++nlevels;
+
+        if (g.Domain() == built->coarsestDomain()) break;
+    }
+    amrex::Print() << "  compared " << nlevels << " levels\n";
+    AMREX_ALWAYS_ASSERT(nlevels == max_coarsening_level+1);
+
+    // A different implicit function has a different key.
+    EB2::SphereIF sphere2(0.31, {AMREX_D_DECL(0.51,0.48,0.5)}, false);
+    const std::string key2 = EB2::IndexSpaceCacheKey(EB2::makeShop(sphere2), geom, 0,
+                                                     max_coarsening_level, 4, true,
+                                                     EB2::ExtendDomainFace());
+    AMREX_ALWAYS_ASSERT(key2 != key);
+
+    // So does a different resolution.
+    const std::string key3 = EB2::IndexSpaceCacheKey(gshop, amrex::refine(geom,2), 0,
+                                                     max_coarsening_level, 4, true,
+                                                     EB2::ExtendDomainFace());
+    AMREX_ALWAYS_ASSERT(key3 != key);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    testCache();
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
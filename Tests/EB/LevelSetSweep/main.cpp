@@ -0,0 +1,126 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EB_levelset.H>
+
+using namespace amrex;
+
+struct Diff
+{
+    Real band;       // largest difference within the band around the EB
+    Real all;        // largest difference where either is below the threshold
+    Long sign_flips; // nodes of opposite signs
+};
+
+Diff compare (const MultiFab& a, const MultiFab& b, Real band, Real threshold)
+{
+    Diff r{0.0, 0.0, 0};
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        const auto& fa = a.const_array(mfi);
+        const auto& fb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) {
+            const Real va = fa(i,j,k);
+            const Real vb = fb(i,j,k);
+            if (std::abs(va) >= threshold && std::abs(vb) >= threshold) return;
+            const Real d = std::abs(va - vb);
+            r.all = std::max(r.all, d);
+            if (std::abs(va) <= band) r.band = std::max(r.band, d);
+            if (va*vb < 0.0) ++r.sign_flips;
+        });
+    }
+    ParallelDescriptor::ReduceRealMax(r.band);
+    ParallelDescriptor::ReduceRealMax(r.all);
+    ParallelDescriptor::ReduceLongSum(r.sign_flips);
+    return r;
+}
+
+void testSweep ()
+{
+    ParmParse pp("sweep");
+    int n_cell, max_grid_size, eb_pad;
+    pp.get("n_cell", n_cell);
+    pp.get("max_grid_size", max_grid_size);
+    pp.get("eb_pad", eb_pad);
+
+    RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    EB2::SphereIF sphere(0.27, {AMREX_D_DECL(0.51,0.48,0.5)}, false);
+    auto gshop = EB2::makeShop(sphere);
+    EB2::Build(gshop, geom, 1, 1);
+
+    const Real dx = geom.CellSize(0);
+    const Real threshold = dx*(eb_pad+1);
+
+    LSFactory brute(0, 1, 1, 2, eb_pad, ba, geom, dm);
+    LSFactory sweep(0, 1, 1, 2, eb_pad, ba, geom, dm);
+
+    auto factory = makeEBFabFactory(geom, brute.get_eb_ba(), dm, {eb_pad, eb_pad, eb_pad},
+                                    EBSupport::full);
+    GShopLSFactory<EB2::SphereIF> ls_gshop(gshop, brute);
+    std::unique_ptr<MultiFab> impfunc = ls_gshop.fill_impfunc();
+
+    Real t0 = amrex::second();
+    brute.Fill(*factory, *impfunc);
+    Real t_brute = amrex::second() - t0;
+
+    t0 = amrex::second();
+    std::unique_ptr<iMultiFab> region = sweep.FillSweep(*factory, *impfunc);
+    Real t_sweep = amrex::second() - t0;
+
+    ParallelDescriptor::ReduceRealMax(t_brute);
+    ParallelDescriptor::ReduceRealMax(t_sweep);
+
+    // Exact near the EB, first-order accurate away from it
+    const Diff d = compare(*brute.get_data(), *sweep.get_data(), 2.0*dx, threshold);
+    amrex::Print() << "  sweep vs brute force: band " << d.band << ", all " << d.all
+                   << ", sign flips " << d.sign_flips << ", time " << t_sweep
+                   << " " << t_brute << "\n";
+    AMREX_ALWAYS_ASSERT(d.band < 1.e-12);
+    AMREX_ALWAYS_ASSERT(d.all < dx);
+    AMREX_ALWAYS_ASSERT(d.sign_flips == 0);
+    AMREX_ALWAYS_ASSERT(sweep.get_data()->max(0) <= threshold);
+    AMREX_ALWAYS_ASSERT(sweep.get_data()->min(0) >= -threshold);
+    AMREX_ALWAYS_ASSERT(region->max(0) == 1);
+
+    // Starting from a coarser level-set gives the same result
+    {
+        const Geometry cgeom = amrex::coarsen(geom, 2);
+        const BoxArray cba = amrex::coarsen(ba, 2);
+        const int ceb_pad = eb_pad/2;
+        LSFactory crse(0, 1, 1, 2, ceb_pad, cba, cgeom, dm);
+        auto cfactory = makeEBFabFactory(cgeom, crse.get_eb_ba(), dm, {ceb_pad, ceb_pad, ceb_pad},
+                                         EBSupport::full);
+        GShopLSFactory<EB2::SphereIF> cls_gshop(gshop, crse);
+        std::unique_ptr<MultiFab> cimpfunc = cls_gshop.fill_impfunc();
+        crse.Fill(*cfactory, *cimpfunc);
+
+        LSFactory fine(0, 1, 1, 2, eb_pad, ba, geom, dm);
+        t0 = amrex::second();
+        fine.FillSweep(*factory, *impfunc, crse);
+        Real t_fine = amrex::second() - t0;
+        ParallelDescriptor::ReduceRealMax(t_fine);
+
+        const Diff dc = compare(*sweep.get_data(), *fine.get_data(), 2.0*dx, threshold);
+        amrex::Print() << "  sweep from coarse vs sweep: band " << dc.band << ", all " << dc.all
+                       << ", sign flips " << dc.sign_flips << ", time " << t_fine << "\n";
+        AMREX_ALWAYS_ASSERT(dc.band < 1.e-12);
+        AMREX_ALWAYS_ASSERT(dc.all < dx);
+        AMREX_ALWAYS_ASSERT(dc.sign_flips == 0);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    testSweep();
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
@@ -0,0 +1,218 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBRedistribution.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+using Shop = EB2::GeometryShop<EB2::UnionIF<EB2::SphereIF,EB2::BoxIF> >;
+
+// A static sphere and a piston moving in the x-direction
+Shop makeGeometry (Real xpiston)
+{
+    EB2::SphereIF sphere(0.15, {AMREX_D_DECL(0.7,0.6,0.5)}, false);
+    EB2::BoxIF piston({AMREX_D_DECL(xpiston, -1.0, -1.0)},
+                      {AMREX_D_DECL(xpiston+0.1, 0.4, 2.0)}, false);
+    return EB2::makeShop(EB2::makeUnion(sphere, piston));
+}
+
+Real maxDiff (const MultiFab& a, const MultiFab& b)
+{
+    Real r = 0.0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& fa = a.const_array(mfi);
+        auto const& fb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), a.nComp(), [&] (int i, int j, int k, int n) noexcept
+        {
+            r = std::max(r, std::abs(fa(i,j,k,n)-fb(i,j,k,n)));
+        });
+    }
+    ParallelDescriptor::ReduceRealMax(r);
+    return r;
+}
+
+Real maxDiff (const MultiCutFab& a, const MultiCutFab& b, Real regular_value)
+{
+    return maxDiff(a.ToMultiFab(regular_value, 0.0), b.ToMultiFab(regular_value, 0.0));
+}
+
+Long numDiffFlags (const FabArray<EBCellFlagFab>& a, const FabArray<EBCellFlagFab>& b)
+{
+    Long r = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi) {
+        auto const& fa = a.const_array(mfi);
+        auto const& fb = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+        {
+            if (fa(i,j,k) != fb(i,j,k)) ++r;
+        });
+        if (a[mfi].getType() != b[mfi].getType()) ++r;
+    }
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+// Compare the data of the updated factory with those of a new one.
+int compareFactories (const EBFArrayBoxFactory& updated, const EBFArrayBoxFactory& fresh)
+{
+    int nerrors = 0;
+    auto check = [&] (const std::string& name, Real diff)
+    {
+        if (diff > 1.e-14) {
+            amrex::Print() << "  " << name << " differs by " << diff << "\n";
+            ++nerrors;
+        }
+    };
+
+    const Long nflags = numDiffFlags(updated.getMultiEBCellFlagFab(),
+                                     fresh.getMultiEBCellFlagFab());
+    if (nflags > 0) {
+        amrex::Print() << "  " << nflags << " cell flags differ\n";
+        ++nerrors;
+    }
+    check("volfrac", maxDiff(updated.getVolFrac(), fresh.getVolFrac()));
+    check("centroid", maxDiff(updated.getCentroid(), fresh.getCentroid(), 0.0));
+    check("bndrycent", maxDiff(updated.getBndryCent(), fresh.getBndryCent(), -1.0));
+    check("bndryarea", maxDiff(updated.getBndryArea(), fresh.getBndryArea(), 0.0));
+    check("bndrynorm", maxDiff(updated.getBndryNormal(), fresh.getBndryNormal(), 0.0));
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        check("areafrac", maxDiff(*updated.getAreaFrac()[idim], *fresh.getAreaFrac()[idim], 1.0));
+        check("facecent", maxDiff(*updated.getFaceCent()[idim], *fresh.getFaceCent()[idim], 0.0));
+    }
+    return nerrors;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int nsteps = 3;
+        {
+            ParmParse pp("moving");
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+        }
+        int eb2_max_grid_size = 64;
+        {
+            ParmParse pp("eb2");
+            pp.query("max_grid_size", eb2_max_grid_size);
+        }
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,1)};
+        Geometry geom(Box(IntVect(0), IntVect(n_cell-1)), rb, 0, is_periodic);
+        const Geometry cgeom = amrex::coarsen(geom, 2);
+        const Real dx = geom.CellSize(0);
+
+        BoxArray ba(geom.Domain());
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const BoxArray cba = amrex::coarsen(ba, 2);
+
+        const Vector<int> ngrow{2,2,2};
+        Real xpiston = 0.1;
+
+        EB2::Build(makeGeometry(xpiston), geom, 0, 2);
+        const EB2::IndexSpace& ebis = EB2::IndexSpace::top();
+
+        auto factory = makeEBFabFactory(geom, ba, dm, ngrow, EBSupport::full);
+        auto cfactory = makeEBFabFactory(&ebis, cgeom, cba, dm, ngrow, EBSupport::full);
+        EBRedistributor redistributor(*factory);
+
+        MultiFab divc(ba, dm, 1, 2, MFInfo(), *factory);
+        for (MFIter mfi(divc); mfi.isValid(); ++mfi) {
+            auto const& d = divc.array(mfi);
+            amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+            {
+                d(i,j,k) = 1.0 + 0.01*(i+2*j+3*k);
+            });
+        }
+
+        int nerrors = 0;
+        for (int step = 1; step <= nsteps; ++step)
+        {
+            MultiFab old_volfrac(ba, dm, 1, 2);
+            MultiFab::Copy(old_volfrac, factory->getVolFrac(), 0, 0, 1, 2);
+
+            xpiston += 3*dx;
+            EB2::Update(makeGeometry(xpiston));
+            factory->update();
+            cfactory->update();
+            redistributor.update();
+
+            // Every box whose data change must be reported, and the boxes
+            // far away from the piston must not.  The level set of a box of
+            // the IndexSpace has 2 ghost nodes, and the EB data of the
+            // factory have 2 ghost cells.
+            const int front = static_cast<int>((xpiston+0.1)/dx) + 2;
+            const int last_dirty = (front/eb2_max_grid_size + 1)*eb2_max_grid_size - 1;
+            const auto& dirty = factory->getDirtyBoxes();
+            Long ndirty = 0;
+            for (MFIter mfi(old_volfrac); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.validbox();
+                ndirty += dirty[mfi];
+                auto const& a = old_volfrac.const_array(mfi);
+                auto const& b = factory->getVolFrac().const_array(mfi);
+                bool changed = false;
+                amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k) noexcept
+                {
+                    if (a(i,j,k) != b(i,j,k)) changed = true;
+                });
+                if (changed && !dirty[mfi]) {
+                    amrex::AllPrint() << "  box " << bx << " changed but is not dirty\n";
+                    ++nerrors;
+                }
+                if (dirty[mfi] && bx.smallEnd(0)-3 > last_dirty) {
+                    amrex::AllPrint() << "  box " << bx << " is far from the piston but dirty\n";
+                    ++nerrors;
+                }
+            }
+            ParallelDescriptor::ReduceLongSum(ndirty);
+            amrex::Print() << "Step " << step << ": " << ndirty << " of " << ba.size()
+                           << " boxes are dirty\n";
+            if (ndirty == 0 || ndirty == ba.size()) {
+                amrex::Print() << "  the dirty boxes are not the boxes near the piston\n";
+                ++nerrors;
+            }
+
+            // The updated geometry must be the same as a new one.
+            EB2::Build(makeGeometry(xpiston), geom, 0, 2);
+            {
+                auto fresh = makeEBFabFactory(geom, ba, dm, ngrow, EBSupport::full);
+                auto cfresh = makeEBFabFactory(&EB2::IndexSpace::top(), cgeom, cba, dm,
+                                               ngrow, EBSupport::full);
+                nerrors += compareFactories(*factory, *fresh);
+                nerrors += compareFactories(*cfactory, *cfresh);
+
+                // The updated redistribution must be that of the new geometry.
+                EBRedistributor fresh_redistributor(*factory);
+                MultiFab out1(ba, dm, 1, 0, MFInfo(), *factory);
+                MultiFab out2(ba, dm, 1, 0, MFInfo(), *factory);
+                redistributor.apply(out1, 0, divc, 0, 1);
+                fresh_redistributor.apply(out2, 0, divc, 0, 1);
+                const Real diff = maxDiff(out1, out2);
+                if (diff != 0.0) {
+                    amrex::Print() << "  redistribution differs by " << diff << "\n";
+                    ++nerrors;
+                }
+            }
+            EB2::IndexSpace::pop();
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerrors);
+        if (nerrors > 0) {
+            amrex::Abort("MovingEB: " + std::to_string(nerrors) + " errors");
+        }
+        amrex::Print() << "MovingEB: the updated geometry is the same as a new one\n";
+    }
+    amrex::Finalize();
+}
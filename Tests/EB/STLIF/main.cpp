@@ -0,0 +1,209 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+
+using namespace amrex;
+
+const RealArray cube_lo {0.213, 0.207, 0.221};
+const RealArray cube_hi {0.791, 0.803, 0.787};
+
+// The surface of the cube, with each face split into nsub x nsub squares of two triangles.
+Vector<Real> cubeTriangles (int nsub)
+{
+    Vector<Real> tri;
+    for (int d = 0; d < 3; ++d) {
+        const int d1 = (d+1)%3;
+        const int d2 = (d+2)%3;
+        const Real h1 = (cube_hi[d1]-cube_lo[d1])/nsub;
+        const Real h2 = (cube_hi[d2]-cube_lo[d2])/nsub;
+        for (int side = 0; side < 2; ++side) {
+            const Real x = side ? cube_hi[d] : cube_lo[d];
+            for (int j = 0; j < nsub; ++j) {
+                for (int i = 0; i < nsub; ++i) {
+                    Real c[4][3];
+                    for (int n = 0; n < 4; ++n) {
+                        c[n][d] = x;
+                        c[n][d1] = cube_lo[d1] + (i + (n==1 || n==2))*h1;
+                        c[n][d2] = cube_lo[d2] + (j + (n>=2))*h2;
+                    }
+                    for (int n : {0,1,2,0,2,3}) {
+                        tri.insert(tri.end(), c[n], c[n]+3);
+                    }
+                }
+            }
+        }
+    }
+    return tri;
+}
+
+void writeASCII (const std::string& filename, const Vector<Real>& tri)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream ofs(filename);
+        ofs << std::setprecision(17);
+        ofs << "solid cube\n";
+        for (Long i = 0; i < tri.size(); i += 9) {
+            ofs << "facet normal 0 0 0\n outer loop\n";
+            for (int n = 0; n < 3; ++n) {
+                ofs << "  vertex " << tri[i+3*n] << " " << tri[i+3*n+1] << " " << tri[i+3*n+2] << "\n";
+            }
+            ofs << " endloop\nendfacet\n";
+        }
+        ofs << "endsolid cube\n";
+    }
+    ParallelDescriptor::Barrier();
+}
+
+void writeBinary (const std::string& filename, const Vector<Real>& tri)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream ofs(filename, std::ios::binary);
+        char header[80] = {};
+        ofs.write(header, 80);
+        std::uint32_t ntri = tri.size() / 9;
+        ofs.write(reinterpret_cast<char*>(&ntri), sizeof(ntri));
+        for (Long i = 0; i < tri.size(); i += 9) {
+            float v[12] = {};
+            for (int n = 0; n < 9; ++n) v[3+n] = tri[i+n];
+            ofs.write(reinterpret_cast<char*>(v), sizeof(v));
+            std::uint16_t attr = 0;
+            ofs.write(reinterpret_cast<char*>(&attr), sizeof(attr));
+        }
+    }
+    ParallelDescriptor::Barrier();
+}
+
+Real cubeDistance (const RealArray& p)
+{
+    Real out = 0.0;
+    Real in = std::numeric_limits<Real>::max();
+    for (int d = 0; d < 3; ++d) {
+        Real o = std::max(std::max(cube_lo[d]-p[d], p[d]-cube_hi[d]), Real(0.0));
+        out += o*o;
+        in = std::min(in, std::min(p[d]-cube_lo[d], cube_hi[d]-p[d]));
+    }
+    return (out > 0.0) ? std::sqrt(out) : in;
+}
+
+// Compare with the exact distance at npoints pseudo-random points.
+void testValues (const EB2::STLIF& stl, const EB2::BoxIF& box, int npoints, Real tol)
+{
+    std::uint64_t state = 12345;
+    auto random = [&state] () -> Real {
+        state = state*6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<Real>(state >> 11) / static_cast<Real>(1ULL << 53);
+    };
+
+    for (int i = 0; i < npoints; ++i)
+    {
+        const RealArray p{random(), random(), random()};
+        const Real v = stl(p);
+        const Real exact = cubeDistance(p);
+        if (std::abs(box(p)) > tol) {
+            AMREX_ALWAYS_ASSERT((v > 0.0) == (box(p) > 0.0));
+        }
+        AMREX_ALWAYS_ASSERT(std::abs(std::abs(v) - exact) < tol);
+    }
+}
+
+void testRegionType (const EB2::STLIF& stl)
+{
+    // The fluid is outside the cube.
+    AMREX_ALWAYS_ASSERT(stl.regionType({0.05,0.05,0.05}, {0.1,0.9,0.1}) == -1);
+    AMREX_ALWAYS_ASSERT(stl.regionType({0.4,0.4,0.4}, {0.6,0.6,0.6}) == 1);
+    AMREX_ALWAYS_ASSERT(stl.regionType({0.1,0.4,0.4}, {0.3,0.6,0.6}) == 0);
+}
+
+template <class IF>
+std::pair<Real,Long> volumeAndCutCells (IF const& f, const Geometry& geom, const BoxArray& ba,
+                                        const DistributionMapping& dm)
+{
+    EB2::Build(EB2::makeShop(f), geom, 0, 0);
+    auto factory = makeEBFabFactory(geom, ba, dm, {1,1,1}, EBSupport::volume);
+    const MultiFab& vfrac = factory->getVolFrac();
+    Real vol = vfrac.sum(0);
+    Long ncut = 0;
+    for (MFIter mfi(vfrac); mfi.isValid(); ++mfi) {
+        const auto& a = vfrac.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k) {
+            if (a(i,j,k) > 0.0 && a(i,j,k) < 1.0) ++ncut;
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ncut);
+    EB2::IndexSpace::pop();
+    return std::make_pair(vol, ncut);
+}
+
+void testBuild (const EB2::STLIF& stl, const EB2::BoxIF& box, Real tol)
+{
+    ParmParse pp("stl");
+    int n_cell, max_grid_size;
+    pp.get("n_cell", n_cell);
+    pp.get("max_grid_size", max_grid_size);
+
+    RealBox rb({0.0,0.0,0.0}, {1.0,1.0,1.0});
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    Geometry geom(domain, rb, CoordSys::cartesian, {0,0,0});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    const auto r_stl = volumeAndCutCells(stl, geom, ba, dm);
+    const auto r_box = volumeAndCutCells(box, geom, ba, dm);
+
+    amrex::Print() << "  fluid volume: " << r_stl.first << " " << r_box.first
+                   << ", cut cells: " << r_stl.second << " " << r_box.second << "\n";
+
+    AMREX_ALWAYS_ASSERT(r_stl.second > 0);
+    AMREX_ALWAYS_ASSERT(r_stl.second == r_box.second);
+    AMREX_ALWAYS_ASSERT(std::abs(r_stl.first-r_box.first) < tol*r_box.first);
+}
+
+void testSTL ()
+{
+    ParmParse pp("stl");
+    int nsub, npoints;
+    pp.get("nsub", nsub);
+    pp.get("npoints", npoints);
+
+    const Vector<Real> tri = cubeTriangles(nsub);
+    const Long ntri = tri.size() / 9;
+
+    // The fluid is outside the cube.
+    EB2::BoxIF box(cube_lo, cube_hi, false);
+
+    amrex::Print() << "Testing a triangle soup of " << ntri << " triangles\n";
+    EB2::STLIF soup(tri, false);
+    AMREX_ALWAYS_ASSERT(soup.numTriangles() == ntri);
+    testValues(soup, box, npoints, 1.e-12);
+    testRegionType(soup);
+    testBuild(soup, box, 1.e-10);
+
+    amrex::Print() << "Testing an ASCII STL file\n";
+    writeASCII("cube_ascii.stl", tri);
+    EB2::STLIF ascii("cube_ascii.stl", false);
+    AMREX_ALWAYS_ASSERT(ascii.numTriangles() == ntri);
+    testValues(ascii, box, npoints, 1.e-12);
+
+    amrex::Print() << "Testing a binary STL file\n";
+    writeBinary("cube_binary.stl", tri);
+    EB2::STLIF binary("cube_binary.stl", false);
+    AMREX_ALWAYS_ASSERT(binary.numTriangles() == ntri);
+    testValues(binary, box, npoints, 1.e-6);
+    testBuild(binary, box, 1.e-5);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    testSTL();
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
@@ -0,0 +1,124 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_EBMultiFabUtil.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+
+using namespace amrex;
+
+// Largest difference between the dense data and the other data over the
+// cells of the dense fabs, including ghost cells.
+Real maxDiff (const MultiCutFab& dense, const EBCutData& other,
+              const FabArray<EBCellFlagFab>& flags)
+{
+    Real r = 0.0;
+    for (MFIter mfi(dense.data()); mfi.isValid(); ++mfi) {
+        if (flags[mfi].getType() != FabType::singlevalued) continue;
+        const auto& a = dense.const_array(mfi);
+        const auto& b = other.const_array(mfi);
+        const int ncomp = dense.nComp();
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n) {
+            r = std::max(r, std::abs(a(i,j,k,n)-b(i,j,k,n)));
+        });
+    }
+    ParallelDescriptor::ReduceRealMax(r);
+    return r;
+}
+
+Real maxDiff (const MultiCutFab& a, const MultiCutFab& b, const FabArray<EBCellFlagFab>& flags)
+{
+    return maxDiff(a, EBCutData(&b, nullptr), flags);
+}
+
+Real maxDiff (const MultiFab& a, const MultiFab& b)
+{
+    MultiFab d(a.boxArray(), a.DistributionMap(), a.nComp(), 0);
+    MultiFab::Copy(d, a, 0, 0, a.nComp(), 0);
+    MultiFab::Subtract(d, b, 0, 0, a.nComp(), 0);
+    return d.norm0();
+}
+
+void testSparse ()
+{
+    ParmParse pp("sparse");
+    int n_cell, max_grid_size;
+    pp.get("n_cell", n_cell);
+    pp.get("max_grid_size", max_grid_size);
+
+    RealBox rb({AMREX_D_DECL(0.0,0.0,0.0)}, {AMREX_D_DECL(1.0,1.0,1.0)});
+    Box domain(IntVect(0), IntVect(n_cell-1));
+    Geometry geom(domain, rb, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // A thin slab, so that most cells of the cut boxes are regular or covered.
+    EB2::PlaneIF lower({AMREX_D_DECL(0.5,0.5,0.5)}, {AMREX_D_DECL(0.1,-1.0,0.2)}, false);
+    EB2::PlaneIF upper({AMREX_D_DECL(0.5,0.53,0.5)}, {AMREX_D_DECL(-0.1,1.0,-0.2)}, false);
+    EB2::Build(EB2::makeShop(EB2::makeIntersection(lower, upper)), geom, 0, 0);
+
+    const Vector<int> ng{3,3,3};
+    auto dense = makeEBFabFactory(geom, ba, dm, ng, EBSupport::full);
+    AMREX_ALWAYS_ASSERT(!dense->hasSparseCutData());
+
+    ParmParse ppeb2("eb2");
+    ppeb2.add("sparse_cut_data", true);
+    auto sparse = makeEBFabFactory(geom, ba, dm, ng, EBSupport::full);
+    AMREX_ALWAYS_ASSERT(sparse->hasSparseCutData());
+
+    const auto& flags = dense->getMultiEBCellFlagFab();
+    AMREX_ALWAYS_ASSERT(sparse->getBndryCentData().isSparse());
+
+    // The sparse views return what the dense data hold.
+    AMREX_ALWAYS_ASSERT(maxDiff(dense->getCentroid(), sparse->getCentroidData(), flags) == 0.0);
+    AMREX_ALWAYS_ASSERT(maxDiff(dense->getBndryCent(), sparse->getBndryCentData(), flags) == 0.0);
+    AMREX_ALWAYS_ASSERT(maxDiff(dense->getBndryArea(), sparse->getBndryAreaData(), flags) == 0.0);
+    AMREX_ALWAYS_ASSERT(maxDiff(dense->getBndryNormal(), sparse->getBndryNormalData(), flags) == 0.0);
+
+    // A kernel that reads the sparse data.
+    {
+        MultiFab fine(ba, dm, 1, 0, MFInfo(), *dense);
+        fine.setVal(1.0);
+        BoxArray cba = amrex::coarsen(ba, 2);
+        MultiFab c1(cba, dm, 1, 0);
+        MultiFab c2(cba, dm, 1, 0);
+        EB_average_down_boundaries(fine, c1, 2, 0);
+        MultiFab fine2(ba, dm, 1, 0, MFInfo(), *sparse);
+        fine2.setVal(1.0);
+        EB_average_down_boundaries(fine2, c2, 2, 0);
+        AMREX_ALWAYS_ASSERT(maxDiff(c1, c2) == 0.0);
+        AMREX_ALWAYS_ASSERT(c1.max(0) == 1.0);
+    }
+
+    // Memory of one field, dense vs packed.
+    auto index = std::make_shared<CutCellIndex>(flags);
+    const MultiCutFab& bcent = dense->getBndryCent();
+    MultiSparseCutFab packed(index, bcent, -1.0);
+    Long dense_bytes = 0;
+    for (MFIter mfi(bcent.data()); mfi.isValid(); ++mfi) {
+        if (bcent.ok(mfi)) dense_bytes += bcent[mfi].nBytes();
+    }
+    Long packed_bytes = packed.nBytes();
+    Long index_bytes = index->nBytes();
+    ParallelDescriptor::ReduceLongSum(dense_bytes);
+    ParallelDescriptor::ReduceLongSum(packed_bytes);
+    ParallelDescriptor::ReduceLongSum(index_bytes);
+    amrex::Print() << "  boundary centroid: dense " << dense_bytes << " bytes, packed "
+                   << packed_bytes << " bytes, shared index " << index_bytes << " bytes\n";
+    AMREX_ALWAYS_ASSERT(packed_bytes*4 < dense_bytes);
+
+    MultiCutFab unpacked(ba, dm, AMREX_SPACEDIM, ng[2], flags);
+    packed.copyTo(unpacked);
+    AMREX_ALWAYS_ASSERT(maxDiff(bcent, unpacked, flags) == 0.0);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    testSparse();
+    amrex::Print() << "pass\n";
+    amrex::Finalize();
+}
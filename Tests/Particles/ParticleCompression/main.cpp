@@ -0,0 +1,182 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+#include <map>
+
+using namespace amrex;
+
+static constexpr int NSR = 3;
+static constexpr int NSI = 1;
+static constexpr int NAR = 1;
+static constexpr int NAI = 1;
+
+using PC = ParticleContainer<NSR, NSI, NAR, NAI>;
+
+struct Values
+{
+    std::array<double, AMREX_SPACEDIM+NSR+NAR> r;
+    std::array<int, NSI+NAI> i;
+};
+
+std::map<Long, Values> collect (PC& pc)
+{
+    std::map<Long, Values> particles;
+    for (PC::ParIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        const auto& aos = pti.GetArrayOfStructs();
+        const auto& soa = pti.GetStructOfArrays();
+        for (int k = 0; k < pti.numParticles(); ++k)
+        {
+            const auto& p = aos[k];
+            Values v;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) v.r[d] = p.pos(d);
+            for (int j = 0; j < NSR; ++j) v.r[AMREX_SPACEDIM+j] = p.rdata(j);
+            v.r[AMREX_SPACEDIM+NSR] = soa.GetRealData(0)[k];
+            v.i[0] = p.idata(0);
+            v.i[1] = soa.GetIntData(0)[k];
+            particles[p.id()] = v;
+        }
+    }
+    return particles;
+}
+
+void checkRoundTrip (PC& pc, const Geometry& geom, const DistributionMapping& dm,
+                     const BoxArray& ba, const ParticleIOCompression& compression,
+                     const std::array<double, AMREX_SPACEDIM+NSR+NAR>& tol)
+{
+    pc.SetIOCompression(compression);
+    pc.Checkpoint("chk", "particles");
+
+    PC restarted(geom, dm, ba);
+    restarted.Restart("chk", "particles");
+
+    const auto original = collect(pc);
+    const auto decoded = collect(restarted);
+
+    if (original.size() != decoded.size()) {
+        amrex::Abort("ParticleCompression: wrong number of particles after Restart");
+    }
+
+    for (const auto& kv : original)
+    {
+        const auto it = decoded.find(kv.first);
+        if (it == decoded.end()) {
+            amrex::Abort("ParticleCompression: particle missing after Restart");
+        }
+        for (int j = 0; j < AMREX_SPACEDIM+NSR+NAR; ++j) {
+            double err = std::abs(kv.second.r[j] - it->second.r[j]);
+            // positions are periodic on the unit cube
+            if (j < AMREX_SPACEDIM) err = std::min(err, 1.0-err);
+            if (err > tol[j]) {
+                amrex::Abort("ParticleCompression: real component outside tolerance");
+            }
+        }
+        for (int j = 0; j < NSI+NAI; ++j) {
+            if (kv.second.i[j] != it->second.i[j]) {
+                amrex::Abort("ParticleCompression: int component changed");
+            }
+        }
+    }
+}
+
+void testCompression ()
+{
+    ParmParse pp("compress");
+    IntVect size;
+    pp.get("size", size);
+    int max_grid_size;
+    pp.get("max_grid_size", max_grid_size);
+    int nparticles;
+    pp.get("nparticles", nparticles);
+
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    const Box domain(IntVect::TheZeroVector(), size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+    PC::ParticleInitData pdata = {{1.0, 2.0, 3.0}, {7}, {4.0}, {11}};
+    pc.InitRandom(nparticles, 451, pdata, true);
+
+    // Give every component a value that varies from particle to particle.
+    for (PC::ParIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        auto& aos = pti.GetArrayOfStructs();
+        auto& soa = pti.GetStructOfArrays();
+        for (int k = 0; k < pti.numParticles(); ++k)
+        {
+            auto& p = aos[k];
+            p.rdata(0) = 1.0 + p.pos(0);
+            p.rdata(1) = -1.e3*p.pos(1);
+            p.rdata(2) = p.pos(0)*p.pos(2);
+            p.idata(0) = static_cast<int>(p.id() % 17);
+            soa.GetRealData(0)[k] = 1.e-3*p.pos(2);
+            soa.GetIntData(0)[k] = -static_cast<int>(p.id());
+        }
+    }
+
+    const Real dx = geom.CellSize(0);
+    std::array<double, AMREX_SPACEDIM+NSR+NAR> exact;
+    exact.fill(0.0);
+
+    // Native codecs with block compression must be lossless.
+    ParticleIOCompression lossless;
+    lossless.block_compress = true;
+    checkRoundTrip(pc, geom, dm, ba, lossless, exact);
+
+    // Quantized positions and reduced precision reals, with and without block compression.
+    ParticleIOCompression lossy;
+    lossy.pos_codecs.resize(AMREX_SPACEDIM);
+    for (auto& c : lossy.pos_codecs) {
+        c.type = ParticleRealCodec::Quantized;
+        c.tolerance = 1.e-4*dx;
+    }
+    lossy.real_codecs.resize(NSR+NAR);
+    lossy.real_codecs[0].type = ParticleRealCodec::Float16;
+    lossy.real_codecs[1].type = ParticleRealCodec::Float32;
+    lossy.real_codecs[2].type = ParticleRealCodec::Quantized;
+    lossy.real_codecs[2].tolerance = 1.e-6;
+
+    std::array<double, AMREX_SPACEDIM+NSR+NAR> tol = exact;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) tol[d] = 1.0001e-4*dx;
+    tol[AMREX_SPACEDIM+0] = 2.0*std::ldexp(1.0, -11);  // |rdata(0)| < 2
+    tol[AMREX_SPACEDIM+1] = 1.e3*std::ldexp(1.0, -24);  // |rdata(1)| < 1e3
+    tol[AMREX_SPACEDIM+2] = 1.0001e-6;
+
+    for (int block = 0; block < 2; ++block) {
+        lossy.block_compress = block;
+        checkRoundTrip(pc, geom, dm, ba, lossy, tol);
+    }
+
+    ParticleIOCompression none;
+    checkRoundTrip(pc, geom, dm, ba, none, exact);
+
+    // Spot checks of the half precision conversion.
+    const float halves[] = {0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, 6.103515625e-05f,
+                            5.9604644775390625e-08f, 1.e-3f};
+    for (float h : halves) {
+        const float r = ParticleCompression::halfToFloat(ParticleCompression::floatToHalf(h));
+        if (std::abs(r - h) > std::abs(h)*std::ldexp(1.0f, -11)) {
+            amrex::Abort("ParticleCompression: bad half precision conversion");
+        }
+    }
+
+    amrex::Print() << "ParticleCompression test passed\n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    testCompression();
+    amrex::Finalize();
+}
@@ -6,6 +6,7 @@
 #include "AMReX_Particles.H"
 #include "AMReX_PlotFileUtil.H"
 #include <AMReX_ParticleMesh.H>
+#include <AMReX_ParticleReduce.H>
 
 using namespace amrex;
 
@@ -18,6 +19,23 @@ struct TestParams {
   bool verbose;
 };
 
+typedef ParticleContainer<1 + 2*BL_SPACEDIM> MyParticleContainer;
+
+template <int order>
+void depositShape (const MyParticleContainer& pc, MultiFab& mf,
+                   const GpuArray<Real,AMREX_SPACEDIM>& plo,
+                   const GpuArray<Real,AMREX_SPACEDIM>& dxi)
+{
+  amrex::ParticleToMesh(pc, mf, 0,
+      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
+                            amrex::Array4<amrex::Real> const& rho)
+      {
+          const GpuArray<Real,1+AMREX_SPACEDIM> vals = {p.rdata(0),
+              AMREX_D_DECL(p.rdata(0)*p.rdata(1), p.rdata(0)*p.rdata(2), p.rdata(0)*p.rdata(3))};
+          amrex_deposit_shape<order>(p, vals, rho, 0, plo, dxi);
+      });
+}
+
 void testParticleMesh(TestParams& parms)
 {
 
@@ -48,7 +66,6 @@ void testParticleMesh(TestParams& parms)
   MultiFab partMF(ba, dmap, 1 + BL_SPACEDIM, 1);
   partMF.setVal(0.0);
 
-  typedef ParticleContainer<1 + 2*BL_SPACEDIM> MyParticleContainer;
   MyParticleContainer myPC(geom, dmap, ba);
   myPC.SetVerbose(false);
 
@@ -66,9 +83,8 @@ void testParticleMesh(TestParams& parms)
   int nc = 1 + BL_SPACEDIM;
   const auto plo = geom.ProbLoArray();
   const auto dxi = geom.InvCellSizeArray();
-  amrex::ParticleToMesh(myPC, partMF, 0,
-      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
-                            amrex::Array4<amrex::Real> const& rho)
+  auto deposit = [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
+                                       amrex::Array4<amrex::Real> const& rho)
       {
           amrex::Real lx = (p.pos(0) - plo[0]) * dxi[0] + 0.5;
           amrex::Real ly = (p.pos(1) - plo[1]) * dxi[1] + 0.5;
@@ -105,7 +121,38 @@ void testParticleMesh(TestParams& parms)
                   }
               }
           }
-      });
+      };
+
+  amrex::ParticleToMesh(myPC, partMF, 0, deposit, DepositionMode::Atomic);
+
+  // The buffered host deposition must reproduce the atomic one.
+  MultiFab bufferedMF(ba, dmap, 1 + BL_SPACEDIM, 1);
+  amrex::ParticleToMesh(myPC, bufferedMF, 0, deposit, DepositionMode::Buffered);
+  MultiFab::Subtract(bufferedMF, partMF, 0, 0, nc, 0);
+  for (int comp = 0; comp < nc; ++comp) {
+      const Real err = bufferedMF.norm0(comp);
+      const Real scale = amrex::max(partMF.norm0(comp), Real(1.0));
+      if (err > 1.e-10*scale) {
+          amrex::Abort("Buffered and atomic ParticleToMesh differ");
+      }
+  }
+
+  // The order 1 shape kernel is CIC; the higher orders must conserve mass.
+  MultiFab shapeMF(ba, dmap, nc, 2);
+  depositShape<1>(myPC, shapeMF, plo, dxi);
+  MultiFab::Subtract(shapeMF, partMF, 0, 0, nc, 0);
+  if (shapeMF.norm0(0) > 1.e-10*partMF.norm0(0)) {
+      amrex::Abort("CIC shape deposition differs from the reference");
+  }
+  const Real total_mass = partMF.sum(0);
+  depositShape<2>(myPC, shapeMF, plo, dxi);
+  if (std::abs(shapeMF.sum(0) - total_mass) > 1.e-10*total_mass) {
+      amrex::Abort("TSC deposition does not conserve mass");
+  }
+  depositShape<3>(myPC, shapeMF, plo, dxi);
+  if (std::abs(shapeMF.sum(0) - total_mass) > 1.e-10*total_mass) {
+      amrex::Abort("PQS deposition does not conserve mass");
+  }
 
   MultiFab acceleration(ba, dmap, BL_SPACEDIM, 1);
   acceleration.setVal(5.0);
@@ -141,7 +188,28 @@ void testParticleMesh(TestParams& parms)
               }
           }
       });
-  
+
+  // Gathering a constant field with the PQS kernel must return the constant.
+  MultiFab constMF(ba, dmap, BL_SPACEDIM, 2);
+  constMF.setVal(5.0);
+  amrex::MeshToParticle(myPC, constMF, 0,
+      [=] AMREX_GPU_DEVICE (MyParticleContainer::ParticleType& p,
+                            amrex::Array4<const amrex::Real> const& fld)
+      {
+          const auto a = amrex_gather_shape<3,BL_SPACEDIM>(p, fld, 0, plo, dxi);
+          for (int comp=0; comp < BL_SPACEDIM; ++comp) {
+              p.rdata(4+comp) = a[comp];
+          }
+      });
+  const Real gather_err = amrex::ReduceMax(myPC,
+      [=] AMREX_GPU_HOST_DEVICE (const MyParticleContainer::SuperParticleType& p) -> Real
+      {
+          return std::abs(p.rdata(4) - 5.0);
+      });
+  if (gather_err > 1.e-10) {
+      amrex::Abort("PQS gather of a constant field is not exact");
+  }
+
   WriteSingleLevelPlotfile("plot", partMF, 
                            {"density", "vx", "vy", "vz"},
                            geom, 0.0, 0);
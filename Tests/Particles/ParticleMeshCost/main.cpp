@@ -0,0 +1,121 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_AmrParticles.H>
+
+using namespace amrex;
+
+using PC = AmrParticleContainer<1>;
+
+Real totalCost (const LayoutData<Real>& cost)
+{
+    Real total = 0.0;
+    for (MFIter mfi(cost.boxArray(), cost.DistributionMap()); mfi.isValid(); ++mfi) {
+        total += cost[mfi];
+    }
+    ParallelDescriptor::ReduceRealSum(total);
+    return total;
+}
+
+Real maxRankCost (const PC& pc, const BoxArray& ba, const DistributionMapping& dm,
+                  const ParticleMeshCostModel& model)
+{
+    const LayoutData<Real> cost = pc.ParticleMeshCost(0, ba, dm, model);
+    Real rank_cost = 0.0;
+    for (MFIter mfi(ba, dm); mfi.isValid(); ++mfi) {
+        rank_cost += cost[mfi];
+    }
+    ParallelDescriptor::ReduceRealMax(rank_cost);
+    return rank_cost;
+}
+
+void testCost ()
+{
+    ParmParse pp("cost");
+    IntVect size;
+    pp.get("size", size);
+    int max_grid_size;
+    pp.get("max_grid_size", max_grid_size);
+    int nparticles;
+    pp.get("nparticles", nparticles);
+    ParticleMeshCostModel model;
+    pp.get("particle_weight", model.particle_weight);
+
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    const Box domain(IntVect::TheZeroVector(), size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc({geom}, {dm}, {ba}, {2});
+
+    // All the particles are in a corner of the domain.
+    const RealBox hot_spot(AMREX_D_DECL(0.0,0.0,0.0), AMREX_D_DECL(0.25,0.25,0.25));
+    PC::ParticleInitData pdata = {{1.0}, {}, {}, {}};
+    pc.InitRandom(nparticles, 451, pdata, false, hot_spot);
+
+    const Real expected = static_cast<Real>(ba.numPts())*model.mesh_weight
+        + static_cast<Real>(nparticles)*model.particle_weight;
+
+    const Real total = totalCost(pc.ParticleMeshCost(0, ba, dm, model));
+    if (std::abs(total - expected) > 1.e-10*expected) {
+        amrex::Abort("ParticleMeshCost: wrong total cost on the particle grids");
+    }
+
+    // A proposed fine level that does not exist yet is costed from level 0.
+    BoxArray fba = ba;
+    fba.refine(2);
+    fba.maxSize(max_grid_size);
+    DistributionMapping fdm(fba);
+    const Real fexpected = static_cast<Real>(fba.numPts())*model.mesh_weight
+        + static_cast<Real>(nparticles)*model.particle_weight;
+    const Real ftotal = totalCost(pc.ParticleMeshCost(1, fba, fdm, model));
+    if (std::abs(ftotal - fexpected) > 1.e-10*fexpected) {
+        amrex::Abort("ParticleMeshCost: wrong total cost on the proposed fine grids");
+    }
+
+    // No mapping can do better than the average cost per rank or the most
+    // expensive box.
+    Real lower_bound = total / ParallelDescriptor::NProcs();
+    {
+        const LayoutData<Real> cost = pc.ParticleMeshCost(0, ba, dm, model);
+        Real box_max = 0.0;
+        for (MFIter mfi(ba, dm); mfi.isValid(); ++mfi) {
+            box_max = std::max(box_max, cost[mfi]);
+        }
+        ParallelDescriptor::ReduceRealMax(box_max);
+        lower_bound = std::max(lower_bound, box_max);
+    }
+
+    // Balancing by the combined cost must come close to the lower bound.
+    // It is not compared with the default mapping, which may happen to be
+    // well balanced too.
+    for (auto strategy : {DistributionMapping::KNAPSACK, DistributionMapping::SFC})
+    {
+        model.strategy = strategy;
+        const DistributionMapping newdm = pc.MakeBalancedDistributionMap(0, ba, model);
+        const Real old_max = maxRankCost(pc, ba, dm, model);
+        const Real new_max = maxRankCost(pc, ba, newdm, model);
+        amrex::Print() << "Maximum cost per rank: " << old_max << " -> " << new_max
+                       << ", lower bound " << lower_bound << "\n";
+        if (new_max > 1.1*lower_bound) {
+            amrex::Abort("ParticleMeshCost: balanced mapping is far from the lower bound");
+        }
+    }
+
+    amrex::Print() << "ParticleMeshCost test passed\n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    testCost();
+    amrex::Finalize();
+}
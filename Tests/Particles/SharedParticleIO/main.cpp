@@ -0,0 +1,139 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+#include <AMReX_SharedParticleFile.H>
+
+using namespace amrex;
+
+using PC = ParticleContainer<1, 1>;
+
+struct KeepEveryThird
+{
+    AMREX_GPU_HOST_DEVICE
+    int operator() (const PC::SuperParticleType& p) const noexcept
+    {
+        return p.id() % 3 == 0;
+    }
+};
+
+bool inRegion (const RealBox& region, const Real* x)
+{
+    bool inside = true;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        inside = inside && region.lo(d) <= x[d] && x[d] < region.hi(d);
+    }
+    return inside;
+}
+
+void testSharedIO ()
+{
+    ParmParse pp("shared");
+    IntVect size;
+    pp.get("size", size);
+    int max_grid_size;
+    pp.get("max_grid_size", max_grid_size);
+    int nparticles;
+    pp.get("nparticles", nparticles);
+
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    const Box domain(IntVect::TheZeroVector(), size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+    PC::ParticleInitData pdata = {{0.0}, {0}, {}, {}};
+    pc.InitRandom(nparticles, 451, pdata, true);
+
+    for (PC::ParIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        auto& aos = pti.GetArrayOfStructs();
+        for (int k = 0; k < pti.numParticles(); ++k)
+        {
+            auto& p = aos[k];
+            p.rdata(0) = p.pos(0) + p.pos(AMREX_SPACEDIM-1);
+            p.idata(0) = static_cast<int>(p.id() % 7);
+        }
+    }
+
+    pc.WriteSharedPlotFile("shared", "particles", KeepEveryThird());
+
+    const RealBox region(AMREX_D_DECL(0.25, 0.25, 0.25), AMREX_D_DECL(0.5, 0.5, 0.5));
+
+    // The expected number of particles, in total and inside the region.
+    Long nexpected = 0;
+    Long nexpected_region = 0;
+    for (PC::ParIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        const auto& aos = pti.GetArrayOfStructs();
+        for (int k = 0; k < pti.numParticles(); ++k)
+        {
+            const auto& p = aos[k];
+            if (p.id() % 3 != 0) continue;
+            ++nexpected;
+            Real x[AMREX_SPACEDIM];
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) x[d] = p.pos(d);
+            if (inRegion(region, x)) ++nexpected_region;
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(nexpected);
+    ParallelDescriptor::ReduceLongSum(nexpected_region);
+
+    SharedParticleFile file("shared/particles");
+
+    if (file.numParticles() != nexpected) {
+        amrex::Abort("SharedParticleIO: wrong number of particles in the Header");
+    }
+    if (file.numReal() != AMREX_SPACEDIM+1 || file.numInt() != 3) {
+        amrex::Abort("SharedParticleIO: wrong number of components");
+    }
+
+    // Read everything back one chunk at a time.
+    Vector<double> rdata;
+    Vector<int> idata;
+    for (int i = 0; i < file.chunks().size(); ++i) {
+        file.readChunk(i, rdata, idata);
+    }
+    if (static_cast<Long>(idata.size()) != nexpected*file.numInt()) {
+        amrex::Abort("SharedParticleIO: wrong number of particles in DATA");
+    }
+
+    const double eps = 10.0*std::numeric_limits<ParticleReal>::epsilon();
+    for (Long k = 0; k < nexpected; ++k)
+    {
+        const double* pr = rdata.dataPtr() + k*file.numReal();
+        const int* pi = idata.dataPtr() + k*file.numInt();
+        if (pi[0] % 3 != 0 || pi[2] != pi[0] % 7) {
+            amrex::Abort("SharedParticleIO: wrong int data");
+        }
+        if (std::abs(pr[AMREX_SPACEDIM] - (pr[0] + pr[AMREX_SPACEDIM-1])) > eps) {
+            amrex::Abort("SharedParticleIO: wrong real data");
+        }
+    }
+
+    // Read only the region.
+    const Long nregion = file.readRegion(region, rdata, idata);
+    if (nregion != nexpected_region) {
+        amrex::Abort("SharedParticleIO: wrong number of particles in the region");
+    }
+    if (file.chunksIntersecting(region).size() >= file.chunks().size()) {
+        amrex::Abort("SharedParticleIO: the chunk index did not cull anything");
+    }
+
+    amrex::Print() << "SharedParticleIO test passed\n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    testSharedIO();
+    amrex::Finalize();
+}
@@ -273,8 +273,14 @@ AmrLevelAdv::advance (Real time,
     }
 
     // State with ghost cells
-    MultiFab Sborder(grids, dmap, NUM_STATE, NUM_GROW);
-    FillPatch(*this, Sborder, NUM_GROW, time, Phi_Type, 0, NUM_STATE);
+    MultiFab Sborder;
+    if (Sborder_fused) {
+        Sborder = std::move(*Sborder_fused);
+        Sborder_fused.reset();
+    } else {
+        Sborder.define(grids, dmap, NUM_STATE, NUM_GROW);
+        FillPatch(*this, Sborder, NUM_GROW, time, Phi_Type, 0, NUM_STATE);
+    }
 
     // MF to hold the mac velocity
     MultiFab Umac[BL_SPACEDIM];
@@ -721,7 +727,12 @@ AmrLevelAdv::reflux ()
 
     const Real strt = amrex::second();
 
-    getFluxReg(level+1).Reflux(get_new_data(Phi_Type),1.0,0,0,NUM_STATE,geom);
+    if (reflux_started) {
+        getFluxReg(level+1).Reflux_finish();
+        reflux_started = false;
+    } else {
+        getFluxReg(level+1).Reflux(get_new_data(Phi_Type),1.0,0,0,NUM_STATE,geom);
+    }
     
     if (verbose)
     {
@@ -735,6 +746,23 @@ AmrLevelAdv::reflux ()
     }
 }
 
+void
+AmrLevelAdv::pre_advance_fused (Real time, Real /*dt*/)
+{
+    Sborder_fused.reset(new MultiFab(grids, dmap, NUM_STATE, NUM_GROW));
+    FillPatch(*this, *Sborder_fused, NUM_GROW, time, Phi_Type, 0, NUM_STATE);
+}
+
+void
+AmrLevelAdv::reflux_nowait ()
+{
+    if (do_reflux && level < parent->finestLevel())
+    {
+        getFluxReg(level+1).Reflux_nowait(get_new_data(Phi_Type),1.0,0,0,NUM_STATE,geom);
+        reflux_started = true;
+    }
+}
+
 void
 AmrLevelAdv::avgDown ()
 {